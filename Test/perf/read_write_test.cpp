@@ -2,8 +2,10 @@
 
 #include <catch2/catch.hpp>
 #include "image/pixel/read_write.hpp"
+#include "image/pixel/typed.hpp"
 #include "image/process/conversion.hpp"
 #include <chrono>
+#include <vector>
 #include <iostream>
 
 TEST_CASE("Pixel Reader", "[benchmark Pixel Readers]")
@@ -42,6 +44,58 @@ TEST_CASE("Pixel Reader", "[benchmark Pixel Readers]")
         std::cout << std::chrono::duration_cast<std::chrono::microseconds>(dur).count()/100 << std::endl;
     }
 
+    SECTION("Benchmark Typed") {
+
+        using namespace std::chrono_literals;
+
+        auto t1 = std::chrono::steady_clock::now();
+        auto reader = utils::pixel::TypedReader<utils::pixel::RGBA8, std::uint8_t>{rgba_image};
+        auto writer = utils::pixel::TypedWriter<utils::pixel::RGBA8, std::uint8_t>{rgba_image};
+        auto [width, height] = reader.size();
+
+        for(auto i = 0; i < 100; i++) {    
+
+            for(auto y = 0u; y < height; y++) {
+                for(auto x = 0u; x < width; x++) {
+                    auto px = reader.at({x, y});
+                    px[0] = 0;
+                    writer.at(px, {x, y});
+                }
+            }
+        }
+        
+        auto t2 = std::chrono::steady_clock::now();
+        auto dur = t2 - t1;
+        std::cout << std::chrono::duration_cast<std::chrono::microseconds>(dur).count() << std::endl;
+        std::cout << std::chrono::duration_cast<std::chrono::microseconds>(dur).count()/100 << std::endl;
+    }
+
+    SECTION("Benchmark Rows") {
+
+        using namespace std::chrono_literals;
+
+        auto t1 = std::chrono::steady_clock::now();
+        auto reader = utils::pixel::ReaderRGBA<std::uint8_t>{rgba_image};
+        auto writer = utils::pixel::WriterRGBA<std::uint8_t>{rgba_image};
+        auto pixels = std::vector<utils::pixel::PixelRGBA<std::uint8_t>>(rgba_image.meta_data().size.width);
+
+        for(auto i = 0; i < 100; i++) {    
+
+            for(auto y = 0u; y < rgba_image.meta_data().size.height; y++) {
+                reader.read_row(y, pixels);
+                for(auto& px : pixels) {
+                    px.r = 0;
+                }
+                writer.write_row(y, pixels);
+            }
+        }
+        
+        auto t2 = std::chrono::steady_clock::now();
+        auto dur = t2 - t1;
+        std::cout << std::chrono::duration_cast<std::chrono::microseconds>(dur).count() << std::endl;
+        std::cout << std::chrono::duration_cast<std::chrono::microseconds>(dur).count()/100 << std::endl;
+    }
+
     SECTION("Benchmark 2") {
 
         using namespace std::chrono_literals;
@@ -0,0 +1,121 @@
+#include <catch2/catch.hpp>
+#include "image/image.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <utility>
+
+TEST_CASE("Aligned Buffer", "[buffer]")
+{
+    using namespace nitros;
+
+    auto address = [](const utils::AlignedBuffer  &buffer) {
+        return reinterpret_cast<std::uintptr_t>(buffer.data());
+    };
+
+    SECTION("Alignment")
+    {
+        auto small = utils::AlignedBuffer(100);
+        REQUIRE( small.size() == 100 );
+        REQUIRE( small.alignment() == 64 );
+        REQUIRE( address(small) % 64 == 0 );
+
+        auto large = utils::AlignedBuffer(1024 * 1024);
+        REQUIRE( large.alignment() >= 4096 );
+        REQUIRE( address(large) % large.alignment() == 0 );
+
+        auto options = utils::BufferOptions{};
+        options.alignment = 256;
+        auto custom = utils::AlignedBuffer(10, options);
+        REQUIRE( address(custom) % 256 == 0 );
+    }
+
+    SECTION("Zero Fill")
+    {
+        auto options = utils::BufferOptions{};
+        options.zero_fill = true;
+        auto buffer = utils::AlignedBuffer(333, options);
+        REQUIRE( std::all_of(buffer.begin(), buffer.end(), [](auto v) { return v == 0; }) );
+
+        buffer[0] = 9;
+        buffer.resize(5000);
+        REQUIRE( buffer[0] == 9 );
+        REQUIRE( std::all_of(buffer.begin() + 1, buffer.end(), [](auto v) { return v == 0; }) );
+
+        auto filled = utils::AlignedBuffer(17, std::uint8_t{7});
+        REQUIRE( std::all_of(filled.begin(), filled.end(), [](auto v) { return v == 7; }) );
+    }
+
+    SECTION("Copy Move")
+    {
+        auto buffer = utils::AlignedBuffer{1, 2, 3};
+        auto copy = buffer;
+        REQUIRE( copy == buffer );
+        REQUIRE( copy.data() != buffer.data() );
+
+        auto data = buffer.data();
+        auto moved = std::move(buffer);
+        REQUIRE( moved.data() == data );
+        REQUIRE( moved == copy );
+
+        copy[1] = 5;
+        REQUIRE( copy != moved );
+
+        moved.clear();
+        REQUIRE( moved.empty() );
+    }
+
+    SECTION("Adopt")
+    {
+        static auto freed = 0;
+        freed = 0;
+        auto deleter = [](void *ptr) { freed++; std::free(ptr); };
+
+        auto memory = static_cast<std::uint8_t*>(std::malloc(64));
+        std::memset(memory, 5, 64);
+        {
+            auto buffer = utils::AlignedBuffer::adopt(memory, 64, deleter);
+            REQUIRE( buffer.data() == memory );
+            REQUIRE( buffer.size() == 64 );
+            REQUIRE( address(buffer) % buffer.alignment() == 0 );
+
+            auto moved = std::move(buffer);
+            REQUIRE( freed == 0 );
+
+            //Growing moves the contents to an aligned allocation and frees the adopted memory
+            moved.resize(1000);
+            REQUIRE( freed == 1 );
+            REQUIRE( moved[63] == 5 );
+            REQUIRE( address(moved) % 64 == 0 );
+        }
+        REQUIRE( freed == 1 );
+
+        {
+            auto buffer = utils::AlignedBuffer::adopt(static_cast<std::uint8_t*>(std::malloc(16)), 16, deleter);
+        }
+        REQUIRE( freed == 2 );
+
+        //Spare capacity of the allocation is used before growing moves the contents
+        auto spare = static_cast<std::uint8_t*>(std::malloc(128));
+        {
+            auto buffer = utils::AlignedBuffer::adopt(spare, 100, 128, deleter);
+            REQUIRE( buffer.capacity() == 128 );
+            buffer.resize(128);
+            REQUIRE( buffer.data() == spare );
+            REQUIRE( freed == 2 );
+        }
+        REQUIRE( freed == 3 );
+    }
+
+    SECTION("Image")
+    {
+        auto options = utils::BufferOptions{};
+        options.zero_fill = true;
+        auto image = utils::image::create_cpu( {100, 200}, utils::pixel::YUV420p::value, options );
+        REQUIRE( image.buffer().size() == utils::image::buffer_size(image.meta_data()) );
+        REQUIRE( image.buffer().size() == 100 * 200 * 3 / 2 );
+        REQUIRE( address(image.buffer()) % 64 == 0 );
+        REQUIRE( image.buffer()[image.buffer().size() - 1] == 0 );
+    }
+}
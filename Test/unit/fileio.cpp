@@ -0,0 +1,580 @@
+#include <catch2/catch.hpp>
+#include "image/fileio.hpp"
+#include "image/process/converter.hpp"
+#include "test_images.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <exception>
+#include <filesystem>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+TEST_CASE("File IO", "[fileio]")
+{
+    using namespace nitros;
+
+    //PNG of 16 bit samples in one stored deflate block, stb_image_write only writes 8 bits
+    auto png_16 = [](utils::ImgSize  size, std::uint8_t  color_type, const std::vector<std::uint16_t>  &samples) {
+        auto put_u32 = [](std::vector<std::uint8_t>  &out, std::uint32_t  value) {
+            out.insert(out.end(), {static_cast<std::uint8_t>(value >> 24), static_cast<std::uint8_t>(value >> 16),
+                                   static_cast<std::uint8_t>(value >> 8),  static_cast<std::uint8_t>(value)});
+        };
+        auto put_chunk = [&](std::vector<std::uint8_t>  &out, const char  *type, const std::vector<std::uint8_t>  &data) {
+            put_u32(out, static_cast<std::uint32_t>(data.size()));
+            auto start = out.size();
+            out.insert(out.end(), type, type + 4);
+            out.insert(out.end(), data.begin(), data.end());
+            auto crc = 0xffffffffu;
+            for(auto i = start; i < out.size(); i++) {
+                crc ^= out[i];
+                for(auto bit = 0; bit < 8; bit++) {
+                    crc = crc & 1 ? 0xedb88320u ^ (crc >> 1) : crc >> 1;
+                }
+            }
+            put_u32(out, crc ^ 0xffffffffu);
+        };
+
+        auto row_samples = samples.size() / size.height;
+        auto scanlines = std::vector<std::uint8_t>{};
+        for(auto y = std::size_t{0}; y < size.height; y++) {
+            scanlines.push_back(0);
+            for(auto i = y * row_samples; i < (y + 1) * row_samples; i++) {
+                scanlines.insert(scanlines.end(), {static_cast<std::uint8_t>(samples[i] >> 8), static_cast<std::uint8_t>(samples[i])});
+            }
+        }
+
+        auto length = static_cast<std::uint16_t>(scanlines.size());
+        auto zlib = std::vector<std::uint8_t>{0x78, 0x01, 1, static_cast<std::uint8_t>(length), static_cast<std::uint8_t>(length >> 8),
+                                              static_cast<std::uint8_t>(~length), static_cast<std::uint8_t>(~length >> 8)};
+        zlib.insert(zlib.end(), scanlines.begin(), scanlines.end());
+        auto a = std::uint32_t{1};
+        auto b = std::uint32_t{0};
+        for(auto byte : scanlines) {
+            a = (a + byte) % 65521;
+            b = (b + a) % 65521;
+        }
+        put_u32(zlib, b << 16 | a);
+
+        auto header = std::vector<std::uint8_t>{};
+        put_u32(header, static_cast<std::uint32_t>(size.width));
+        put_u32(header, static_cast<std::uint32_t>(size.height));
+        header.insert(header.end(), {16, color_type, 0, 0, 0});
+
+        auto png = std::vector<std::uint8_t>{0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n'};
+        put_chunk(png, "IHDR", header);
+        put_chunk(png, "IDAT", zlib);
+        put_chunk(png, "IEND", {});
+        return png;
+    };
+
+    auto samples_16 = [](const utils::ImageCpu  &image) {
+        auto samples = std::vector<std::uint16_t>{};
+        auto row_samples = utils::plane_row_bytes(image.meta_data(), 0) / 2;
+        for(auto y = std::size_t{0}; y < image.meta_data().size.height; y++) {
+            auto row = reinterpret_cast<const std::uint16_t*>(utils::image::view(image).row(y));
+            samples.insert(samples.end(), row, row + row_samples);
+        }
+        return samples;
+    };
+
+    SECTION("Decode Scratch")
+    {
+        auto image = test::make_image({40, 30}, utils::pixel::RGB8::value);
+        auto png = utils::image::encode_png(utils::image::view(std::as_const(image)));
+        auto target = utils::image::create_cpu({40, 30}, utils::pixel::RGB8::value);
+
+        auto scratch = utils::image::DecodeScratch(1024 * 1024);
+        REQUIRE( scratch.max_bytes() == 1024 * 1024 );
+        REQUIRE( scratch.retained_bytes() == 0 );
+        utils::image::decode_image(png, utils::image::view(target), scratch);
+        REQUIRE( test::same_planes(utils::image::view(image), utils::image::view(target)) );
+
+        //The decoded pixels at least are kept, the next frame of the same size reuses them
+        auto retained = scratch.retained_bytes();
+        REQUIRE( retained >= 40 * 30 * 3 );
+        utils::image::decode_image(png, utils::image::view(target), scratch);
+        REQUIRE( scratch.retained_bytes() == retained );
+
+        scratch.release();
+        REQUIRE( scratch.retained_bytes() == 0 );
+        auto moved = std::move(scratch);
+        utils::image::decode_image(png, utils::image::view(target), moved);
+        REQUIRE( moved.retained_bytes() == retained );
+
+        //Nothing past max_bytes is kept
+        auto none = utils::image::DecodeScratch(0);
+        utils::image::decode_image(png, utils::image::view(target), none);
+        REQUIRE( none.retained_bytes() == 0 );
+        REQUIRE( test::same_planes(utils::image::view(image), utils::image::view(target)) );
+
+        //Decoded images own their memory, 64 byte aligned like any image buffer
+        auto decoded = utils::image::decode_image(png, utils::image::DecodeOptions{});
+        REQUIRE( decoded.buffer().alignment() >= 64 );
+        REQUIRE( reinterpret_cast<std::uintptr_t>(decoded.buffer().data()) % 64 == 0 );
+        REQUIRE( decoded.buffer().capacity() % 64 == 0 );
+        REQUIRE( test::same_planes(utils::image::view(image), utils::image::view(decoded)) );
+    }
+
+    SECTION("Decode Into")
+    {
+        auto image = test::make_image({16, 10}, utils::pixel::RGB8::value);
+        auto png = utils::image::encode_png(utils::image::view(std::as_const(image)));
+
+        //Into a region, the rest of the target is left alone
+        auto target = utils::image::create_cpu({32, 20}, utils::pixel::RGB8::value);
+        std::fill(target.buffer().begin(), target.buffer().end(), std::uint8_t{9});
+        auto region = utils::image::roi(utils::image::view(target), 8, 5, {16, 10});
+        utils::image::decode_image(png, region);
+        REQUIRE( test::same_planes(utils::image::view(image), region) );
+        REQUIRE( target.buffer()[0] == 9 );
+        REQUIRE( target.buffer()[target.buffer().size() - 1] == 9 );
+
+        //The format of the target is decoded to
+        auto bgra = utils::image::create_cpu({16, 10}, utils::pixel::BGRA8::value);
+        utils::image::decode_image(png, bgra);
+        REQUIRE( bgra.buffer()[0] == image.buffer()[2] );
+        REQUIRE( bgra.buffer()[2] == image.buffer()[0] );
+        REQUIRE( bgra.buffer()[3] == 255 );
+
+        auto path = test::temp_path("nitros_fileio_into.png");
+        utils::image::write_image_png(path, utils::image::view(std::as_const(image)));
+        auto scratch = utils::image::DecodeScratch();
+        auto from_file = utils::image::create_cpu({16, 10}, utils::pixel::RGB8::value);
+        utils::image::read_image(path, utils::image::view(from_file), scratch);
+        REQUIRE( test::same_planes(utils::image::view(image), utils::image::view(from_file)) );
+        std::filesystem::remove(path);
+
+        //Mismatches are rejected before decoding, the target keeps its pixels
+        auto wrong_size = utils::image::create_cpu({16, 11}, utils::pixel::RGB8::value);
+        std::fill(wrong_size.buffer().begin(), wrong_size.buffer().end(), std::uint8_t{9});
+        REQUIRE_THROWS_AS( utils::image::decode_image(png, wrong_size), std::invalid_argument );
+        REQUIRE_THROWS_AS( utils::image::decode_image(png, utils::image::view(wrong_size), scratch), std::invalid_argument );
+        REQUIRE( std::all_of(wrong_size.buffer().begin(), wrong_size.buffer().end(), [](auto v) { return v == 9; }) );
+
+        auto wrong_format = utils::image::create_cpu({16, 10}, utils::pixel::STENCIL8::value);
+        REQUIRE_THROWS_AS( utils::image::decode_image(png, wrong_format), std::invalid_argument );
+
+        auto garbage = std::vector<std::uint8_t>(64, 7);
+        REQUIRE_THROWS_AS( utils::image::decode_image(garbage, utils::image::view(from_file), scratch), std::runtime_error );
+    }
+
+    SECTION("Native Layout")
+    {
+        for(auto format : {utils::pixel::GREY8::value, utils::pixel::RGB8::value, utils::pixel::RGBA8::value})
+        {
+            auto image = test::make_image({21, 13}, format);
+            auto png = utils::image::encode_png(utils::image::view(std::as_const(image)));
+            auto decoded = utils::image::decode_image(png, utils::image::DecodeOptions{});
+            REQUIRE( decoded.meta_data() == image.meta_data() );
+            REQUIRE( test::same_planes(utils::image::view(image), utils::image::view(decoded)) );
+        }
+
+        //16 bit samples are kept instead of truncated
+        auto grey = std::vector<std::uint16_t>(4 * 3);
+        auto rgb = std::vector<std::uint16_t>(4 * 3 * 3);
+        for(auto i = std::size_t{0}; i < rgb.size(); i++) {
+            rgb[i] = static_cast<std::uint16_t>(i * 1821 + 17);
+            if(i < grey.size()) {
+                grey[i] = static_cast<std::uint16_t>(i * 5449 + 3);
+            }
+        }
+        auto grey_png = png_16({4, 3}, 0, grey);
+        auto rgb_png = png_16({4, 3}, 2, rgb);
+
+        auto grey_image = utils::image::decode_image(grey_png, utils::image::DecodeOptions{});
+        REQUIRE( grey_image.meta_data().format == utils::pixel::GREY16::value );
+        REQUIRE( samples_16(grey_image) == grey );
+        auto rgb_image = utils::image::decode_image(rgb_png, utils::image::DecodeOptions{});
+        REQUIRE( rgb_image.meta_data().format == utils::pixel::RGB16::value );
+        REQUIRE( samples_16(rgb_image) == rgb );
+
+        //An 8 bit format keeps the high byte
+        auto narrowed = utils::image::decode_image(rgb_png, utils::image::DecodeOptions{utils::pixel::RGB8::value});
+        REQUIRE( narrowed.meta_data().format == utils::pixel::RGB8::value );
+        REQUIRE( narrowed.buffer()[4] == rgb[4] >> 8 );
+
+        //The default overloads still decode to RGBA8
+        REQUIRE( utils::image::decode_image(grey_png).meta_data().format == utils::pixel::RGBA8::value );
+
+        //stb takes the length of memory as int, only the length is looked at before rejecting
+        auto huge = gsl::span<std::uint8_t>(grey_png.data(), std::size_t{1} << 31);
+        REQUIRE_THROWS_AS( utils::image::decode_image(huge, utils::image::DecodeOptions{}), std::length_error );
+        REQUIRE_THROWS_AS( utils::image::probe_image(huge), std::length_error );
+    }
+
+    SECTION("Format Conversion")
+    {
+        auto image = test::make_image({16, 10}, utils::pixel::RGB8::value);
+        auto png = utils::image::encode_png(utils::image::view(std::as_const(image)));
+
+        //BGR orders are swapped after decoding
+        auto bgr = utils::image::decode_image(png, utils::image::DecodeOptions{utils::pixel::BGR8::value});
+        REQUIRE( bgr.meta_data().format == utils::pixel::BGR8::value );
+        REQUIRE( bgr.buffer()[0] == image.buffer()[2] );
+        REQUIRE( bgr.buffer()[2] == image.buffer()[0] );
+
+        //Grey gets opaque alpha and replicated channels
+        auto grey = test::make_image({16, 10}, utils::pixel::GREY8::value);
+        auto grey_png = utils::image::encode_png(utils::image::view(std::as_const(grey)));
+        auto rgba = utils::image::decode_image(grey_png, utils::image::DecodeOptions{utils::pixel::RGBA8::value});
+        REQUIRE( rgba.meta_data().format == utils::pixel::RGBA8::value );
+        REQUIRE( rgba.buffer()[0] == grey.buffer()[0] );
+        REQUIRE( rgba.buffer()[2] == grey.buffer()[0] );
+        REQUIRE( rgba.buffer()[3] == 255 );
+
+        //Formats stb cannot produce are converted from the decoded RGB, like converting the source
+        auto yuv = utils::image::decode_image(png, utils::image::DecodeOptions{utils::pixel::YUV420p::value});
+        auto expected = utils::image::create_cpu({16, 10}, utils::pixel::YUV420p::value);
+        image::plan_conversion(utils::pixel::RGB8::value, utils::pixel::YUV420p::value)(utils::image::view(std::as_const(image)), utils::image::view(expected));
+        REQUIRE( yuv.meta_data() == expected.meta_data() );
+        REQUIRE( test::same_planes(utils::image::view(expected), utils::image::view(yuv)) );
+
+        REQUIRE_THROWS_AS( utils::image::decode_image(png, utils::image::DecodeOptions{utils::pixel::STENCIL8::value}), std::invalid_argument );
+    }
+
+    SECTION("Probe")
+    {
+        auto image = test::make_image({16, 10}, utils::pixel::RGB8::value);
+        auto png = utils::image::encode_png(utils::image::view(std::as_const(image)));
+        auto info = utils::image::probe_image(png);
+        REQUIRE( info.size == utils::ImgSize{16, 10} );
+        REQUIRE( info.channels == 3 );
+        REQUIRE( info.bit_depth == 8 );
+        REQUIRE( info.format == utils::pixel::RGB8::value );
+        REQUIRE( info.file_format == utils::image::FileFormat::png );
+
+        auto jpg = utils::image::encode_jpg(utils::image::view(std::as_const(image)));
+        REQUIRE( utils::image::probe_image(jpg).file_format == utils::image::FileFormat::jpg );
+        REQUIRE( utils::image::probe_image(jpg).size == utils::ImgSize{16, 10} );
+
+        auto grey_png = png_16({3, 2}, 0, std::vector<std::uint16_t>(6, 1000));
+        auto grey_info = utils::image::probe_image(grey_png);
+        REQUIRE( grey_info.channels == 1 );
+        REQUIRE( grey_info.bit_depth == 16 );
+        REQUIRE( grey_info.format == utils::pixel::GREY16::value );
+
+        auto path = test::temp_path("nitros_fileio_probe.png");
+        auto rgba = test::make_image({5, 7}, utils::pixel::RGBA8::value);
+        utils::image::write_image_png(path, utils::image::view(std::as_const(rgba)));
+        auto file_info = utils::image::probe_image(path);
+        REQUIRE( file_info.size == utils::ImgSize{5, 7} );
+        REQUIRE( file_info.format == utils::pixel::RGBA8::value );
+        std::filesystem::remove(path);
+
+        auto garbage = std::vector<std::uint8_t>(64, 7);
+        REQUIRE_THROWS_AS( utils::image::probe_image(garbage), std::runtime_error );
+        REQUIRE_THROWS_AS( utils::image::probe_image(path), std::runtime_error );
+    }
+
+    SECTION("Decode Limits")
+    {
+        auto image = test::make_image({16, 10}, utils::pixel::RGB8::value);
+        auto png = utils::image::encode_png(utils::image::view(std::as_const(image)));
+
+        auto options = utils::image::DecodeOptions{};
+        options.max_pixels = 16 * 10;
+        REQUIRE( utils::image::decode_image(png, options).meta_data().size == utils::ImgSize{16, 10} );
+        options.max_pixels--;
+        REQUIRE_THROWS_AS( utils::image::decode_image(png, options), std::length_error );
+
+        //Bytes are those stb decodes to, plus the converted image if the requested format differs
+        options = utils::image::DecodeOptions{};
+        options.max_bytes = utils::image::buffer_size(image.meta_data());
+        REQUIRE_NOTHROW( utils::image::decode_image(png, options) );
+        options.max_bytes--;
+        REQUIRE_THROWS_AS( utils::image::decode_image(png, options), std::length_error );
+        options.format = utils::pixel::GREY8::value;
+        REQUIRE_NOTHROW( utils::image::decode_image(png, options) );
+        options.max_bytes = utils::image::buffer_size(utils::ImageMetaData{{16, 10}, utils::pixel::GREY8::value}) - 1;
+        REQUIRE_THROWS_AS( utils::image::decode_image(png, options), std::length_error );
+
+        //Also when only a preview is asked for
+        options.scale_denominator = 8;
+        REQUIRE_THROWS_AS( utils::image::decode_image(png, options), std::length_error );
+
+        options = utils::image::DecodeOptions{utils::pixel::YUV420p::value};
+        options.max_bytes = utils::image::buffer_size(image.meta_data()) + utils::image::buffer_size(utils::ImageMetaData{{16, 10}, utils::pixel::YUV420p::value});
+        REQUIRE_NOTHROW( utils::image::decode_image(png, options) );
+        options.max_bytes--;
+        REQUIRE_THROWS_AS( utils::image::decode_image(png, options), std::length_error );
+
+        //Previews count the full resolution image they are reduced from
+        options = utils::image::DecodeOptions{};
+        options.scale_denominator = 2;
+        options.max_bytes = utils::image::buffer_size(image.meta_data()) + utils::image::buffer_size(utils::ImageMetaData{{8, 5}, utils::pixel::RGB8::value});
+        REQUIRE( utils::image::decode_image(png, options).meta_data().size == utils::ImgSize{8, 5} );
+        options.max_bytes--;
+        REQUIRE_THROWS_AS( utils::image::decode_image(png, options), std::length_error );
+    }
+
+    SECTION("Reduced Resolution")
+    {
+        auto image = test::make_image({37, 30}, utils::pixel::RGB8::value);
+        auto png = utils::image::encode_png(utils::image::view(std::as_const(image)));
+        auto source = utils::image::view(std::as_const(image));
+        auto decode_scaled = [&](std::uint32_t  scale_denominator, std::size_t  max_dimension) {
+            auto options = utils::image::DecodeOptions{};
+            options.scale_denominator = scale_denominator;
+            options.max_dimension = max_dimension;
+            return utils::image::decode_image(png, options);
+        };
+
+        //Sides are rounded up
+        REQUIRE( decode_scaled(1, 0).meta_data().size == utils::ImgSize{37, 30} );
+        REQUIRE( decode_scaled(4, 0).meta_data().size == utils::ImgSize{10, 8} );
+        REQUIRE( decode_scaled(8, 0).meta_data().size == utils::ImgSize{5, 4} );
+        REQUIRE_THROWS_AS( decode_scaled(3, 0), std::invalid_argument );
+
+        //The smallest reduction that fits, 8 if none does
+        REQUIRE( decode_scaled(1, 40).meta_data().size == utils::ImgSize{37, 30} );
+        REQUIRE( decode_scaled(1, 19).meta_data().size == utils::ImgSize{19, 15} );
+        REQUIRE( decode_scaled(1, 10).meta_data().size == utils::ImgSize{10, 8} );
+        REQUIRE( decode_scaled(1, 1).meta_data().size == utils::ImgSize{5, 4} );
+
+        //Blocks are averaged with rounding, partial ones on the right edge over the pixels they have
+        auto half = decode_scaled(2, 0);
+        REQUIRE( half.meta_data().size == utils::ImgSize{19, 15} );
+        auto block = source.row(0)[0] + source.row(0)[3] + source.row(1)[0] + source.row(1)[3];
+        REQUIRE( utils::image::view(half).row(0)[0] == (block + 2) / 4 );
+        auto edge = source.row(0)[36 * 3 + 1] + source.row(1)[36 * 3 + 1];
+        REQUIRE( utils::image::view(half).row(0)[18 * 3 + 1] == (edge + 1) / 2 );
+
+        //16 bit samples are averaged as such, requested formats apply to the preview
+        auto grey_png = png_16({4, 3}, 0, {1000, 3000, 0, 0, 2000, 4001, 0, 0, 65535, 65535, 7, 9});
+        auto options = utils::image::DecodeOptions{};
+        options.scale_denominator = 2;
+        auto grey = utils::image::decode_image(grey_png, options);
+        REQUIRE( grey.meta_data().format == utils::pixel::GREY16::value );
+        REQUIRE( grey.meta_data().size == utils::ImgSize{2, 2} );
+        REQUIRE( samples_16(grey) == std::vector<std::uint16_t>{2500, 0, 65535, 8} );
+
+        options = utils::image::DecodeOptions{utils::pixel::BGR8::value};
+        options.scale_denominator = 2;
+        auto bgr = utils::image::decode_image(png, options);
+        REQUIRE( bgr.meta_data().format == utils::pixel::BGR8::value );
+        REQUIRE( utils::image::view(bgr).row(0)[2] == utils::image::view(half).row(0)[0] );
+
+        //A scratch keeps the full resolution pixels for the next preview
+        auto scratch = utils::image::DecodeScratch{};
+        options = utils::image::DecodeOptions{};
+        options.scale_denominator = 2;
+        auto first = utils::image::decode_image(png, options, scratch);
+        REQUIRE( test::same_planes(utils::image::view(half), utils::image::view(first)) );
+        auto retained = scratch.retained_bytes();
+        REQUIRE( retained >= 37 * 30 * 3 );
+        auto second = utils::image::decode_image(png, options, scratch);
+        REQUIRE( test::same_planes(utils::image::view(half), utils::image::view(second)) );
+        REQUIRE( scratch.retained_bytes() == retained );
+    }
+
+    SECTION("Encode Options And Sinks")
+    {
+        auto image = test::make_image({64, 48}, utils::pixel::RGB8::value);
+        auto source = utils::image::view(std::as_const(image));
+        auto png = utils::image::encode_png(source);
+
+        //The sink gets the same bytes as the vector, in order
+        auto chunks = 0;
+        auto streamed = std::vector<std::uint8_t>{};
+        auto sink = [&](const std::uint8_t  *data, std::size_t  size) {
+            chunks++;
+            streamed.insert(streamed.end(), data, data + size);
+        };
+        utils::image::encode_png(source, sink);
+        REQUIRE( chunks >= 1 );
+        REQUIRE( streamed == png );
+        streamed.clear();
+        utils::image::encode_bmp(source, sink);
+        REQUIRE( streamed == utils::image::encode_bmp(source) );
+
+        //Regions are encoded through their row step
+        auto region = utils::image::roi(source, 3, 5, {20, 30});
+        auto region_png = utils::image::encode_png(region);
+        REQUIRE( test::same_planes(region, utils::image::view(utils::image::decode_image(region_png, utils::image::DecodeOptions{}))) );
+        auto region_jpg = utils::image::encode_jpg(region);
+        REQUIRE( utils::image::probe_image(region_jpg).size == utils::ImgSize{20, 30} );
+
+        //Compression level and filter change the stream but not the pixels, later default encodes are unaffected
+        auto flat = utils::image::create_cpu({64, 64}, utils::pixel::GREY8::value);
+        std::fill(flat.buffer().begin(), flat.buffer().end(), std::uint8_t{40});
+        auto options = utils::image::EncodeOptions{};
+        options.png_compression = 0;
+        auto stored = utils::image::encode_png(utils::image::view(std::as_const(flat)), options);
+        options.png_compression = 9;
+        auto compressed = utils::image::encode_png(utils::image::view(std::as_const(flat)), options);
+        REQUIRE( compressed.size() <= stored.size() );
+        REQUIRE( test::same_planes(utils::image::view(flat), utils::image::view(utils::image::decode_image(stored, utils::image::DecodeOptions{}))) );
+
+        for(auto filter : {utils::image::PngFilter::none, utils::image::PngFilter::sub, utils::image::PngFilter::paeth})
+        {
+            options = utils::image::EncodeOptions{};
+            options.png_filter = filter;
+            auto filtered = utils::image::encode_png(source, options);
+            REQUIRE( test::same_planes(source, utils::image::view(utils::image::decode_image(filtered, utils::image::DecodeOptions{}))) );
+        }
+        REQUIRE( utils::image::encode_png(source) == png );
+
+        //JPEG quality is clamped to 1 to 100
+        options = utils::image::EncodeOptions{};
+        options.jpg_quality = 10;
+        auto low = utils::image::encode_jpg(source, options);
+        REQUIRE( low.size() < utils::image::encode_jpg(source).size() );
+        options.jpg_quality = 1;
+        auto lowest = utils::image::encode_jpg(source, options);
+        options.jpg_quality = -5;
+        REQUIRE( utils::image::encode_jpg(source, options) == lowest );
+
+        auto path = test::temp_path("nitros_fileio_options.jpg");
+        options.jpg_quality = 80;
+        utils::image::write_image_jpg(path, source, options);
+        REQUIRE( utils::image::probe_image(path).file_format == utils::image::FileFormat::jpg );
+        std::filesystem::remove(path);
+
+        //Only 1 to 4 interleaved 8 bit channels
+        auto wide = utils::image::create_cpu({4, 4}, utils::pixel::GREY16::value);
+        auto planar = utils::image::create_cpu({4, 4}, utils::pixel::YUV420p::value);
+        REQUIRE_THROWS_AS( utils::image::encode_png(utils::image::view(std::as_const(wide))), std::invalid_argument );
+        REQUIRE_THROWS_AS( utils::image::encode_jpg(utils::image::view(std::as_const(planar)), sink), std::invalid_argument );
+        REQUIRE_THROWS_AS( utils::image::encode_bmp(utils::image::view(std::as_const(wide))), std::invalid_argument );
+    }
+
+    SECTION("Batches")
+    {
+        auto pool = image::ThreadPool(3);
+        auto images = std::vector<utils::ImageCpu>{};
+        auto views = std::vector<utils::ConstImageView>{};
+        auto encoded = std::vector<std::vector<std::uint8_t>>{};
+        for(auto i = std::uint32_t{0}; i < 5; i++) {
+            images.push_back(test::make_image({12 + i, 9}, utils::pixel::RGB8::value, i));
+        }
+        for(auto &image : images) {
+            views.push_back(utils::image::view(std::as_const(image)));
+            encoded.push_back(utils::image::encode_png(views.back()));
+        }
+        //Item 2 cannot be decoded, the others are not affected
+        encoded[2].assign(64, 7);
+        auto data = std::vector<gsl::span<std::uint8_t>>(encoded.begin(), encoded.end());
+
+        auto futures = utils::image::decode_images(data, pool);
+        REQUIRE( futures.size() == 5 );
+        for(auto i = std::size_t{0}; i < futures.size(); i++) {
+            if(i == 2) {
+                REQUIRE_THROWS_AS( futures[i].get(), std::runtime_error );
+                continue;
+            }
+            REQUIRE( test::same_planes(views[i], utils::image::view(futures[i].get())) );
+        }
+
+        auto mutex = std::mutex{};
+        auto sizes = std::vector<utils::ImgSize>(5);
+        auto errors = std::vector<std::exception_ptr>(5);
+        auto calls = 0;
+        auto consistent = true;
+        //Called on the workers, assertions are made on the test thread
+        auto record = [&](std::size_t  index, utils::ImageCpu  *image, std::exception_ptr  error) {
+            auto lock = std::lock_guard{mutex};
+            calls++;
+            consistent = consistent && (image == nullptr) == (error != nullptr);
+            if(image) {
+                sizes[index] = image->meta_data().size;
+            }
+            errors[index] = error;
+        };
+        utils::image::decode_images(data, pool, record, utils::image::DecodeOptions{}, 1).get();
+        REQUIRE( calls == 5 );
+        REQUIRE( consistent );
+        REQUIRE( sizes[4] == utils::ImgSize{16, 9} );
+        REQUIRE( errors[2] != nullptr );
+        REQUIRE_THROWS_AS( std::rethrow_exception(errors[2]), std::runtime_error );
+        REQUIRE( errors[0] == nullptr );
+
+        //Files are written and read back the same way, a missing file fails its own item
+        auto paths = std::vector<std::string>{};
+        for(auto i = 0; i < 5; i++) {
+            paths.push_back(test::temp_path("nitros_fileio_batch_" + std::to_string(i) + ".png"));
+        }
+        for(auto &written : utils::image::write_images(views, paths, utils::image::FileFormat::png, pool)) {
+            written.get();
+        }
+        std::filesystem::remove(paths[3]);
+        auto read = utils::image::read_images(paths, pool, utils::image::DecodeOptions{utils::pixel::BGR8::value});
+        REQUIRE( read[0].get().meta_data().format == utils::pixel::BGR8::value );
+        REQUIRE_THROWS_AS( read[3].get(), std::runtime_error );
+        REQUIRE( read[4].get().meta_data().size == utils::ImgSize{16, 9} );
+
+        calls = 0;
+        utils::image::read_images(paths, pool, record).get();
+        REQUIRE( calls == 5 );
+        REQUIRE( consistent );
+        REQUIRE( errors[3] != nullptr );
+        REQUIRE( errors[2] == nullptr );
+        REQUIRE( sizes[2] == utils::ImgSize{14, 9} );
+        for(auto &path : paths) {
+            std::filesystem::remove(path);
+        }
+
+        //Encoding fails per item too, an unsupported file format before anything is queued
+        auto wide = test::make_image({4, 4}, utils::pixel::GREY16::value);
+        views[1] = utils::image::view(std::as_const(wide));
+        auto qoi = utils::image::encode_images(views, utils::image::FileFormat::qoi, pool, utils::image::EncodeOptions{}, 2);
+        REQUIRE( utils::image::decode_qoi(qoi[0].get()).meta_data().size == utils::ImgSize{12, 9} );
+        REQUIRE_THROWS_AS( qoi[1].get(), std::invalid_argument );
+        REQUIRE( test::same_planes(views[4], utils::image::view(utils::image::decode_qoi(qoi[4].get()))) );
+
+        auto encoded_sizes = std::vector<std::size_t>(5);
+        auto encode_errors = std::vector<std::exception_ptr>(5);
+        utils::image::encode_images(views, utils::image::FileFormat::pnm, pool, [&](std::size_t  index, std::vector<std::uint8_t>  *bytes, std::exception_ptr  error) {
+            auto lock = std::lock_guard{mutex};
+            encoded_sizes[index] = bytes ? bytes->size() : 0;
+            encode_errors[index] = error;
+        }).get();
+        REQUIRE( encoded_sizes[0] > 12 * 9 * 3 );
+        REQUIRE( encode_errors[0] == nullptr );
+        REQUIRE( encoded_sizes[1] > 4 * 4 * 2 );    //PGM takes 16 bit grey
+
+        //QOI and Netpbm go to the decoders of this library, 16 bit PGM stays 16 bit
+        auto qoi_0 = utils::image::encode_qoi(views[0]);
+        auto pnm_1 = utils::image::encode_pnm(views[1]);
+        auto pnm_4 = utils::image::encode_pnm(views[4]);
+        auto own = std::vector<gsl::span<std::uint8_t>>{qoi_0, pnm_1, pnm_4};
+        auto own_images = std::vector<utils::ImageCpu>{};
+        for(auto &future : utils::image::decode_images(own, pool)) {
+            own_images.push_back(future.get());
+        }
+        REQUIRE( test::same_planes(views[0], utils::image::view(own_images[0])) );
+        REQUIRE( own_images[1].meta_data().format == utils::pixel::GREY16::value );
+        REQUIRE( test::same_planes(views[1], utils::image::view(own_images[1])) );
+        REQUIRE( test::same_planes(views[4], utils::image::view(own_images[2])) );
+
+        //Options apply to them like to any other item
+        auto own_options = utils::image::DecodeOptions{};
+        own_options.max_pixels = 12 * 9;
+        own_options.scale_denominator = 2;
+        auto own_scaled = utils::image::decode_images(own, pool, own_options);
+        REQUIRE( own_scaled[0].get().meta_data().size == utils::ImgSize{6, 5} );
+        REQUIRE( own_scaled[1].get().meta_data().size == utils::ImgSize{2, 2} );
+        REQUIRE_THROWS_AS( own_scaled[2].get(), std::length_error );
+        auto bgr = utils::image::decode_images(own, pool, utils::image::DecodeOptions{utils::pixel::BGR8::value});
+        auto bgr_0 = bgr[0].get();
+        REQUIRE( bgr_0.meta_data().format == utils::pixel::BGR8::value );
+        REQUIRE( utils::image::view(bgr_0).row(0)[2] == views[0].row(0)[0] );
+        auto rgba = utils::image::decode_images(own, pool, utils::image::DecodeOptions{utils::pixel::RGBA8::value});
+        REQUIRE( rgba[0].get().meta_data().format == utils::pixel::RGBA8::value );
+        //Netpbm channels are not converted while decoding, only formats a converter takes them to
+        REQUIRE_THROWS_AS( rgba[2].get(), std::invalid_argument );
+
+        //Paths are dispatched the same way
+        auto own_path = test::temp_path("nitros_fileio_batch.pgm");
+        utils::image::write_image_pnm(own_path, views[1]);
+        auto own_paths = std::vector<std::string>{own_path};
+        auto read_own = utils::image::read_images(own_paths, pool)[0].get();
+        REQUIRE( test::same_planes(views[1], utils::image::view(read_own)) );
+        std::filesystem::remove(own_path);
+
+        REQUIRE_THROWS_AS( utils::image::encode_images(views, utils::image::FileFormat::raw, pool), std::invalid_argument );
+        REQUIRE_THROWS_AS( utils::image::write_images(views, gsl::span<const std::string>(paths.data(), 4), utils::image::FileFormat::png, pool), std::invalid_argument );
+    }
+}
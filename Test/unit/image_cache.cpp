@@ -0,0 +1,169 @@
+#include <catch2/catch.hpp>
+#include "image/image_cache.hpp"
+#include "test_images.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST_CASE("Image Cache", "[cache]")
+{
+    using namespace nitros;
+
+    auto make_image = [](utils::ImgSize  size, std::uint8_t  value) {
+        auto image = utils::image::create_cpu(size, utils::pixel::GREY8::value);
+        for(auto &byte : image.buffer()) {
+            byte = value;
+        }
+        return image;
+    };
+
+    SECTION("LRU Eviction")
+    {
+        auto bytes = utils::image::create_cpu({16, 16}, utils::pixel::GREY8::value).buffer().size();
+        auto cache = utils::image::ImageCache(3 * bytes);
+        auto loads = 0;
+        auto load = [&](std::uint8_t  value) {
+            return [&loads, &make_image, value] { loads++; return make_image({16, 16}, value); };
+        };
+
+        auto a = cache.get("a", load(1));
+        REQUIRE( a->buffer()[0] == 1 );
+        cache.get("b", load(2));
+        cache.get("c", load(3));
+        REQUIRE( cache.get("a", load(9)) == a );
+        cache.get("d", load(4));
+
+        auto stats = cache.stats();
+        REQUIRE( loads == 4 );
+        REQUIRE( stats.hits == 1 );
+        REQUIRE( stats.misses == 4 );
+        REQUIRE( stats.evictions == 1 );
+        REQUIRE( stats.resident_images == 3 );
+        REQUIRE( stats.resident_bytes == 3 * bytes );
+
+        //b was least recently used
+        REQUIRE( cache.get("b", load(5))->buffer()[0] == 5 );
+        REQUIRE( cache.get("d", load(9))->buffer()[0] == 4 );
+        REQUIRE( loads == 5 );
+
+        //Handles outlive eviction
+        cache.set_max_bytes(0);
+        REQUIRE( cache.stats().resident_images == 0 );
+        REQUIRE( a->buffer()[0] == 1 );
+        cache.get("e", load(6));
+        REQUIRE( cache.stats().resident_bytes == 0 );
+
+        cache.set_max_bytes(3 * bytes);
+        cache.get("f", load(7));
+        cache.clear();
+        REQUIRE( cache.stats().resident_images == 0 );
+        REQUIRE( cache.get("f", load(8))->buffer()[0] == 8 );
+    }
+
+    SECTION("Oversized Images Are Not Kept")
+    {
+        auto bytes = utils::image::create_cpu({16, 16}, utils::pixel::GREY8::value).buffer().size();
+        auto cache = utils::image::ImageCache(3 * bytes);
+        cache.get("a", [&] { return make_image({16, 16}, 1); });
+        cache.get("b", [&] { return make_image({16, 16}, 2); });
+
+        //Returned without evicting the warm images
+        auto large = cache.get("large", [&] { return make_image({64, 64}, 3); });
+        REQUIRE( large->buffer()[0] == 3 );
+        auto stats = cache.stats();
+        REQUIRE( stats.evictions == 0 );
+        REQUIRE( stats.resident_images == 2 );
+        REQUIRE( stats.resident_bytes == 2 * bytes );
+
+        auto loads = 0;
+        cache.get("a", [&] { loads++; return make_image({16, 16}, 9); });
+        cache.get("large", [&] { loads++; return make_image({64, 64}, 4); });
+        REQUIRE( loads == 1 );
+        REQUIRE( cache.stats().resident_images == 2 );
+    }
+
+    SECTION("Single Flight")
+    {
+        auto cache = utils::image::ImageCache();
+        auto loads = std::atomic<int>{0};
+        auto threads = std::vector<std::thread>{};
+        auto handles = std::vector<utils::image::ImageCache::Handle>(8);
+        for(auto i = std::size_t{0}; i < handles.size(); i++) {
+            threads.emplace_back([&, i] {
+                handles[i] = cache.get("shared", [&] {
+                    loads++;
+                    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+                    return make_image({8, 8}, 42);
+                });
+            });
+        }
+        for(auto &thread : threads) {
+            thread.join();
+        }
+
+        REQUIRE( loads == 1 );
+        for(auto &handle : handles) {
+            REQUIRE( handle == handles[0] );
+        }
+        auto stats = cache.stats();
+        REQUIRE( stats.misses == 1 );
+        REQUIRE( stats.hits == 7 );
+        REQUIRE( stats.waits <= 7 );
+    }
+
+    SECTION("Failures Are Not Cached")
+    {
+        auto cache = utils::image::ImageCache();
+        auto fail = [] () -> utils::ImageCpu { throw std::runtime_error("broken"); };
+        REQUIRE_THROWS_AS( cache.get("x", fail), std::runtime_error );
+        REQUIRE( cache.get("x", [&] { return make_image({4, 4}, 3); })->buffer()[0] == 3 );
+        REQUIRE( cache.stats().misses == 2 );
+    }
+
+    SECTION("Files And Content")
+    {
+        auto path = test::temp_path("nitros_cache.pgm");
+        utils::image::write_image_pnm(path, utils::image::view(make_image({5, 3}, 17)));
+
+        auto cache = utils::image::ImageCache();
+        auto first = cache.read(path);
+        REQUIRE( first->meta_data().size == utils::ImgSize{5, 3} );
+        REQUIRE( cache.read(path) == first );
+
+        //A rewritten file is decoded again
+        utils::image::write_image_pnm(path, utils::image::view(make_image({5, 4}, 18)));
+        std::filesystem::last_write_time(path, std::filesystem::last_write_time(path) + std::chrono::seconds(1));
+        REQUIRE( cache.read(path)->meta_data().size == utils::ImgSize{5, 4} );
+
+        auto file = std::ifstream(path, std::ios::binary);
+        auto data = std::vector<std::uint8_t>(std::istreambuf_iterator<char>(file), {});
+        auto copy = data;
+        auto decoded = cache.decode(data);
+        REQUIRE( cache.decode(copy) == decoded );
+        copy.back() ^= 1;
+        REQUIRE( cache.decode(copy) != decoded );
+        REQUIRE( cache.stats().misses == 4 );
+
+        std::filesystem::remove(path);
+        REQUIRE_THROWS_AS( cache.read(path), std::runtime_error );
+    }
+
+    SECTION("Content Hash")
+    {
+        auto data = std::vector<std::uint8_t>(37, 5);
+        auto hash = utils::image::content_hash(data);
+        REQUIRE( utils::image::content_hash(data) == hash );
+        data[36] = 6;
+        REQUIRE( utils::image::content_hash(data) != hash );
+        data.pop_back();
+        data.pop_back();
+        REQUIRE( utils::image::content_hash(data) != utils::image::content_hash(gsl::span<const std::uint8_t>(data.data(), 34)) );
+    }
+}
@@ -0,0 +1,109 @@
+#include <catch2/catch.hpp>
+#include "image/image_pool.hpp"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+TEST_CASE("Image Pool", "[pool]")
+{
+    using namespace nitros;
+
+    auto pool = utils::ImagePool{};
+    auto frame_bytes = utils::image::buffer_size(utils::ImageMetaData{{64, 48}, utils::pixel::YUV420p::value});
+
+    SECTION("Recycle")
+    {
+        const std::uint8_t  *data = nullptr;
+        {
+            auto image = pool.acquire({64, 48}, utils::pixel::YUV420p::value);
+            REQUIRE( image->meta_data().size == utils::ImgSize{64, 48} );
+            REQUIRE( image->meta_data().format == utils::pixel::YUV420p::value );
+            REQUIRE( image->buffer().size() == frame_bytes );
+            data = image->buffer().data();
+        }
+        REQUIRE( pool.stats().retained_images == 1 );
+        REQUIRE( pool.stats().retained_bytes == frame_bytes );
+
+        for(auto frame = 0; frame < 5; frame++) {
+            auto image = pool.acquire({64, 48}, utils::pixel::YUV420p::value);
+            REQUIRE( image->buffer().data() == data );
+        }
+
+        //Other keys do not share images
+        auto other = pool.acquire({64, 48}, utils::pixel::RGBA8::value);
+        REQUIRE( other->buffer().data() != data );
+
+        auto stats = pool.stats();
+        REQUIRE( stats.hits == 5 );
+        REQUIRE( stats.misses == 2 );
+        REQUIRE( stats.dropped == 0 );
+    }
+
+    SECTION("Byte Cap")
+    {
+        pool.set_max_retained_bytes(frame_bytes);
+        {
+            auto first = pool.acquire({64, 48}, utils::pixel::YUV420p::value);
+            auto second = pool.acquire({64, 48}, utils::pixel::YUV420p::value);
+        }
+        REQUIRE( pool.stats().retained_images == 1 );
+        REQUIRE( pool.stats().dropped == 1 );
+
+        pool.set_max_retained_bytes(0);
+        REQUIRE( pool.stats().retained_images == 0 );
+        REQUIRE( pool.stats().retained_bytes == 0 );
+    }
+
+    SECTION("Reserve Clear")
+    {
+        pool.reserve({64, 48}, utils::pixel::YUV420p::value, 3);
+        REQUIRE( pool.stats().retained_images == 3 );
+
+        {
+            auto a = pool.acquire({64, 48}, utils::pixel::YUV420p::value);
+            auto b = pool.acquire({64, 48}, utils::pixel::YUV420p::value);
+            REQUIRE( pool.stats().hits == 2 );
+            REQUIRE( pool.stats().misses == 0 );
+            pool.clear();
+            REQUIRE( pool.stats().retained_images == 0 );
+        }
+        REQUIRE( pool.stats().retained_images == 2 );
+    }
+
+    SECTION("Outlives Pool")
+    {
+        auto image = pool.acquire({8, 8}, utils::pixel::RGB8::value);
+        {
+            auto local = utils::ImagePool{};
+            //The replaced image goes back to its own pool
+            image = local.acquire({8, 8}, utils::pixel::RGB8::value);
+            REQUIRE( pool.stats().retained_images == 1 );
+        }
+        image.reset();
+        REQUIRE( pool.stats().retained_images == 1 );
+    }
+
+    SECTION("Threads")
+    {
+        auto threads = std::vector<std::thread>{};
+        auto mismatches = std::atomic<int>{0};
+        for(auto t = 0; t < 4; t++) {
+            threads.emplace_back([&pool, &mismatches, frame_bytes]() {
+                for(auto frame = 0; frame < 200; frame++) {
+                    auto image = pool.acquire({64, 48}, utils::pixel::YUV420p::value);
+                    if(image->buffer().size() != frame_bytes) {
+                        mismatches++;
+                    }
+                }
+            });
+        }
+        for(auto &thread : threads) {
+            thread.join();
+        }
+        auto stats = pool.stats();
+        REQUIRE( mismatches == 0 );
+        REQUIRE( stats.hits + stats.misses == 800 );
+        REQUIRE( stats.misses <= 4 );
+        REQUIRE( stats.retained_images == stats.misses );
+    }
+}
@@ -3,6 +3,11 @@
 #include <catch2/catch.hpp>
 #include "image/image.hpp"
 #include "image/process/conversion.hpp"
+#include "image/process/converter.hpp"
+#include "image/utils.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <memory>
 
 TEST_CASE("Row Alignment", "[image align]")
 {
@@ -73,4 +78,342 @@ TEST_CASE("Image Flip Y", "[image flip]")
     REQUIRE(st2[0] == st[2]);
     REQUIRE(st2[1] == st[1]);
     REQUIRE(st2[2] == st[0]);
-}
\ No newline at end of file
+}
+
+TEST_CASE("Image Flip Y Planar", "[image flip]")
+{
+    using namespace nitros;
+
+    auto yuv_image = utils::image::create_cpu( {6, 7}, utils::pixel::YUV420p::value );
+    for(auto i = 0u; i < yuv_image.buffer().size(); i++) {
+        yuv_image.buffer().data()[i] = static_cast<std::uint8_t>(i);
+    }
+
+    auto check = [&yuv_image](const utils::ImageCpu  &flipped) {
+        auto &meta = yuv_image.meta_data();
+        for(auto p = 0u; p < 3; p++) {
+            auto [width, height] = utils::interpreted_plane_img_size(meta, p);
+            for(auto y = 0u; y < height; y++) {
+                auto src = utils::plane_start_address(yuv_image, p) + y * meta.steps[p];
+                auto dst = utils::plane_start_address(flipped, p) + (height - 1 - y) * meta.steps[p];
+                REQUIRE( std::equal(src, src + width, dst) );
+            }
+        }
+    };
+
+    auto flipped = utils::image::create_cpu( {6, 7}, utils::pixel::YUV420p::value );
+    REQUIRE( image::flip_y(yuv_image, flipped) );
+    check(flipped);
+
+    auto pool = image::ThreadPool{3};
+    auto flipped_mt = utils::image::create_cpu( {6, 7}, utils::pixel::YUV420p::value );
+    REQUIRE( image::flip_y(yuv_image, flipped_mt, pool) );
+    check(flipped_mt);
+}
+
+TEST_CASE("Color Convert RGB to YUV444", "[conversion]")
+{
+    using namespace nitros;
+
+    //Width not a multiple of the vector width, so the scalar tail is covered
+    auto rgba_image = utils::image::create_cpu( {37, 3}, utils::pixel::RGBA8::value );
+    auto rgb_image  = utils::image::create_cpu( {37, 3}, utils::pixel::RGB8::value );
+    for(auto i = 0u; i < rgba_image.buffer().size(); i++) {
+        rgba_image.buffer().data()[i] = static_cast<std::uint8_t>(i * 53 + (i >> 3));
+    }
+    for(auto i = 0u; i < rgb_image.buffer().size(); i++) {
+        rgb_image.buffer().data()[i] = static_cast<std::uint8_t>(i * 29 + 7);
+    }
+
+    auto reference = [](int r, int g, int b) {
+        return std::array<int, 3>{
+            (77 * r + 150 * g + 29 * b + 128) >> 8,
+            ((-43 * r - 84 * g + 127 * b + 128) >> 8) + 128,
+            ((127 * r - 106 * g - 21 * b + 128) >> 8) + 128
+        };
+    };
+
+    auto check = [&reference](const utils::ImageCpu  &src, std::size_t  channels) {
+        auto yuv_image = utils::image::create_cpu( src.meta_data().size, utils::pixel::YUV444p::value );
+        REQUIRE( image::color_convert(src, yuv_image) );
+
+        auto [width, height] = src.meta_data().size;
+        auto plane_size = yuv_image.meta_data().steps[0] * height;
+        for(auto y = 0u; y < height; y++) {
+            for(auto x = 0u; x < width; x++) {
+                auto px = src.buffer().data() + y * src.meta_data().steps[0] + x * channels;
+                auto yuv = reference(px[0], px[1], px[2]);
+                auto offset = y * yuv_image.meta_data().steps[0] + x;
+                REQUIRE( yuv_image.buffer().data()[offset] == yuv[0] );
+                REQUIRE( yuv_image.buffer().data()[plane_size + offset] == yuv[1] );
+                REQUIRE( yuv_image.buffer().data()[2 * plane_size + offset] == yuv[2] );
+            }
+        }
+    };
+
+    check(rgba_image, 4);
+    check(rgb_image, 3);
+}
+
+TEST_CASE("Color Convert YUV444 to RGB", "[conversion]")
+{
+    using namespace nitros;
+
+    auto yuv_image = utils::image::create_cpu( {37, 3}, utils::pixel::YUV444p::value );
+    for(auto i = 0u; i < yuv_image.buffer().size(); i++) {
+        yuv_image.buffer().data()[i] = static_cast<std::uint8_t>(i * 41 + (i >> 2));
+    }
+
+    auto reference = [](int y, int u, int v) {
+        auto mul = [](int d, int coef) { return (d * 64 * coef + (1 << 14)) >> 15; };
+        u -= 128;
+        v -= 128;
+        return std::array<int, 3>{
+            std::clamp(y + mul(v, 702), 0, 255),
+            std::clamp(y - mul(v, 357) - mul(u, 173), 0, 255),
+            std::clamp(y + mul(u, 887), 0, 255)
+        };
+    };
+
+    auto check = [&](const utils::pixel::Format  &format, std::size_t  channels, bool  bgr) {
+        auto rgb_image = utils::image::create_cpu( yuv_image.meta_data().size, format );
+        REQUIRE( image::color_convert(yuv_image, rgb_image) );
+
+        auto [width, height] = yuv_image.meta_data().size;
+        auto plane_size = yuv_image.meta_data().steps[0] * height;
+        for(auto y = 0u; y < height; y++) {
+            for(auto x = 0u; x < width; x++) {
+                auto offset = y * yuv_image.meta_data().steps[0] + x;
+                auto rgb = reference(yuv_image.buffer().data()[offset],
+                                     yuv_image.buffer().data()[plane_size + offset],
+                                     yuv_image.buffer().data()[2 * plane_size + offset]);
+                if(bgr) {
+                    std::swap(rgb[0], rgb[2]);
+                }
+
+                auto px = rgb_image.buffer().data() + y * rgb_image.meta_data().steps[0] + x * channels;
+                REQUIRE( px[0] == rgb[0] );
+                REQUIRE( px[1] == rgb[1] );
+                REQUIRE( px[2] == rgb[2] );
+                if(channels == 4) {
+                    REQUIRE( px[3] == 0xff );
+                }
+            }
+        }
+    };
+
+    check(utils::pixel::RGBA8::value, 4, false);
+    check(utils::pixel::BGRA8::value, 4, true);
+    check(utils::pixel::RGB8::value,  3, false);
+    check(utils::pixel::BGR8::value,  3, true);
+}
+
+TEST_CASE("Color Convert Subsampled YUV", "[conversion]")
+{
+    using namespace nitros;
+
+    auto to_yuv = [](int r, int g, int b) {
+        return std::array<int, 3>{
+            (77 * r + 150 * g + 29 * b + 128) >> 8,
+            ((-43 * r - 84 * g + 127 * b + 128) >> 8) + 128,
+            ((127 * r - 106 * g - 21 * b + 128) >> 8) + 128
+        };
+    };
+
+    SECTION("RGB to YUV")
+    {
+        for(auto format : { utils::pixel::YUV420p::value, utils::pixel::YUV422p::value })
+        {
+            auto v_sub = format == utils::pixel::YUV420p::value ? 2u : 1u;
+
+            //Odd sizes leave a trailing column and row without own chroma samples
+            auto rgb_image = utils::image::create_cpu( {69, 5}, utils::pixel::RGBA8::value );
+            for(auto i = 0u; i < rgb_image.buffer().size(); i++) {
+                rgb_image.buffer().data()[i] = static_cast<std::uint8_t>(i * 53 + (i >> 3));
+            }
+
+            auto yuv_image = utils::image::create_cpu( rgb_image.meta_data().size, format );
+            REQUIRE( image::color_convert(rgb_image, yuv_image) );
+
+            auto &src_meta = rgb_image.meta_data();
+            auto &dst_meta = yuv_image.meta_data();
+            auto yuv_at = [&](std::uint32_t x, std::uint32_t y) {
+                auto px = rgb_image.buffer().data() + y * src_meta.steps[0] + x * 4;
+                return to_yuv(px[0], px[1], px[2]);
+            };
+
+            for(auto y = 0u; y < dst_meta.size.height; y++) {
+                for(auto x = 0u; x < dst_meta.size.width; x++) {
+                    REQUIRE( utils::plane_start_address(yuv_image, 0)[y * dst_meta.steps[0] + x] == yuv_at(x, y)[0] );
+                }
+            }
+
+            auto [c_width, c_height] = utils::interpreted_plane_img_size(dst_meta, 1);
+            for(auto cy = 0u; cy < c_height; cy++) {
+                for(auto cx = 0u; cx < c_width; cx++) {
+                    for(auto c = 1u; c < 3; c++) {
+                        auto y0 = cy * v_sub, y1 = cy * v_sub + v_sub - 1;
+                        auto sum = yuv_at(2 * cx, y0)[c] + yuv_at(2 * cx + 1, y0)[c] + yuv_at(2 * cx, y1)[c] + yuv_at(2 * cx + 1, y1)[c];
+                        REQUIRE( utils::plane_start_address(yuv_image, c)[cy * dst_meta.steps[c] + cx] == (sum + 2) >> 2 );
+                    }
+                }
+            }
+        }
+    }
+
+    SECTION("YUV to RGB")
+    {
+        for(auto format : { utils::pixel::YUV420p::value, utils::pixel::YUV422p::value })
+        {
+            auto v_sub = format == utils::pixel::YUV420p::value ? 2u : 1u;
+
+            auto yuv_image = utils::image::create_cpu( {69, 5}, format );
+            for(auto i = 0u; i < yuv_image.buffer().size(); i++) {
+                yuv_image.buffer().data()[i] = static_cast<std::uint8_t>(i * 41 + (i >> 2));
+            }
+
+            auto rgb_image = utils::image::create_cpu( yuv_image.meta_data().size, utils::pixel::RGB8::value );
+            REQUIRE( image::color_convert(yuv_image, rgb_image) );
+
+            auto &src_meta = yuv_image.meta_data();
+            auto [c_width, c_height] = utils::interpreted_plane_img_size(src_meta, 1);
+            auto chroma = [&](std::size_t plane, int cx, int cy) -> int {
+                cx = std::clamp(cx, 0, int(c_width) - 1);
+                cy = std::clamp(cy, 0, int(c_height) - 1);
+                return utils::plane_start_address(yuv_image, plane)[cy * src_meta.steps[plane] + cx];
+            };
+            //Triangle filter, chroma sample i sits between luma pixels 2i and 2i + 1
+            auto upsampled = [&](std::size_t plane, int x, int y) {
+                auto cx = x / 2, cy = int(y / v_sub);
+                auto nx = cx >= int(c_width) ? cx : (x % 2 == 0 ? cx - 1 : cx + 1);
+                auto ny = (v_sub == 1 || cy >= int(c_height)) ? cy : (y % 2 == 0 ? cy - 1 : cy + 1);
+                return (9 * chroma(plane, cx, cy) + 3 * chroma(plane, nx, cy) + 3 * chroma(plane, cx, ny) + chroma(plane, nx, ny) + 8) >> 4;
+            };
+            auto mul = [](int d, int coef) { return (d * 64 * coef + (1 << 14)) >> 15; };
+
+            for(auto y = 0; y < int(src_meta.size.height); y++) {
+                for(auto x = 0; x < int(src_meta.size.width); x++) {
+                    auto luma = int(utils::plane_start_address(yuv_image, 0)[y * src_meta.steps[0] + x]);
+                    auto u = upsampled(1, x, y) - 128;
+                    auto v = upsampled(2, x, y) - 128;
+
+                    auto px = rgb_image.buffer().data() + y * rgb_image.meta_data().steps[0] + x * 3;
+                    REQUIRE( px[0] == std::clamp(luma + mul(v, 702), 0, 255) );
+                    REQUIRE( px[1] == std::clamp(luma - mul(v, 357) - mul(u, 173), 0, 255) );
+                    REQUIRE( px[2] == std::clamp(luma + mul(u, 887), 0, 255) );
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE("Color Convert Thread Pool", "[conversion] [thread]")
+{
+    using namespace nitros;
+
+    auto pool = image::ThreadPool{4};
+    //Odd widths leave step padding the converters never write
+    auto options = utils::BufferOptions{};
+    options.zero_fill = true;
+    auto convert = [&pool, &options](const utils::ImageCpu  &src, const utils::pixel::Format  &format) {
+        auto single = utils::image::create_cpu( src.meta_data().size, format, options );
+        auto banded = utils::image::create_cpu( src.meta_data().size, format, options );
+        REQUIRE( image::color_convert(src, single) );
+        REQUIRE( image::color_convert(src, banded, pool) );
+        REQUIRE( single.buffer() == banded.buffer() );
+        return banded;
+    };
+
+    //Odd height so the last band ends on a row without own chroma samples
+    auto rgba_image = utils::image::create_cpu( {45, 37}, utils::pixel::RGBA8::value );
+    for(auto i = 0u; i < rgba_image.buffer().size(); i++) {
+        rgba_image.buffer().data()[i] = static_cast<std::uint8_t>(i * 53 + (i >> 3));
+    }
+    auto rgb16_image = utils::image::create_cpu( {45, 37}, utils::pixel::RGB16::value );
+    for(auto i = 0u; i < rgb16_image.buffer().size(); i++) {
+        rgb16_image.buffer().data()[i] = static_cast<std::uint8_t>(i * 29 + 7);
+    }
+
+    for(auto format : { utils::pixel::YUV444p::value, utils::pixel::YUV422p::value, utils::pixel::YUV420p::value })
+    {
+        auto yuv_image = convert(rgba_image, format);
+        convert(yuv_image, utils::pixel::RGBA8::value);
+        convert(yuv_image, utils::pixel::BGR8::value);
+        //Generic Reader/Writer path
+        convert(rgb16_image, format);
+    }
+}
+
+TEST_CASE("Conversion Registry", "[conversion] [registry]")
+{
+    using namespace nitros;
+
+    REQUIRE( image::has_fast_path(utils::pixel::RGBA8::value, utils::pixel::YUV420p::value) );
+    REQUIRE( image::has_fast_path(utils::pixel::YUV422p::value, utils::pixel::BGR8::value) );
+    REQUIRE_FALSE( image::has_fast_path(utils::pixel::RGB16::value, utils::pixel::YUV420p::value) );
+    REQUIRE( image::fast_conversions().size() >= 18 );
+
+    SECTION("Plan")
+    {
+        auto plan = image::plan_conversion(utils::pixel::RGBA8::value, utils::pixel::YUV420p::value);
+        REQUIRE( plan );
+        REQUIRE( plan.is_fast() );
+        REQUIRE( plan.row_alignment() == 2 );
+
+        auto generic = image::plan_conversion(utils::pixel::RGB16::value, utils::pixel::YUV444p::value);
+        REQUIRE( generic );
+        REQUIRE_FALSE( generic.is_fast() );
+
+        auto none = image::plan_conversion(utils::pixel::RGBA8::value, utils::pixel::RGB8::value);
+        REQUIRE_FALSE( none );
+
+        //Plans are reusable across frames and give the same result as color_convert
+        auto rgba_image = utils::image::create_cpu( {20, 6}, utils::pixel::RGBA8::value );
+        auto planned    = utils::image::create_cpu( {20, 6}, utils::pixel::YUV420p::value );
+        auto converted  = utils::image::create_cpu( {20, 6}, utils::pixel::YUV420p::value );
+        for(auto frame = 0u; frame < 3; frame++)
+        {
+            for(auto i = 0u; i < rgba_image.buffer().size(); i++) {
+                rgba_image.buffer().data()[i] = static_cast<std::uint8_t>(i * 7 + frame);
+            }
+            REQUIRE( plan(rgba_image, planned) );
+            REQUIRE( image::color_convert(rgba_image, converted) );
+            REQUIRE( planned.buffer() == converted.buffer() );
+        }
+        REQUIRE_FALSE( none(rgba_image, converted) );
+    }
+
+    SECTION("Register")
+    {
+        //Registrations are process wide and outlive the test, so the pair is one no other test converts
+        //and the counter is owned by the converter instead of referenced on the stack
+        auto rows = std::make_shared<std::size_t>(0);
+        image::register_converter(utils::pixel::BGRA16::value, utils::pixel::BGR16::value,
+            [rows](const utils::ConstImageView  &src, const utils::ImageView  &dest, std::size_t  first, std::size_t  last) {
+                for(auto y = first; y < last; y++) {
+                    auto src_row = reinterpret_cast<const std::uint16_t*>(src.row(y));
+                    auto dst_row = reinterpret_cast<std::uint16_t*>(dest.row(y));
+                    for(auto x = 0u; x < src.meta_data().size.width; x++) {
+                        dst_row[3 * x]     = src_row[4 * x];
+                        dst_row[3 * x + 1] = src_row[4 * x + 1];
+                        dst_row[3 * x + 2] = src_row[4 * x + 2];
+                    }
+                }
+                *rows += last - first;
+            });
+
+        REQUIRE( image::has_fast_path(utils::pixel::BGRA16::value, utils::pixel::BGR16::value) );
+
+        auto bgra_image = utils::image::create_cpu( {3, 4}, utils::pixel::BGRA16::value );
+        auto bgr_image  = utils::image::create_cpu( {3, 4}, utils::pixel::BGR16::value );
+        auto samples = reinterpret_cast<std::uint16_t*>(bgra_image.buffer().data());
+        samples[0] = 1000;
+        samples[3] = 7;
+        samples[4] = 2000;
+        REQUIRE( image::color_convert(bgra_image, bgr_image) );
+        REQUIRE( *rows == 4 );
+        auto converted = reinterpret_cast<const std::uint16_t*>(bgr_image.buffer().data());
+        REQUIRE( converted[0] == 1000 );
+        REQUIRE( converted[3] == 2000 );
+    }
+}
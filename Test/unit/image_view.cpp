@@ -0,0 +1,124 @@
+#include <catch2/catch.hpp>
+#include "image/image_view.hpp"
+#include "image/pixel/read_write.hpp"
+#include "image/pixel/typed.hpp"
+#include "image/process/conversion.hpp"
+#include <stdexcept>
+#include <vector>
+
+TEST_CASE("Image View", "[view]")
+{
+    using namespace nitros;
+
+    auto rgba_image = utils::image::create_cpu( {24, 12}, utils::pixel::RGBA8::value );
+    for(auto i = 0u; i < rgba_image.buffer().size(); i++) {
+        rgba_image.buffer()[i] = static_cast<std::uint8_t>(i * 31 + (i >> 5));
+    }
+
+    SECTION("Whole Image")
+    {
+        auto yuv_image = utils::image::create_cpu( {24, 12}, utils::pixel::YUV420p::value );
+        auto view = utils::image::view(yuv_image);
+        REQUIRE( view.size() == yuv_image.meta_data().size );
+        for(auto p = 0u; p < 3; p++) {
+            REQUIRE( view.plane(p) == utils::plane_start_address(yuv_image, p) );
+        }
+        REQUIRE( view.row(3, 1) == view.plane(1) + 3 * yuv_image.meta_data().steps[1] );
+
+        auto const_view = utils::ConstImageView{view};
+        REQUIRE( const_view.plane(2) == view.plane(2) );
+    }
+
+    SECTION("Roi Offsets")
+    {
+        REQUIRE( utils::image::roi_alignment(utils::pixel::RGBA8::value) == utils::ImgSize{1, 1} );
+        REQUIRE( utils::image::roi_alignment(utils::pixel::YUV420p::value) == utils::ImgSize{2, 2} );
+        REQUIRE( utils::image::roi_alignment(utils::pixel::YUV422p::value) == utils::ImgSize{2, 1} );
+
+        auto rgba_roi = utils::image::roi(utils::image::view(rgba_image), 5, 3, {8, 4});
+        REQUIRE( rgba_roi.size() == utils::ImgSize{8, 4} );
+        REQUIRE( rgba_roi.plane(0) == rgba_image.buffer().data() + 3 * rgba_image.meta_data().steps[0] + 5 * 4 );
+
+        auto yuv_image = utils::image::create_cpu( {24, 12}, utils::pixel::YUV420p::value );
+        auto yuv_roi = utils::image::roi(utils::image::view(yuv_image), 4, 6, {10, 6});
+        auto &meta = yuv_image.meta_data();
+        REQUIRE( yuv_roi.plane(0) == utils::plane_start_address(yuv_image, 0) + 6 * meta.steps[0] + 4 );
+        REQUIRE( yuv_roi.plane(1) == utils::plane_start_address(yuv_image, 1) + 3 * meta.steps[1] + 2 );
+        REQUIRE( yuv_roi.plane(2) == utils::plane_start_address(yuv_image, 2) + 3 * meta.steps[2] + 2 );
+
+        //Nested regions add up
+        auto nested = utils::image::roi(yuv_roi, 2, 2, {4, 2});
+        REQUIRE( nested.plane(1) == utils::plane_start_address(yuv_image, 1) + 4 * meta.steps[1] + 3 );
+
+        REQUIRE_THROWS_AS( utils::image::roi(utils::image::view(yuv_image), 3, 2, {4, 4}), std::invalid_argument );
+        REQUIRE_THROWS_AS( utils::image::roi(utils::image::view(yuv_image), 20, 2, {6, 4}), std::invalid_argument );
+    }
+
+    SECTION("Reader Writer")
+    {
+        auto roi = utils::image::roi(utils::ConstImageView{rgba_image}, 3, 2, {7, 5});
+        auto reader = utils::pixel::ReaderRGBA<std::uint8_t>{roi};
+        auto whole  = utils::pixel::ReaderRGBA<std::uint8_t>{rgba_image};
+        auto typed  = utils::pixel::TypedReader<utils::pixel::RGBA8, std::uint8_t>{roi};
+
+        auto row = std::vector<utils::pixel::PixelRGBA<std::uint8_t>>(7);
+        reader.read_row(4, row);
+        for(auto x = 0u; x < 7; x++) {
+            REQUIRE( row[x].g == whole.at({x + 3, 6}).g );
+            REQUIRE( typed.at({x, 4})[1] == row[x].g );
+        }
+
+        auto copy = utils::image::create_cpu( {24, 12}, utils::pixel::RGBA8::value, {.zero_fill = true} );
+        auto writer = utils::pixel::WriterRGBA<std::uint8_t>{utils::image::roi(utils::image::view(copy), 3, 2, {7, 5})};
+        writer.write_row(4, row);
+        REQUIRE( utils::pixel::ReaderRGBA<std::uint8_t>{copy}.at({9, 6}).g == row[6].g );
+        REQUIRE( copy.buffer()[6 * copy.meta_data().steps[0] + 10 * 4] == 0 );
+    }
+
+    SECTION("Color Convert Tiles")
+    {
+        //Chroma of a region on even coordinates only depends on the region pixels
+        auto whole = utils::image::create_cpu( {24, 12}, utils::pixel::YUV420p::value );
+        REQUIRE( image::color_convert(rgba_image, whole) );
+
+        auto tiled = utils::image::create_cpu( {24, 12}, utils::pixel::YUV420p::value );
+        auto pool = image::ThreadPool{2};
+        for(auto ty = 0u; ty < 12; ty += 6) {
+            for(auto tx = 0u; tx < 24; tx += 8) {
+                auto src_tile = utils::image::roi(utils::ConstImageView{rgba_image}, tx, ty, {8, 6});
+                auto dst_tile = utils::image::roi(utils::image::view(tiled), tx, ty, {8, 6});
+                REQUIRE( image::color_convert(src_tile, dst_tile, pool) );
+            }
+        }
+        for(auto p = 0u; p < 3; p++) {
+            auto [w, h] = utils::interpreted_plane_img_size(whole.meta_data(), p);
+            for(auto y = 0u; y < h; y++) {
+                REQUIRE( std::equal(utils::ConstImageView{whole}.row(y, p), utils::ConstImageView{whole}.row(y, p) + w, utils::ConstImageView{tiled}.row(y, p)) );
+            }
+        }
+
+        //Back to RGBA into a region of a larger image, pixels around it stay untouched
+        auto canvas = utils::image::create_cpu( {40, 20}, utils::pixel::RGBA8::value, {.zero_fill = true} );
+        auto region = utils::image::roi(utils::image::view(canvas), 10, 4, {24, 12});
+        REQUIRE( image::color_convert(whole, region) );
+        REQUIRE( utils::ConstImageView{canvas}.row(4)[10 * 4 + 3] == 255 );
+        REQUIRE( utils::ConstImageView{canvas}.row(4)[9 * 4 + 3] == 0 );
+        REQUIRE( utils::ConstImageView{canvas}.row(4)[34 * 4 + 3] == 0 );
+        REQUIRE( utils::ConstImageView{canvas}.row(3)[10 * 4 + 3] == 0 );
+        REQUIRE( utils::ConstImageView{canvas}.row(16)[10 * 4 + 3] == 0 );
+    }
+
+    SECTION("Flip Y Roi")
+    {
+        auto flipped = utils::image::create_cpu( {24, 12}, utils::pixel::RGBA8::value, {.zero_fill = true} );
+        auto src = utils::image::roi(utils::ConstImageView{rgba_image}, 4, 2, {6, 8});
+        auto dst = utils::image::roi(utils::image::view(flipped), 4, 2, {6, 8});
+        REQUIRE( image::flip_y(src, dst) );
+
+        for(auto y = 0u; y < 8; y++) {
+            REQUIRE( std::equal(src.row(y), src.row(y) + 6 * 4, dst.row(7 - y)) );
+        }
+        REQUIRE( utils::ConstImageView{flipped}.row(2)[3 * 4] == 0 );
+        REQUIRE( utils::ConstImageView{flipped}.row(2)[10 * 4] == 0 );
+    }
+}
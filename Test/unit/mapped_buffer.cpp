@@ -0,0 +1,84 @@
+#include <catch2/catch.hpp>
+#include "image/mapped_buffer.hpp"
+#include "image/image_view.hpp"
+#include "image/process/conversion.hpp"
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <system_error>
+
+TEST_CASE("Mapped Buffer", "[mapped]")
+{
+    using namespace nitros;
+
+    auto path = (std::filesystem::temp_directory_path() / "nitros_mapped_buffer_test.raw").string();
+    auto meta = utils::ImageMetaData{{30, 20}, utils::pixel::YUV420p::value};
+
+    SECTION("Create Open")
+    {
+        {
+            auto image = utils::image::create_mapped(path, meta.size, meta.format);
+            REQUIRE( image.buffer().size() == utils::image::buffer_size(meta) );
+            REQUIRE( image.buffer().mode() == utils::MapMode::read_write );
+            for(auto i = 0u; i < image.buffer().size(); i++) {
+                image.buffer()[i] = static_cast<std::uint8_t>(i * 13);
+            }
+            image.buffer().flush();
+        }
+        REQUIRE( std::filesystem::file_size(path) == utils::image::buffer_size(meta) );
+
+        auto image = utils::image::open_mapped(path, meta);
+        REQUIRE( image.meta_data() == meta );
+        REQUIRE( image.buffer()[777] == static_cast<std::uint8_t>(777 * 13) );
+
+        //Views place the planes like create_cpu does
+        auto view = utils::image::view(image);
+        REQUIRE( view.plane(1) == image.buffer().data() + 30 * 20 );
+
+        auto rgba = utils::image::create_cpu(meta.size, utils::pixel::RGBA8::value);
+        REQUIRE( nitros::image::color_convert(image, rgba) );
+
+        //Private writes never reach the file
+        {
+            auto cow = utils::image::open_mapped(path, meta, utils::MapMode::copy_on_write);
+            cow.buffer()[0] = 99;
+            REQUIRE( cow.buffer()[0] == 99 );
+        }
+        REQUIRE( utils::image::open_mapped(path, meta).buffer()[0] == 0 );
+    }
+
+    SECTION("Offset")
+    {
+        //Planes after an odd sized header, the mapping itself starts on a page
+        {
+            auto file = std::ofstream(path, std::ios::binary);
+            file << "HDR";
+            for(auto i = 0u; i < utils::image::buffer_size(meta); i++) {
+                file.put(static_cast<char>(i % 251));
+            }
+        }
+        auto image = utils::image::open_mapped(path, meta, utils::MapMode::read_only, 3);
+        REQUIRE( image.buffer()[0] == 0 );
+        REQUIRE( image.buffer()[300] == 300 % 251 );
+
+        auto moved = std::move(image.buffer());
+        REQUIRE( moved[1] == 1 );
+        REQUIRE( image.buffer().empty() );
+    }
+
+    SECTION("Errors")
+    {
+        {
+            auto file = std::ofstream(path, std::ios::binary);
+            file << "short";
+        }
+        REQUIRE_THROWS_AS( utils::image::open_mapped(path, meta), std::invalid_argument );
+        REQUIRE_THROWS_AS( utils::MappedBuffer(path + ".missing", utils::MapMode::read_only), std::system_error );
+
+        auto whole = utils::MappedBuffer(path, utils::MapMode::read_only);
+        REQUIRE( whole.size() == 5 );
+        REQUIRE( whole[4] == 't' );
+    }
+
+    std::filesystem::remove(path);
+}
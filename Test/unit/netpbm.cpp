@@ -0,0 +1,115 @@
+#include <catch2/catch.hpp>
+#include "image/fileio.hpp"
+#include "test_images.hpp"
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+TEST_CASE("Netpbm Codec", "[netpbm]")
+{
+    using namespace nitros;
+
+    auto bytes = [](const std::string  &text) {
+        return std::vector<std::uint8_t>(text.begin(), text.end());
+    };
+
+    SECTION("Round Trip")
+    {
+        for(auto format : {utils::pixel::GREY8::value, utils::pixel::GREY16::value, utils::pixel::RGB8::value,
+                           utils::pixel::RGB16::value, utils::pixel::RGBA8::value, utils::pixel::RGBA16::value})
+        {
+            //Odd widths run the vector byte swap and its scalar tail
+            auto image = test::make_image({37, 11}, format);
+            auto encoded = utils::image::encode_pnm(utils::image::view(image));
+            auto decoded = utils::image::decode_pnm(encoded);
+            REQUIRE( decoded.meta_data().format == format );
+            REQUIRE( test::same_planes(utils::image::view(image), utils::image::view(decoded)) );
+        }
+    }
+
+    SECTION("Big Endian Samples")
+    {
+        auto image = utils::image::create_cpu({2, 1}, utils::pixel::GREY16::value);
+        auto samples = std::vector<std::uint16_t>{0x1234, 0xabcd};
+        std::memcpy(image.buffer().data(), samples.data(), 4);
+
+        auto expected = bytes("P5\n2 1\n65535\n");
+        expected.insert(expected.end(), {0x12, 0x34, 0xab, 0xcd});
+        REQUIRE( utils::image::encode_pnm(utils::image::view(image)) == expected );
+
+        auto rgba = utils::image::create_cpu({1, 1}, utils::pixel::RGBA8::value);
+        auto header = bytes("P7\nWIDTH 1\nHEIGHT 1\nDEPTH 4\nMAXVAL 255\nTUPLTYPE RGB_ALPHA\nENDHDR\n");
+        auto encoded = utils::image::encode_pnm(utils::image::view(rgba));
+        REQUIRE( std::equal(header.begin(), header.end(), encoded.begin()) );
+    }
+
+    SECTION("Header Parsing")
+    {
+        auto ppm = bytes("P6 # comment\n# another\n2\t1 255\n");
+        ppm.insert(ppm.end(), {1, 2, 3, 4, 5, 6});
+        auto image = utils::image::decode_pnm(ppm);
+        REQUIRE( image.meta_data().size == utils::ImgSize{2, 1} );
+        REQUIRE( image.meta_data().format == utils::pixel::RGB8::value );
+        REQUIRE( image.buffer()[5] == 6 );
+
+        auto pam = bytes("P7\nWIDTH 1\nHEIGHT 2\nDEPTH 1\nMAXVAL 1023\nTUPLTYPE GRAYSCALE\nENDHDR\n");
+        pam.insert(pam.end(), {0x03, 0xff, 0x00, 0x01});
+        auto grey = utils::image::decode_pnm(pam);
+        REQUIRE( grey.meta_data().format == utils::pixel::GREY16::value );
+    }
+
+    SECTION("Partial Range")
+    {
+        //10 bit samples are stretched to 16 bits, values above maxval clamp
+        auto pam = bytes("P7\nWIDTH 4\nHEIGHT 1\nDEPTH 1\nMAXVAL 1023\nTUPLTYPE GRAYSCALE\nENDHDR\n");
+        pam.insert(pam.end(), {0x03, 0xff, 0x00, 0x01, 0x02, 0x00, 0x04, 0x00});
+        auto grey = utils::image::decode_pnm(pam);
+        REQUIRE( grey.meta_data().format == utils::pixel::GREY16::value );
+        auto samples = std::vector<std::uint16_t>(4);
+        std::memcpy(samples.data(), grey.buffer().data(), 8);
+        REQUIRE( samples == std::vector<std::uint16_t>{65535, 64, 32800, 65535} );
+
+        auto pgm = bytes("P5\n3 1\n15\n");
+        pgm.insert(pgm.end(), {15, 1, 8});
+        auto narrow = utils::image::decode_pnm(pgm);
+        REQUIRE( narrow.meta_data().format == utils::pixel::GREY8::value );
+        REQUIRE( narrow.buffer()[0] == 255 );
+        REQUIRE( narrow.buffer()[1] == 17 );
+        REQUIRE( narrow.buffer()[2] == 136 );
+    }
+
+    SECTION("Region And File")
+    {
+        auto path = test::temp_path("nitros_netpbm_test.pam");
+        auto image = test::make_image({40, 20}, utils::pixel::RGBA16::value);
+        auto region = utils::image::roi(utils::image::view(image), 3, 2, {21, 13});
+        utils::image::write_image_pnm(path, region);
+
+        auto decoded = utils::image::read_image_pnm(path);
+        REQUIRE( test::same_planes(region, utils::image::view(decoded)) );
+
+        auto target_image = utils::image::create_cpu({40, 20}, utils::pixel::RGBA16::value);
+        auto target = utils::image::roi(utils::image::view(target_image), 1, 1, {21, 13});
+        utils::image::decode_pnm(utils::image::encode_pnm(region), target);
+        REQUIRE( test::same_planes(region, target) );
+        std::filesystem::remove(path);
+    }
+
+    SECTION("Errors")
+    {
+        auto yuv = utils::image::create_cpu({16, 16}, utils::pixel::YUV420p::value);
+        REQUIRE_THROWS_AS( utils::image::encode_pnm(utils::image::view(yuv)), std::invalid_argument );
+
+        auto encoded = utils::image::encode_pnm(utils::image::view(test::make_image({8, 8}, utils::pixel::RGB8::value)));
+        auto grey = utils::image::create_cpu({8, 8}, utils::pixel::GREY8::value);
+        REQUIRE_THROWS_AS( utils::image::decode_pnm(encoded, utils::image::view(grey)), std::invalid_argument );
+
+        encoded.resize(encoded.size() - 1);
+        REQUIRE_THROWS_AS( utils::image::decode_pnm(encoded), std::runtime_error );
+        REQUIRE_THROWS_AS( utils::image::decode_pnm(bytes("P3\n1 1\n255\n0 0 0\n")), std::runtime_error );
+        REQUIRE_THROWS_AS( utils::image::decode_pnm(bytes("P7\nWIDTH 1\nHEIGHT 1\nDEPTH 2\nMAXVAL 255\nENDHDR\nab")), std::runtime_error );
+    }
+}
@@ -3,6 +3,7 @@
 #include <catch2/catch.hpp>
 #include "image/image.hpp"
 #include "image/pixel/read_write.hpp"
+#include "image/pixel/typed.hpp"
 #include <iostream>
 
 TEST_CASE("Pixel Reader", "[read] [pixel]")
@@ -240,4 +241,162 @@ TEST_CASE("Pixel Reader", "[read] [pixel]")
         REQUIRE(st_1[0][0] == 0x22);
         REQUIRE(st_1[1][0] == 0x11);
     }
-}
\ No newline at end of file
+}
+TEST_CASE("Typed Pixel View", "[read] [write] [pixel] [typed]")
+{
+    using namespace nitros;
+
+    SECTION("Format Traits")
+    {
+        using rgba_traits = utils::pixel::format_traits<utils::pixel::RGBA8>;
+        static_assert( rgba_traits::channels == 4 );
+        static_assert( rgba_traits::planes == 1 );
+        static_assert( rgba_traits::pixel_bits[0] == 32 );
+        static_assert( rgba_traits::bit_offset[2] == 16 );
+
+        using yuva_traits = utils::pixel::format_traits<utils::pixel::YUVA420p>;
+        static_assert( yuva_traits::channels == 4 );
+        static_assert( yuva_traits::planes == 3 );
+        static_assert( yuva_traits::plane_index[1] == 0 );
+        static_assert( yuva_traits::plane_index[3] == 2 );
+        static_assert( yuva_traits::bit_offset[1] == 8 );
+        static_assert( yuva_traits::pixel_bits[0] == 16 );
+
+        using grey_stencil_traits = utils::pixel::format_traits<utils::pixel::GREY_STENCIL_24_8>;
+        static_assert( grey_stencil_traits::bit_offset[1] == 24 );
+    }
+
+    SECTION("RGBA8 matches Reader")
+    {
+        auto rgba_image = utils::image::create_cpu( {3, 2}, utils::pixel::RGBA8::value );
+        for(auto i = 0u; i < rgba_image.buffer().size(); i++) {
+            rgba_image.buffer().data()[i] = static_cast<std::uint8_t>(i * 7);
+        }
+
+        auto typed  = utils::pixel::TypedReader<utils::pixel::RGBA8, std::uint8_t>{rgba_image};
+        auto reader = utils::pixel::Reader<std::uint8_t>{rgba_image};
+        for(auto y = 0u; y < 2; y++) {
+            for(auto x = 0u; x < 3; x++) {
+                auto px  = typed.at({x, y});
+                auto ref = reader.at({x, y});
+                REQUIRE( px[0] == ref[0] );
+                REQUIRE( px[1] == ref[1] );
+                REQUIRE( px[2] == ref[2] );
+                REQUIRE( px[3] == ref[3] );
+            }
+        }
+
+        auto writer = utils::pixel::TypedWriter<utils::pixel::RGBA8, std::uint8_t>{rgba_image};
+        writer.at({0x01, 0x02, 0x03, 0x04}, {1, 1});
+        writer.set<2>(0xAB, {2, 0});
+
+        auto st = rgba_image.buffer().data() + rgba_image.meta_data().steps[0];
+        REQUIRE( st[4] == 0x01 );
+        REQUIRE( st[5] == 0x02 );
+        REQUIRE( st[6] == 0x03 );
+        REQUIRE( st[7] == 0x04 );
+        REQUIRE( rgba_image.buffer().data()[2*4 + 2] == 0xAB );
+    }
+
+    SECTION("YUV420p matches Reader")
+    {
+        auto yuv_image = utils::image::create_cpu( {4, 4}, utils::pixel::YUV420p::value );
+        for(auto i = 0u; i < yuv_image.buffer().size(); i++) {
+            yuv_image.buffer().data()[i] = static_cast<std::uint8_t>(0xF0 - i);
+        }
+
+        auto typed  = utils::pixel::TypedReader<utils::pixel::YUV420p, std::uint16_t>{yuv_image};
+        auto reader = utils::pixel::Reader<std::uint16_t>{yuv_image};
+        for(auto y = 0u; y < 4; y++) {
+            for(auto x = 0u; x < 4; x++) {
+                auto px  = typed.at({x, y});
+                auto ref = reader.at({x, y});
+                REQUIRE( px[0] == ref[0] );
+                REQUIRE( px[1] == ref[1] );
+                REQUIRE( px[2] == ref[2] );
+            }
+        }
+
+        auto writer = utils::pixel::TypedWriter<utils::pixel::YUV420p, std::uint8_t>{yuv_image};
+        writer.at({0x11, 0x22, 0x33}, {3, 3});
+        REQUIRE( typed.get<0>({3, 3}) == 0x11 );
+        REQUIRE( typed.get<1>({2, 2}) == 0x22 );
+        REQUIRE( typed.get<2>({2, 3}) == 0x33 );
+    }
+}
+
+TEST_CASE("Pixel Row Access", "[read] [write] [pixel] [row]")
+{
+    using namespace nitros;
+
+    SECTION("RGB8 Rows")
+    {
+        auto rgb_image = utils::image::create_cpu( {3, 2}, utils::pixel::RGB8::value );
+        for(auto i = 0u; i < rgb_image.buffer().size(); i++) {
+            rgb_image.buffer().data()[i] = static_cast<std::uint8_t>(i + 1);
+        }
+
+        auto reader = utils::pixel::ReaderRGBA<std::uint8_t>{rgb_image};
+        auto row = reader.row(1);
+        REQUIRE( row.size() == 3 * 3 );
+        REQUIRE( row.data() == rgb_image.buffer().data() + rgb_image.meta_data().steps[0] );
+
+        auto pixels = std::vector<utils::pixel::PixelRGBA<std::uint8_t>>(3);
+        reader.read_row(1, pixels);
+        for(auto x = 0u; x < 3; x++) {
+            auto px = reader.at({x, 1});
+            REQUIRE( pixels[x].r == px.r );
+            REQUIRE( pixels[x].g == px.g );
+            REQUIRE( pixels[x].b == px.b );
+            REQUIRE( pixels[x].a == 0xff );
+        }
+
+        auto bgra_image = utils::image::create_cpu( {3, 2}, utils::pixel::BGRA8::value );
+        auto writer = utils::pixel::WriterRGBA<std::uint8_t>{bgra_image};
+        writer.write_row(0, pixels);
+        auto st = bgra_image.buffer().data();
+        REQUIRE( st[0] == pixels[0].b );
+        REQUIRE( st[2] == pixels[0].r );
+        REQUIRE( st[3] == 0xff );
+        REQUIRE( st[4*2 + 1] == pixels[2].g );
+    }
+
+    SECTION("YUV420p Rows")
+    {
+        auto yuv_image = utils::image::create_cpu( {4, 4}, utils::pixel::YUV420p::value );
+        auto writer = utils::pixel::WriterYUV<std::uint8_t>{yuv_image};
+        REQUIRE( writer.row(3, 0).size() == 4 );
+        REQUIRE( writer.row(3, 1).size() == 2 );
+        REQUIRE( writer.row(3, 1).data() == yuv_image.buffer().data() + 16 + 2 );
+
+        auto pixels = std::vector<utils::pixel::PixelYUV<std::uint8_t>>{
+            {.y = 0x10, .cb = 0x20, .cr = 0x30, .a = 0xff},
+            {.y = 0x11, .cb = 0x21, .cr = 0x31, .a = 0xff},
+            {.y = 0x12, .cb = 0x22, .cr = 0x32, .a = 0xff},
+            {.y = 0x13, .cb = 0x23, .cr = 0x33, .a = 0xff}
+        };
+        writer.write_row(2, pixels);
+
+        auto st = yuv_image.buffer().data();
+        REQUIRE( st[2*4 + 0] == 0x10 );
+        REQUIRE( st[2*4 + 3] == 0x13 );
+        REQUIRE( st[16 + 2 + 0] == 0x20 );
+        REQUIRE( st[16 + 2 + 1] == 0x22 );
+        REQUIRE( st[16 + 4 + 2 + 0] == 0x30 );
+        REQUIRE( st[16 + 4 + 2 + 1] == 0x32 );
+
+        auto reader = utils::pixel::ReaderYUV<std::uint8_t>{yuv_image};
+        auto read = std::vector<utils::pixel::PixelYUV<std::uint8_t>>(4);
+        reader.read_row(2, read);
+        REQUIRE( read[1].y  == 0x11 );
+        REQUIRE( read[1].cb == 0x20 );
+        REQUIRE( read[3].cr == 0x32 );
+
+        auto raw = utils::pixel::Reader<std::uint8_t>{yuv_image};
+        auto data = std::vector<utils::pixel::PixelData<std::uint8_t>>(4);
+        raw.read_row(2, data);
+        REQUIRE( data[3].size() == 3 );
+        REQUIRE( data[3][0] == 0x13 );
+        REQUIRE( data[3][1] == 0x22 );
+    }
+}
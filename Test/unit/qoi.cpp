@@ -0,0 +1,89 @@
+#include <catch2/catch.hpp>
+#include "image/fileio.hpp"
+#include "test_images.hpp"
+#include <cstdint>
+#include <filesystem>
+#include <stdexcept>
+#include <vector>
+
+TEST_CASE("QOI Codec", "[qoi]")
+{
+    using namespace nitros;
+
+    SECTION("Round Trip")
+    {
+        for(auto format : {utils::pixel::RGB8::value, utils::pixel::RGBA8::value})
+        {
+            auto image = test::make_image({37, 30}, format);
+            auto encoded = utils::image::encode_qoi(utils::image::view(image));
+            REQUIRE( encoded.size() < utils::image::buffer_size(image.meta_data()) );
+
+            auto decoded = utils::image::decode_qoi(encoded);
+            REQUIRE( decoded.meta_data() == image.meta_data() );
+            REQUIRE( test::same_planes(utils::image::view(image), utils::image::view(decoded)) );
+        }
+    }
+
+    SECTION("Known Bytes")
+    {
+        //A single pixel equal to the initial {0, 0, 0, 255} is a run of one
+        auto image = utils::image::create_cpu({1, 1}, utils::pixel::RGB8::value);
+        image.buffer()[0] = image.buffer()[1] = image.buffer()[2] = 0;
+        auto encoded = utils::image::encode_qoi(utils::image::view(image));
+        auto expected = std::vector<std::uint8_t>{'q', 'o', 'i', 'f', 0, 0, 0, 1, 0, 0, 0, 1, 3, 0, 0xc0, 0, 0, 0, 0, 0, 0, 0, 1};
+        REQUIRE( encoded == expected );
+    }
+
+    SECTION("Region Target")
+    {
+        auto image = test::make_image({64, 48}, utils::pixel::RGBA8::value);
+        auto region = utils::image::roi(utils::image::view(image), 5, 7, {20, 30});
+        auto chunks = 0;
+        auto encoded = std::vector<std::uint8_t>{};
+        utils::image::encode_qoi(region, [&](const std::uint8_t  *data, std::size_t  size) {
+            chunks++;
+            encoded.insert(encoded.end(), data, data + size);
+        });
+        REQUIRE( chunks == 30 + 2 );
+
+        auto target_image = utils::image::create_cpu({64, 48}, utils::pixel::RGBA8::value);
+        auto target = utils::image::roi(utils::image::view(target_image), 5, 7, {20, 30});
+        utils::image::decode_qoi(encoded, target);
+        REQUIRE( test::same_planes(region, target) );
+
+        //Opaque alpha is filled in for 3 channel files
+        auto rgb = test::make_image({8, 8}, utils::pixel::RGB8::value);
+        auto rgba = utils::image::create_cpu({8, 8}, utils::pixel::RGBA8::value);
+        utils::image::decode_qoi(utils::image::encode_qoi(utils::image::view(rgb)), utils::image::view(rgba));
+        REQUIRE( rgba.buffer()[3] == 255 );
+        REQUIRE( rgba.buffer()[4] == rgb.buffer()[3] );
+    }
+
+    SECTION("File")
+    {
+        auto path = test::temp_path("nitros_qoi_test.qoi");
+        auto image = test::make_image({50, 21}, utils::pixel::RGBA8::value);
+        utils::image::write_image_qoi(path, utils::image::view(image));
+        auto decoded = utils::image::read_image_qoi(path);
+        REQUIRE( test::same_planes(utils::image::view(image), utils::image::view(decoded)) );
+        std::filesystem::remove(path);
+    }
+
+    SECTION("Errors")
+    {
+        auto image = test::make_image({16, 16}, utils::pixel::RGB8::value);
+        auto encoded = utils::image::encode_qoi(utils::image::view(image));
+
+        auto grey = utils::image::create_cpu({16, 16}, utils::pixel::GREY8::value);
+        REQUIRE_THROWS_AS( utils::image::encode_qoi(utils::image::view(grey)), std::invalid_argument );
+
+        auto small = utils::image::create_cpu({8, 16}, utils::pixel::RGB8::value);
+        REQUIRE_THROWS_AS( utils::image::decode_qoi(encoded, utils::image::view(small)), std::invalid_argument );
+
+        auto truncated = std::vector<std::uint8_t>(encoded.begin(), encoded.begin() + encoded.size() / 2);
+        REQUIRE_THROWS_AS( utils::image::decode_qoi(truncated), std::runtime_error );
+
+        encoded[0] = 'x';
+        REQUIRE_THROWS_AS( utils::image::decode_qoi(encoded), std::runtime_error );
+    }
+}
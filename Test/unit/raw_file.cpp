@@ -0,0 +1,94 @@
+#include <catch2/catch.hpp>
+#include "image/fileio.hpp"
+#include "test_images.hpp"
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+
+TEST_CASE("Raw Image File", "[raw]")
+{
+    using namespace nitros;
+
+    auto path = test::temp_path("nitros_raw_file_test.nimg");
+
+    SECTION("Planar Round Trip")
+    {
+        auto image = test::make_image({34, 22}, utils::pixel::YUV420p::value);
+        utils::image::write_image_raw(path, utils::image::view(image));
+
+        auto mapped = utils::image::open_image_raw(path);
+        REQUIRE( mapped.meta_data() == image.meta_data() );
+        REQUIRE( reinterpret_cast<std::uintptr_t>(mapped.buffer().data()) % 4096 == 0 );
+        REQUIRE( test::same_planes(utils::image::view(image), utils::image::view(mapped)) );
+
+        auto loaded = utils::image::read_image_raw(path);
+        REQUIRE( loaded.meta_data() == image.meta_data() );
+        REQUIRE( loaded.buffer() == image.buffer() );
+    }
+
+    SECTION("Region Source")
+    {
+        auto image = test::make_image({40, 30}, utils::pixel::RGB16::value);
+        auto region = utils::image::roi(utils::image::view(image), 3, 4, {17, 9});
+        utils::image::write_image_raw(path, region);
+
+        auto mapped = utils::image::open_image_raw(path);
+        REQUIRE( mapped.meta_data().size == utils::ImgSize{17, 9} );
+        REQUIRE( mapped.meta_data().format == utils::pixel::RGB16::value );
+        REQUIRE( test::same_planes(region, utils::image::view(mapped)) );
+    }
+
+    SECTION("Damaged")
+    {
+        auto image = test::make_image({16, 16}, utils::pixel::RGBA8::value);
+        utils::image::write_image_raw(path, utils::image::view(image));
+
+        //Cut into the pixel data
+        std::filesystem::resize_file(path, std::filesystem::file_size(path) - 10);
+        REQUIRE_THROWS_AS( utils::image::open_image_raw(path), std::runtime_error );
+
+        {
+            auto file = std::ofstream(path, std::ios::binary);
+            file << "not an image";
+        }
+        REQUIRE_THROWS_AS( utils::image::read_image_raw(path), std::runtime_error );
+    }
+
+    SECTION("Damaged Header")
+    {
+        auto image = test::make_image({16, 16}, utils::pixel::RGBA8::value);
+        auto row_bytes = utils::plane_row_bytes(image.meta_data(), 0);
+
+        //Writes a little endian field of the header of a fresh file
+        auto patched = [&](std::size_t  offset, std::uint64_t  value, std::size_t  size) {
+            utils::image::write_image_raw(path, utils::image::view(image));
+            auto file = std::fstream(path, std::ios::binary | std::ios::in | std::ios::out);
+            file.seekp(static_cast<std::streamoff>(offset));
+            for(auto i = std::size_t{0}; i < size; i++) {
+                file.put(static_cast<char>(value >> (8 * i)));
+            }
+        };
+
+        //Group pixels of 0 would divide by zero computing rows
+        patched(52, 0, 4);
+        REQUIRE_THROWS_AS( utils::image::open_image_raw(path), std::runtime_error );
+        //Bits per channel that do not match the layout
+        patched(64, 2, 4);
+        REQUIRE_THROWS_AS( utils::image::open_image_raw(path), std::runtime_error );
+        //A layout of no predefined format
+        patched(44, 5, 4);
+        REQUIRE_THROWS_AS( utils::image::read_image_raw(path), std::runtime_error );
+        //Rows would overlap and the last one run past the mapping
+        patched(216, row_bytes - 4, 8);
+        REQUIRE_THROWS_AS( utils::image::open_image_raw(path), std::runtime_error );
+        //Steps larger than the data with the data size raised to match would overflow
+        patched(216, std::uint64_t{1} << 62, 8);
+        REQUIRE_THROWS_AS( utils::image::open_image_raw(path), std::runtime_error );
+
+        patched(216, row_bytes, 8);
+        REQUIRE( test::same_planes(utils::image::view(image), utils::image::view(utils::image::open_image_raw(path))) );
+    }
+
+    std::filesystem::remove(path);
+}
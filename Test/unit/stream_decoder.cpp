@@ -0,0 +1,107 @@
+#include <catch2/catch.hpp>
+#include "image/stream_decoder.hpp"
+#include "test_images.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+TEST_CASE("Stream Decoder", "[stream]")
+{
+    using namespace nitros;
+
+    //Pushes the encoded bytes in chunks of chunk_size and checks the reported rows are contiguous
+    auto stream = [](const std::vector<std::uint8_t>  &encoded, std::size_t  chunk_size, utils::image::StreamDecoder  &decoder) {
+        auto rows = std::size_t{0};
+        for(auto pos = std::size_t{0}; pos < encoded.size(); pos += chunk_size)
+        {
+            auto size = std::min(chunk_size, encoded.size() - pos);
+            decoder.push(gsl::span<const std::uint8_t>(encoded.data() + pos, size));
+            REQUIRE( decoder.rows_ready() >= rows );
+            rows = decoder.rows_ready();
+        }
+        decoder.finish();
+    };
+
+    SECTION("Chunked")
+    {
+        for(auto format : {utils::pixel::RGB8::value, utils::pixel::RGBA8::value, utils::pixel::GREY16::value, utils::pixel::RGBA16::value})
+        {
+            auto image = test::make_image({45, 23}, format);
+            auto is_qoi = format.pixel_layout.bytes == format.pixel_layout.channels && format.pixel_layout.channels >= 3;
+            auto encoded = is_qoi ? utils::image::encode_qoi(utils::image::view(image)) : utils::image::encode_pnm(utils::image::view(image));
+
+            for(auto chunk_size : {std::size_t{1}, std::size_t{3}, std::size_t{7}, std::size_t{1000}, encoded.size()})
+            {
+                auto reported = std::size_t{0};
+                auto decoder = utils::image::StreamDecoder({}, [&](const utils::ConstImageView  &, std::size_t  first_row, std::size_t  last_row) {
+                    REQUIRE( first_row == reported );
+                    REQUIRE( last_row > first_row );
+                    reported = last_row;
+                });
+                stream(encoded, chunk_size, decoder);
+
+                REQUIRE( decoder.finished() );
+                REQUIRE( reported == 23 );
+                REQUIRE( decoder.image()->meta_data().format == format );
+                REQUIRE( test::same_planes(utils::image::view(image), utils::image::view(*decoder.image())) );
+            }
+        }
+    }
+
+    SECTION("Progressive")
+    {
+        auto image = test::make_image({16, 40}, utils::pixel::GREY8::value);
+        auto encoded = utils::image::encode_pnm(utils::image::view(image));
+        auto decoder = utils::image::StreamDecoder{};
+
+        decoder.push(gsl::span<const std::uint8_t>(encoded.data(), 8));
+        REQUIRE_FALSE( decoder.header_ready() );
+        REQUIRE( decoder.image() == nullptr );
+
+        //Header plus ten rows and a half
+        auto header_bytes = encoded.size() - 16 * 40;
+        decoder.push(gsl::span<const std::uint8_t>(encoded.data() + 8, header_bytes - 8 + 16 * 10 + 8));
+        REQUIRE( decoder.header_ready() );
+        REQUIRE( decoder.rows_ready() == 10 );
+        REQUIRE( std::memcmp(decoder.image()->buffer().data(), image.buffer().data(), 16 * 10) == 0 );
+        REQUIRE_THROWS_AS( decoder.finish(), std::runtime_error );
+    }
+
+    SECTION("Options")
+    {
+        auto rgb = test::make_image({9, 9}, utils::pixel::RGB8::value);
+        auto encoded = utils::image::encode_qoi(utils::image::view(rgb));
+
+        auto rgba_options = utils::image::DecodeOptions{};
+        rgba_options.format = utils::pixel::RGBA8::value;
+        auto decoder = utils::image::StreamDecoder{rgba_options};
+        stream(encoded, 5, decoder);
+        REQUIRE( decoder.image()->buffer()[3] == 255 );
+        REQUIRE( decoder.image()->buffer()[4] == rgb.buffer()[3] );
+
+        auto grey_options = utils::image::DecodeOptions{};
+        grey_options.format = utils::pixel::GREY8::value;
+        auto grey_decoder = utils::image::StreamDecoder{grey_options};
+        REQUIRE_THROWS_AS( grey_decoder.push(encoded), std::invalid_argument );
+
+        auto limited_options = utils::image::DecodeOptions{};
+        limited_options.max_pixels = 80;
+        auto limited = utils::image::StreamDecoder{limited_options};
+        REQUIRE_THROWS_AS( limited.push(encoded), std::length_error );
+    }
+
+    SECTION("Errors")
+    {
+        auto decoder = utils::image::StreamDecoder{};
+        auto not_qoi = std::vector<std::uint8_t>{'q', 'o', 'i', 'f', 0, 0, 0, 1, 0, 0, 0, 1, 2, 0};
+        REQUIRE_THROWS_AS( decoder.push(not_qoi), std::runtime_error );
+
+        auto finished = utils::image::StreamDecoder{};
+        auto encoded = utils::image::encode_pnm(utils::image::view(test::make_image({4, 4}, utils::pixel::RGB8::value)));
+        finished.push(encoded);
+        finished.finish();
+        REQUIRE_THROWS_AS( finished.push(encoded), std::runtime_error );
+    }
+}
@@ -0,0 +1,232 @@
+#include <catch2/catch.hpp>
+#include "image/strip_io.hpp"
+#include "image/process/conversion.hpp"
+#include "test_images.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+TEST_CASE("Strip IO", "[strip]")
+{
+    using namespace nitros;
+
+    auto read_file = [](const std::string  &path) {
+        auto file = std::ifstream(path, std::ios::binary);
+        return std::vector<std::uint8_t>(std::istreambuf_iterator<char>(file), {});
+    };
+
+    SECTION("Convert Strip By Strip")
+    {
+        auto source_path = test::temp_path("nitros_strip_source.ppm");
+        auto target_path = test::temp_path("nitros_strip_target.nimg");
+        auto image = test::make_image({37, 29}, utils::pixel::RGB8::value);
+        utils::image::write_image_pnm(source_path, utils::image::view(image));
+
+        auto reader = utils::image::StripReader(source_path, 6);
+        REQUIRE( reader.file_format() == utils::image::FileFormat::pnm );
+        REQUIRE( reader.meta_data().size == image.meta_data().size );
+
+        auto writer = utils::image::StripWriter(target_path, {37, 29}, utils::pixel::YUV420p::value, utils::image::FileFormat::raw);
+        auto yuv_strip = utils::image::create_cpu({37, 6}, utils::pixel::YUV420p::value);
+        for(auto strip = reader.next(); strip; strip = reader.next())
+        {
+            auto target = utils::image::roi(utils::image::view(yuv_strip), 0, 0, strip->size());
+            REQUIRE( image::color_convert(*strip, target) );
+            writer.write(target);
+        }
+        REQUIRE( reader.rows_read() == 29 );
+        writer.finish();
+
+        auto expected = utils::image::create_cpu({37, 29}, utils::pixel::YUV420p::value);
+        REQUIRE( image::color_convert(image, expected) );
+        auto written = utils::image::read_image_raw(target_path);
+        REQUIRE( test::same_planes(utils::image::view(expected), utils::image::view(written)) );
+
+        //Planar strips round up to the chroma rows
+        auto raw_reader = utils::image::StripReader(target_path, 5);
+        REQUIRE( raw_reader.strip_rows() == 6 );
+        auto rows = std::size_t{0};
+        for(auto strip = raw_reader.next(); strip; strip = raw_reader.next())
+        {
+            auto region = utils::image::roi(utils::image::view(std::as_const(expected)), 0, rows, strip->size());
+            REQUIRE( test::same_planes(region, *strip) );
+            rows += strip->size().height;
+        }
+        REQUIRE( rows == 29 );
+
+        std::filesystem::remove(source_path);
+        std::filesystem::remove(target_path);
+    }
+
+    SECTION("QOI Strips")
+    {
+        auto path = test::temp_path("nitros_strip.qoi");
+        //Taller than one read chunk, so ops get cut by refills
+        auto image = test::make_image({300, 200}, utils::pixel::RGBA8::value);
+        utils::image::write_image_qoi(path, utils::image::view(image));
+
+        auto reader = utils::image::StripReader(path, 7);
+        for(auto strip = reader.next(); strip; strip = reader.next())
+        {
+            auto first_row = reader.rows_read() - strip->size().height;
+            auto region = utils::image::roi(utils::image::view(std::as_const(image)), 0, first_row, strip->size());
+            REQUIRE( test::same_planes(region, *strip) );
+        }
+        REQUIRE( reader.rows_read() == 200 );
+        std::filesystem::remove(path);
+    }
+
+    SECTION("PNG Stored Blocks")
+    {
+        auto path = test::temp_path("nitros_strip.png");
+        auto image = test::make_image({3, 5}, utils::pixel::RGB8::value);
+        auto writer = utils::image::StripWriter(path, {3, 5}, utils::pixel::RGB8::value, utils::image::FileFormat::png);
+        writer.write(utils::image::roi(utils::image::view(std::as_const(image)), 0, 0, {3, 2}));
+        writer.write(utils::image::roi(utils::image::view(std::as_const(image)), 0, 2, {3, 3}));
+        writer.finish();
+
+        auto file = read_file(path);
+        REQUIRE( std::memcmp(file.data(), "\x89PNG\r\n\x1a\n", 8) == 0 );
+        REQUIRE( std::memcmp(file.data() + 12, "IHDR", 4) == 0 );
+        REQUIRE( file[24] == 8 );
+        REQUIRE( file[25] == 2 );
+        auto iend = std::vector<std::uint8_t>{0, 0, 0, 0, 'I', 'E', 'N', 'D', 0xae, 0x42, 0x60, 0x82};
+        REQUIRE( std::equal(iend.begin(), iend.end(), file.end() - 12) );
+
+        //Inflate the stored blocks of the IDAT chunks by hand
+        auto zlib = std::vector<std::uint8_t>{};
+        for(auto pos = std::size_t{33}; pos + 12 <= file.size(); )
+        {
+            auto length = std::size_t{file[pos]} << 24 | std::size_t{file[pos + 1]} << 16 | std::size_t{file[pos + 2]} << 8 | file[pos + 3];
+            if(std::memcmp(file.data() + pos + 4, "IDAT", 4) == 0) {
+                zlib.insert(zlib.end(), file.begin() + pos + 8, file.begin() + pos + 8 + length);
+            }
+            pos += length + 12;
+        }
+        REQUIRE( zlib[0] == 0x78 );
+        auto scanlines = std::vector<std::uint8_t>{};
+        auto pos = std::size_t{2};
+        for(auto final_block = false; !final_block; )
+        {
+            final_block = zlib[pos] == 1;
+            auto length = std::size_t{zlib[pos + 1]} | std::size_t{zlib[pos + 2]} << 8;
+            scanlines.insert(scanlines.end(), zlib.begin() + pos + 5, zlib.begin() + pos + 5 + length);
+            pos += 5 + length;
+        }
+        REQUIRE( zlib.size() == pos + 4 );
+        REQUIRE( scanlines.size() == 5 * 10 );
+        for(auto y = std::size_t{0}; y < 5; y++) {
+            REQUIRE( scanlines[y * 10] == 0 );
+            REQUIRE( std::memcmp(scanlines.data() + y * 10 + 1, image.buffer().data() + y * image.meta_data().steps[0], 9) == 0 );
+        }
+        std::filesystem::remove(path);
+    }
+
+    SECTION("BMP Top Down")
+    {
+        auto path = test::temp_path("nitros_strip.bmp");
+        auto image = test::make_image({3, 2}, utils::pixel::RGB8::value);
+        auto writer = utils::image::StripWriter(path, {3, 2}, utils::pixel::RGB8::value, utils::image::FileFormat::bmp);
+        writer.write(utils::image::view(image));
+        writer.finish();
+
+        auto file = read_file(path);
+        REQUIRE( file.size() == 54 + 12 * 2 );
+        REQUIRE( file[22] == 0xfe );    //Height -2
+        REQUIRE( file[54] == image.buffer()[2] );
+        REQUIRE( file[56] == image.buffer()[0] );
+        std::filesystem::remove(path);
+    }
+
+    SECTION("BMP Strips")
+    {
+        auto path = test::temp_path("nitros_strip_read.bmp");
+        auto check_strips = [&](const utils::ConstImageView  &expected) {
+            auto reader = utils::image::StripReader(path, 4);
+            REQUIRE( reader.file_format() == utils::image::FileFormat::bmp );
+            REQUIRE( reader.meta_data().size == expected.size() );
+            REQUIRE( reader.meta_data().format == expected.meta_data().format );
+            for(auto strip = reader.next(); strip; strip = reader.next())
+            {
+                auto first_row = reader.rows_read() - strip->size().height;
+                REQUIRE( test::same_planes(utils::image::roi(expected, 0, first_row, strip->size()), *strip) );
+            }
+            REQUIRE( reader.rows_read() == expected.size().height );
+        };
+        auto write_file = [&](const std::vector<std::uint8_t>  &bytes, std::size_t  size) {
+            auto file = std::ofstream(path, std::ios::binary);
+            file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(size));
+        };
+
+        //What StripWriter writes reads back, rows padded to 4 bytes and grey through its palette
+        for(auto format : {utils::pixel::GREY8::value, utils::pixel::RGB8::value, utils::pixel::RGBA8::value})
+        {
+            auto image = test::make_image({13, 11}, format);
+            auto writer = utils::image::StripWriter(path, {13, 11}, format, utils::image::FileFormat::bmp);
+            writer.write(utils::image::view(std::as_const(image)));
+            writer.finish();
+            check_strips(utils::image::view(std::as_const(image)));
+        }
+
+        //Bottom up, the usual layout of other writers: positive height and the last row first
+        auto image = test::make_image({13, 11}, utils::pixel::RGBA8::value);
+        auto top_down = read_file(path);
+        auto bottom_up = std::vector<std::uint8_t>(top_down.begin(), top_down.begin() + 54);
+        bottom_up[22] = 11;
+        bottom_up[23] = bottom_up[24] = bottom_up[25] = 0;
+        for(auto y = std::size_t{11}; y-- > 0; ) {
+            bottom_up.insert(bottom_up.end(), top_down.begin() + 54 + y * 52, top_down.begin() + 54 + (y + 1) * 52);
+        }
+        write_file(bottom_up, bottom_up.size());
+        check_strips(utils::image::view(std::as_const(image)));
+
+        //Compressed (RLE8) and truncated files
+        bottom_up[30] = 1;
+        write_file(bottom_up, bottom_up.size());
+        REQUIRE_THROWS_AS( utils::image::StripReader(path, 4), std::invalid_argument );
+        bottom_up[30] = 0;
+        write_file(bottom_up, bottom_up.size() - 1);
+        auto truncated = utils::image::StripReader(path, 4);
+        REQUIRE_THROWS_AS( truncated.next(), std::runtime_error );
+        std::filesystem::remove(path);
+    }
+
+    SECTION("Errors")
+    {
+        auto path = test::temp_path("nitros_strip_errors.bmp");
+        REQUIRE_THROWS_AS( utils::image::StripWriter(path, {8, 8}, utils::pixel::YUV420p::value, utils::image::FileFormat::png), std::invalid_argument );
+        REQUIRE_THROWS_AS( utils::image::StripWriter(path, {8, 8}, utils::pixel::RGB8::value, utils::image::FileFormat::jpg), std::invalid_argument );
+
+        auto image = test::make_image({8, 8}, utils::pixel::RGB8::value);
+        auto writer = utils::image::StripWriter(path, {8, 6}, utils::pixel::RGB8::value, utils::image::FileFormat::bmp);
+        REQUIRE_THROWS_AS( writer.write(utils::image::view(image)), std::invalid_argument );
+        writer.write(utils::image::roi(utils::image::view(std::as_const(image)), 0, 0, {8, 4}));
+        REQUIRE_THROWS_AS( writer.finish(), std::runtime_error );
+        std::filesystem::remove(path);
+
+        auto pnm_path = test::temp_path("nitros_strip_errors.pgm");
+        utils::image::write_image_pnm(pnm_path, utils::image::view(test::make_image({8, 8}, utils::pixel::GREY8::value)));
+        REQUIRE_THROWS_AS( utils::image::StripReader(pnm_path, 0), std::invalid_argument );
+        std::filesystem::resize_file(pnm_path, std::filesystem::file_size(pnm_path) - 3);
+        auto reader = utils::image::StripReader(pnm_path, 4);
+        REQUIRE( reader.next() );
+        REQUIRE_THROWS_AS( reader.next(), std::runtime_error );
+        std::filesystem::remove(pnm_path);
+
+        //Formats without an incremental decoder are rejected before anything is decoded, PNG included
+        auto other_path = test::temp_path("nitros_strip_errors.png");
+        {
+            auto file = std::ofstream(other_path, std::ios::binary);
+            file.write("\x89PNG\r\n\x1a\n", 8);
+        }
+        REQUIRE_THROWS_AS( utils::image::StripReader(other_path, 4), std::invalid_argument );
+        std::filesystem::remove(other_path);
+    }
+}
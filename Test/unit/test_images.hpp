@@ -0,0 +1,65 @@
+#ifndef NITROS_TEST_UNIT_TEST_IMAGES_HPP
+#define NITROS_TEST_UNIT_TEST_IMAGES_HPP
+
+#include "image/image.hpp"
+#include "image/image_view.hpp"
+#include "image/utils.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <random>
+#include <string>
+
+//Fixtures shared by the codec and file tests
+namespace nitros::test
+{
+    /**
+     * Image whose rows are flat in the top third, gradients in the middle and noise at the bottom,
+     * so run length, delta and literal paths of the codecs are all taken. Padding is zero, same seed, same buffer
+     * */
+    inline auto make_image(utils::ImgSize  size, const utils::pixel::Format  &format, std::uint32_t  seed = 7) -> utils::ImageCpu
+    {
+        auto image = utils::image::create_cpu(size, format);
+        auto &meta = image.meta_data();
+        auto rng = std::mt19937{seed};
+        std::fill(image.buffer().begin(), image.buffer().end(), std::uint8_t{0});
+        for(auto i = std::size_t{0}; i < meta.steps.size(); i++)
+        {
+            auto plane_size = utils::interpreted_plane_img_size(meta, i);
+            auto row_bytes = utils::plane_row_bytes(meta, i);
+            for(auto y = std::size_t{0}; y < plane_size.height; y++)
+            {
+                auto row = utils::image::view(image).row(y, i);
+                for(auto x = std::size_t{0}; x < row_bytes; x++) {
+                    auto value = y < plane_size.height / 3 ? 40 + x % 4 : y < plane_size.height * 2 / 3 ? x + y * 3 : rng();
+                    row[x] = static_cast<std::uint8_t>(value);
+                }
+            }
+        }
+        return image;
+    }
+
+    //Compares the rows of every plane, padding at the end of the rows is ignored
+    inline auto same_planes(const utils::ConstImageView  &lhs, const utils::ConstImageView  &rhs) -> bool
+    {
+        auto &meta = lhs.meta_data();
+        for(auto i = std::size_t{0}; i < meta.steps.size(); i++)
+        {
+            auto row_bytes = utils::plane_row_bytes(meta, i);
+            for(auto y = std::size_t{0}; y < utils::interpreted_plane_img_size(meta, i).height; y++) {
+                if(std::memcmp(lhs.row(y, i), rhs.row(y, i), row_bytes) != 0) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    inline auto temp_path(const std::string  &name) -> std::string
+    {
+        return (std::filesystem::temp_directory_path() / name).string();
+    }
+} // namespace nitros::test
+
+#endif
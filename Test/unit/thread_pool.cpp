@@ -0,0 +1,92 @@
+#include <catch2/catch.hpp>
+#include "image/process/thread_pool.hpp"
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+TEST_CASE("Thread Pool", "[thread]")
+{
+    using namespace nitros;
+
+    auto pool = image::ThreadPool{3};
+    REQUIRE( pool.size() == 3 );
+
+    SECTION("Submit")
+    {
+        auto future = pool.submit([]() { return 42; });
+        REQUIRE( future.get() == 42 );
+    }
+
+    SECTION("Parallel For Bands")
+    {
+        auto visits = std::vector<std::atomic<int>>(101);
+        auto unaligned = std::atomic<int>{0};
+        pool.parallel_for(0, visits.size(), 2, [&visits, &unaligned](std::size_t first, std::size_t last) {
+            unaligned += first % 2;
+            for(auto i = first; i < last; i++) {
+                visits[i]++;
+            }
+        });
+
+        REQUIRE( unaligned == 0 );
+        for(auto &visit : visits) {
+            REQUIRE( visit == 1 );
+        }
+    }
+
+    SECTION("Nested")
+    {
+        auto count = std::atomic<int>{0};
+        pool.parallel_for(0, 8, 1, [&pool, &count](std::size_t first, std::size_t last) {
+            pool.parallel_for(0, 8, 1, [&count](std::size_t first, std::size_t last) {
+                count += static_cast<int>(last - first);
+            });
+        });
+        REQUIRE( count == 8 * 4 );
+    }
+
+    SECTION("Exception")
+    {
+        REQUIRE_THROWS_AS( pool.parallel_for(0, 16, 1, [](std::size_t first, std::size_t) {
+            if(first != 0) {
+                throw std::runtime_error{"band failed"};
+            }
+        }), std::runtime_error );
+    }
+
+    SECTION("For Each Map")
+    {
+        auto visits = std::vector<std::atomic<int>>(200);
+        auto done = pool.for_each(visits.size(), [&visits](std::size_t index) { visits[index]++; }, 2);
+        done.get();
+        for(auto &visit : visits) {
+            REQUIRE( visit == 1 );
+        }
+
+        auto squares = pool.map(50, [](std::size_t index) {
+            if(index == 7) {
+                throw std::runtime_error{"item failed"};
+            }
+            return index * index;
+        });
+        REQUIRE( squares.size() == 50 );
+        REQUIRE( squares[9].get() == 81 );
+        REQUIRE_THROWS_AS( squares[7].get(), std::runtime_error );
+
+        auto failing = pool.for_each(10, [](std::size_t index) {
+            if(index == 3) {
+                throw std::runtime_error{"item failed"};
+            }
+        });
+        REQUIRE_THROWS_AS( failing.get(), std::runtime_error );
+        REQUIRE_NOTHROW( pool.for_each(0, [](std::size_t) {}).get() );
+    }
+
+    SECTION("Inline")
+    {
+        auto inline_pool = image::ThreadPool{0};
+        auto rows = 0;
+        inline_pool.parallel_for(3, 10, 4, [&rows](std::size_t first, std::size_t last) { rows += static_cast<int>(last - first); });
+        REQUIRE( rows == 7 );
+    }
+}
@@ -0,0 +1,164 @@
+#include <catch2/catch.hpp>
+#include "image/tiled_image.hpp"
+#include "test_images.hpp"
+#include <cstdint>
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+TEST_CASE("Tiled Image", "[tiled]")
+{
+    using namespace nitros;
+
+    SECTION("Regions Across Tiles")
+    {
+        auto path = test::temp_path("nitros_tiled_regions.ntile");
+        auto image = test::make_image({100, 70}, utils::pixel::RGB8::value);
+        auto source = utils::image::view(std::as_const(image));
+        {
+            auto tiled = utils::image::TiledImage::create(path, {100, 70}, utils::pixel::RGB8::value, {32, 16});
+            REQUIRE( tiled.tile_size() == utils::ImgSize{32, 16} );
+            REQUIRE( tiled.tile_grid() == utils::ImgSize{4, 5} );
+            tiled.write(0, 0, source);
+
+            auto region = tiled.region(20, 10, {50, 40});
+            REQUIRE( test::same_planes(utils::image::roi(source, 20, 10, {50, 40}), utils::image::view(region)) );
+            auto corner = tiled.region(96, 64, {4, 6});
+            REQUIRE( test::same_planes(utils::image::roi(source, 96, 64, {4, 6}), utils::image::view(corner)) );
+
+            auto tile = tiled.tile(1, 2);
+            REQUIRE( tile->meta_data().size == utils::ImgSize{32, 16} );
+            REQUIRE( test::same_planes(utils::image::roi(source, 32, 32, {32, 16}), utils::image::view(*tile)) );
+        }
+
+        //Written back on destruction
+        auto reopened = utils::image::TiledImage::open(path);
+        REQUIRE( reopened.meta_data().size == utils::ImgSize{100, 70} );
+        REQUIRE( test::same_planes(source, utils::image::view(reopened.region(0, 0, {100, 70}))) );
+        std::filesystem::remove(path);
+    }
+
+    SECTION("Cache Budget")
+    {
+        auto path = test::temp_path("nitros_tiled_cache.ntile");
+        auto image = test::make_image({64, 64}, utils::pixel::YUV420p::value);
+        auto source = utils::image::view(std::as_const(image));
+        auto tile_bytes = utils::image::buffer_size(utils::ImageMetaData{{16, 16}, utils::pixel::YUV420p::value});
+
+        auto tiled = utils::image::TiledImage::create(path, {64, 64}, utils::pixel::YUV420p::value, {15, 15}, 3 * tile_bytes);
+        REQUIRE( tiled.tile_size() == utils::ImgSize{16, 16} );
+        tiled.write(0, 0, source);
+
+        auto stats = tiled.stats();
+        REQUIRE( stats.misses == 16 );
+        REQUIRE( stats.resident_tiles == 3 );
+        REQUIRE( stats.resident_bytes == 3 * tile_bytes );
+        REQUIRE( stats.evictions == 13 );
+        REQUIRE( stats.write_backs == 13 );
+
+        //The last three tiles are resident, the first is read back from the file
+        REQUIRE( test::same_planes(utils::image::roi(source, 48, 48, {16, 16}), utils::image::view(tiled.region(48, 48, {16, 16}))) );
+        REQUIRE( tiled.stats().hits == 1 );
+        REQUIRE( test::same_planes(utils::image::roi(source, 0, 0, {16, 16}), utils::image::view(tiled.region(0, 0, {16, 16}))) );
+        REQUIRE( tiled.stats().misses == 17 );
+
+        //A partial write reads the tile first
+        auto patch = test::make_image({4, 2}, utils::pixel::YUV420p::value);
+        tiled.write(20, 30, utils::image::view(std::as_const(patch)));
+        REQUIRE( test::same_planes(utils::image::view(std::as_const(patch)), utils::image::view(tiled.region(20, 30, {4, 2}))) );
+        REQUIRE( test::same_planes(utils::image::roi(source, 16, 16, {4, 14}), utils::image::view(tiled.region(16, 16, {4, 14}))) );
+
+        tiled.set_cache_bytes(0);
+        REQUIRE( tiled.stats().resident_tiles == 1 );
+        tiled.flush();
+
+        auto reopened = utils::image::TiledImage::open(path, 0);
+        REQUIRE( test::same_planes(utils::image::view(std::as_const(patch)), utils::image::view(reopened.region(20, 30, {4, 2}))) );
+        REQUIRE( test::same_planes(utils::image::roi(source, 0, 0, {16, 30}), utils::image::view(reopened.region(0, 0, {16, 30}))) );
+        std::filesystem::remove(path);
+    }
+
+    SECTION("Tile Handles Are Snapshots")
+    {
+        auto path = test::temp_path("nitros_tiled_handles.ntile");
+        auto tiled = utils::image::TiledImage::create(path, {16, 8}, utils::pixel::GREY8::value, {8, 8});
+        auto first = test::make_image({16, 8}, utils::pixel::GREY8::value, 1);
+        auto second = test::make_image({16, 8}, utils::pixel::GREY8::value, 2);
+        tiled.write(0, 0, utils::image::view(std::as_const(first)));
+
+        auto handle = tiled.tile(0, 0);
+        //Partial and whole tile writes both leave the handle alone
+        tiled.write(0, 0, utils::image::roi(utils::image::view(std::as_const(second)), 0, 0, {4, 4}));
+        tiled.write(0, 0, utils::image::view(std::as_const(second)));
+        REQUIRE( test::same_planes(utils::image::roi(utils::image::view(std::as_const(first)), 0, 0, {8, 8}), utils::image::view(*handle)) );
+        REQUIRE( test::same_planes(utils::image::view(std::as_const(second)), utils::image::view(tiled.region(0, 0, {16, 8}))) );
+        REQUIRE( test::same_planes(utils::image::roi(utils::image::view(std::as_const(second)), 0, 0, {8, 8}), utils::image::view(*tiled.tile(0, 0))) );
+        std::filesystem::remove(path);
+    }
+
+    SECTION("Move Assignment Writes Back")
+    {
+        auto path = test::temp_path("nitros_tiled_assigned.ntile");
+        auto other_path = test::temp_path("nitros_tiled_assigned_other.ntile");
+        auto image = test::make_image({16, 8}, utils::pixel::GREY8::value);
+        {
+            auto other = utils::image::TiledImage::create(other_path, {4, 4}, utils::pixel::GREY8::value, {4, 4});
+            auto tiled = utils::image::TiledImage::create(path, {16, 8}, utils::pixel::GREY8::value, {8, 8});
+            tiled.write(0, 0, utils::image::view(std::as_const(image)));
+            tiled = std::move(other);
+            REQUIRE( tiled.meta_data().size == utils::ImgSize{4, 4} );
+        }
+
+        auto reopened = utils::image::TiledImage::open(path);
+        REQUIRE( test::same_planes(utils::image::view(std::as_const(image)), utils::image::view(reopened.region(0, 0, {16, 8}))) );
+        std::filesystem::remove(path);
+        std::filesystem::remove(other_path);
+    }
+
+    SECTION("Recovers From IO Errors")
+    {
+        auto path = test::temp_path("nitros_tiled_io.ntile");
+        auto image = test::make_image({16, 8}, utils::pixel::GREY8::value);
+        {
+            auto tiled = utils::image::TiledImage::create(path, {16, 8}, utils::pixel::GREY8::value, {8, 8});
+            tiled.write(0, 0, utils::image::view(std::as_const(image)));
+        }
+
+        auto tiled = utils::image::TiledImage::open(path, 0);
+        auto size = std::filesystem::file_size(path);
+        std::filesystem::resize_file(path, 4096);
+        REQUIRE_THROWS_AS( tiled.region(0, 0, {8, 8}), std::runtime_error );
+
+        //Zero filled where cut, the tiles come back once the file has its size again
+        std::filesystem::resize_file(path, size);
+        REQUIRE( tiled.region(0, 0, {8, 8}).buffer()[0] == 0 );
+        tiled.write(8, 0, utils::image::roi(utils::image::view(std::as_const(image)), 8, 0, {8, 8}));
+        tiled.flush();
+        auto reopened = utils::image::TiledImage::open(path);
+        REQUIRE( test::same_planes(utils::image::roi(utils::image::view(std::as_const(image)), 8, 0, {8, 8}), utils::image::view(reopened.region(8, 0, {8, 8}))) );
+        std::filesystem::remove(path);
+    }
+
+    SECTION("Errors")
+    {
+        auto path = test::temp_path("nitros_tiled_errors.ntile");
+        REQUIRE_THROWS_AS( utils::image::TiledImage::create(path, {0, 8}, utils::pixel::RGB8::value), std::invalid_argument );
+        REQUIRE_THROWS_AS( utils::image::TiledImage::create(path, {8, 8}, utils::pixel::RGB8::value, {0, 4}), std::invalid_argument );
+
+        {
+            auto tiled = utils::image::TiledImage::create(path, {8, 8}, utils::pixel::YUV420p::value, {4, 4});
+            auto grey = test::make_image({2, 2}, utils::pixel::GREY8::value);
+            REQUIRE_THROWS_AS( tiled.write(0, 0, utils::image::view(std::as_const(grey))), std::invalid_argument );
+            REQUIRE_THROWS_AS( tiled.region(4, 4, {6, 2}), std::invalid_argument );
+            REQUIRE_THROWS_AS( tiled.region(1, 0, {2, 2}), std::invalid_argument );
+            REQUIRE_THROWS_AS( tiled.tile(2, 0), std::invalid_argument );
+        }
+
+        std::filesystem::resize_file(path, std::filesystem::file_size(path) - 1);
+        REQUIRE_THROWS_AS( utils::image::TiledImage::open(path), std::runtime_error );
+        std::filesystem::resize_file(path, 100);
+        REQUIRE_THROWS_AS( utils::image::TiledImage::open(path), std::runtime_error );
+        std::filesystem::remove(path);
+    }
+}
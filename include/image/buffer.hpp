@@ -0,0 +1,109 @@
+#ifndef NITROS_IMAGE_BUFFER_HPP
+#define NITROS_IMAGE_BUFFER_HPP
+
+#include "image/image_export.h"
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+
+namespace nitros::utils
+{
+    struct BufferOptions
+    {
+        //Alignment of every allocation in bytes, power of two
+        std::size_t  alignment = 64;
+        //Buffers of at least this size are aligned to a page
+        std::size_t  page_threshold = 256 * 1024;
+        //Asks the OS for transparent huge pages, only used from huge_page_threshold on (Linux only)
+        bool         huge_pages = false;
+        std::size_t  huge_page_threshold = 4 * 1024 * 1024;
+        //New bytes are left uninitialized unless set
+        bool         zero_fill = false;
+    };
+
+    /**
+     * Byte buffer for image data, aligned and without the zero fill of std::vector
+     * Keeps the subset of the std::vector interface used on image buffers
+     * */
+    class NIMAGE_EXPORT AlignedBuffer final
+    {
+        public:
+        using value_type      = std::uint8_t;
+        using size_type       = std::size_t;
+        using pointer         = std::uint8_t*;
+        using const_pointer   = const std::uint8_t*;
+        using reference       = std::uint8_t&;
+        using const_reference = const std::uint8_t&;
+        using iterator        = std::uint8_t*;
+        using const_iterator  = const std::uint8_t*;
+
+        //Frees memory taken over with adopt()
+        using Deleter = void (*)(void*);
+
+        AlignedBuffer() noexcept;
+        //Contents are uninitialized unless options.zero_fill is set
+        explicit AlignedBuffer(size_type  size, const BufferOptions  &options = BufferOptions{});
+        AlignedBuffer(size_type  size, value_type  value);
+        AlignedBuffer(std::initializer_list<value_type>  values);
+        AlignedBuffer(const AlignedBuffer  &other);
+        AlignedBuffer(AlignedBuffer  &&other) noexcept;
+        ~AlignedBuffer();
+
+        auto operator=(const AlignedBuffer  &other) -> AlignedBuffer&;
+        auto operator=(AlignedBuffer  &&other) noexcept -> AlignedBuffer&;
+
+        /**
+         * Takes ownership of size bytes allocated elsewhere (e.g. by a decoder) without copying them
+         * The memory keeps the alignment of its allocator, growing the buffer moves it to an aligned allocation
+         * @param deleter frees data when the buffer releases it
+         * */
+        static auto adopt(pointer  data, size_type  size, Deleter  deleter, const BufferOptions  &options = BufferOptions{}) noexcept -> AlignedBuffer;
+        //capacity is the allocated size when it exceeds size, e.g. rounded up to whole alignment units by the allocator
+        static auto adopt(pointer  data, size_type  size, size_type  capacity, Deleter  deleter, const BufferOptions  &options = BufferOptions{}) noexcept -> AlignedBuffer;
+
+        auto data() noexcept -> pointer;
+        auto data() const noexcept -> const_pointer;
+        auto size() const noexcept -> size_type;
+        auto capacity() const noexcept -> size_type;
+        auto empty() const noexcept -> bool;
+        //Actual alignment of the allocation
+        auto alignment() const noexcept -> size_type;
+        auto options() const noexcept -> const BufferOptions&;
+
+        auto begin() noexcept -> iterator;
+        auto end() noexcept -> iterator;
+        auto begin() const noexcept -> const_iterator;
+        auto end() const noexcept -> const_iterator;
+
+        auto operator[](size_type  index) noexcept -> reference;
+        auto operator[](size_type  index) const noexcept -> const_reference;
+
+        //Keeps the contents, grown bytes follow options().zero_fill
+        void resize(size_type  size);
+        void reserve(size_type  capacity);
+        void clear() noexcept;
+        void swap(AlignedBuffer  &other) noexcept;
+
+        private:
+        void allocate(size_type  capacity);
+        void release() noexcept;
+
+        pointer        _data;
+        size_type      _size;
+        size_type      _capacity;
+        size_type      _alignment;
+        BufferOptions  _options;
+        //nullptr for memory allocated by the buffer itself
+        Deleter        _deleter;
+    };
+
+    NIMAGE_EXPORT auto operator==(const AlignedBuffer  &lhs, const AlignedBuffer  &rhs) noexcept -> bool;
+    NIMAGE_EXPORT auto operator!=(const AlignedBuffer  &lhs, const AlignedBuffer  &rhs) noexcept -> bool;
+
+    inline void swap(AlignedBuffer  &lhs, AlignedBuffer  &rhs) noexcept
+    {
+        lhs.swap(rhs);
+    }
+} // namespace nitros::utils
+
+#endif
@@ -4,19 +4,261 @@
 #define IMAGE_FILEIO_HPP
 
 #include "image.hpp"
+#include "image/image_view.hpp"
+#include "image/mapped_buffer.hpp"
 #include "image/image_export.h"
+#include "image/process/thread_pool.hpp"
 #include <gsl/span>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
 
 namespace nitros::utils
 {
     namespace image
     {
+        enum class FileFormat {
+            unknown, png, jpg, bmp, gif, tga, psd, hdr, pic, pnm, qoi, raw
+        };
+
+        struct ImageInfo
+        {
+            ImgSize        size;
+            std::uint32_t  channels;    //As stored in the file, 2 is grey with alpha
+            std::uint32_t  bit_depth;   //Bits per channel, 8 or 16
+            pixel::Format  format;      //What decoding with default DecodeOptions returns
+            FileFormat     file_format;
+        };
+
+        /**
+         * Parses only the header, no pixel data is decoded and nothing is allocated for it
+         * @throws std::runtime_error if the header is not recognized
+         * @throws std::length_error if data is 2 GiB or larger, stb takes the length of memory as int
+         * */
+        NIMAGE_EXPORT auto probe_image(const std::string& full_source_path) -> ImageInfo;
+        NIMAGE_EXPORT auto probe_image(const gsl::span<std::uint8_t>  &data) -> ImageInfo;
+
+        struct DecodeOptions
+        {
+            /**
+             * Format of the decoded image, unset keeps the channel count and bit depth of the file
+             * (GREY8, GREY16, RGB8, RGB16, RGBA8 or RGBA16, grey with alpha decodes to RGBA).
+             * Grey, RGB and BGR targets of 8 or 16 bits are produced by the decoder itself,
+             * any other target is converted from the decoded 8 bit RGB(A) pixels.
+             * */
+            std::optional<pixel::Format>  format;
+
+            //Checked against the header before decoding, 0 is unlimited
+            std::size_t  max_pixels = 0;
+            //Of the image buffers decoding allocates: the full resolution decoder output, plus the preview and converted copies if any
+            std::size_t  max_bytes  = 0;
+
+            /**
+             * Reduced resolution decode for previews, each side becomes ceil(side / scale_denominator).
+             * scale_denominator is 1, 2, 4 or 8. A non zero max_dimension instead picks the smallest
+             * of these reductions that fits both sides into it, or 8 if none does.
+             * stb cannot decode at a reduced size, the preview is box filtered from the full resolution
+             * image, so a preview costs a full resolution decode. Decoding with a DecodeScratch keeps that
+             * memory for the next preview
+             * */
+            std::uint32_t  scale_denominator = 1;
+            std::size_t    max_dimension     = 0;
+        };
+
+        //Always decode to RGBA8
         NIMAGE_EXPORT ImageCpu read_image(const std::string& full_source_path);
         NIMAGE_EXPORT ImageCpu decode_image(const gsl::span<std::uint8_t>  &data);
 
-        NIMAGE_EXPORT void write_image_png(const std::string& full_target_path, const ImageCpu& source_image);
-        NIMAGE_EXPORT void write_image_jpg(const std::string& full_target_path, const ImageCpu& source_image);
-        NIMAGE_EXPORT void write_image_bmp(const std::string& full_target_path, const ImageCpu& source_image);
+        /**
+         * @throws std::invalid_argument if options.format cannot be converted to or scale_denominator is invalid
+         * @throws std::length_error if the image exceeds options.max_pixels or options.max_bytes, or data is 2 GiB or larger
+         * @throws std::runtime_error if the data cannot be decoded
+         * */
+        NIMAGE_EXPORT ImageCpu read_image(const std::string& full_source_path, const DecodeOptions& options);
+        NIMAGE_EXPORT ImageCpu decode_image(const gsl::span<std::uint8_t>  &data, const DecodeOptions& options);
+
+        /**
+         * Decodes into an existing image or region in its format, reusing its memory.
+         * @throws std::invalid_argument if the size differs or the format cannot be decoded to, the target is left untouched
+         * @throws std::runtime_error if the data cannot be decoded
+         * */
+        NIMAGE_EXPORT void read_image(const std::string& full_source_path, const ImageView& target_image);
+        NIMAGE_EXPORT void decode_image(const gsl::span<std::uint8_t>  &data, const ImageView& target_image);
+        NIMAGE_EXPORT void read_image(const std::string& full_source_path, ImageCpu& target_image);
+        NIMAGE_EXPORT void decode_image(const gsl::span<std::uint8_t>  &data, ImageCpu& target_image);
+
+        class DecodeScratch;
+
+        /**
+         * Decodes into an existing image or region like the overloads above, decoder memory is taken from and
+         * returned to scratch, so decoding a stream of same sized frames stops allocating after the first
+         * */
+        NIMAGE_EXPORT void read_image(const std::string& full_source_path, const ImageView& target_image, DecodeScratch& scratch);
+        NIMAGE_EXPORT void decode_image(const gsl::span<std::uint8_t>  &data, const ImageView& target_image, DecodeScratch& scratch);
+
+        /**
+         * Decodes like the overloads taking options, decoder memory is taken from and returned to scratch.
+         * Previews of same sized images reuse the full resolution memory they are reduced from,
+         * a full resolution decode keeps the block it was decoded to and takes it out of the scratch
+         * */
+        NIMAGE_EXPORT ImageCpu read_image(const std::string& full_source_path, const DecodeOptions& options, DecodeScratch& scratch);
+        NIMAGE_EXPORT ImageCpu decode_image(const gsl::span<std::uint8_t>  &data, const DecodeOptions& options, DecodeScratch& scratch);
+
+        /**
+         * Decoder memory owned by the caller and kept between decodes.
+         * Only the decodes it is passed to use it, memory a decoded image keeps is no longer the scratch's.
+         * Move only, not thread safe, give every decoding thread its own
+         * */
+        class NIMAGE_EXPORT DecodeScratch final
+        {
+            struct State;
+
+            public:
+            //@param max_bytes retained at most, blocks beyond it are freed when the decoder returns them
+            explicit DecodeScratch(std::size_t  max_bytes = 64 * 1024 * 1024);
+            DecodeScratch(const DecodeScratch&) = delete;
+            DecodeScratch(DecodeScratch&&) noexcept;
+            ~DecodeScratch();
+
+            auto operator=(const DecodeScratch&) -> DecodeScratch& = delete;
+            auto operator=(DecodeScratch&&) noexcept -> DecodeScratch&;
+
+            auto max_bytes() const noexcept -> std::size_t;
+            //Memory held for the next decode
+            auto retained_bytes() const noexcept -> std::size_t;
+            //Frees the retained memory, the scratch stays usable
+            void release() noexcept;
+
+            private:
+            friend void read_image(const std::string& full_source_path, const ImageView& target_image, DecodeScratch& scratch);
+            friend void decode_image(const gsl::span<std::uint8_t>  &data, const ImageView& target_image, DecodeScratch& scratch);
+            friend ImageCpu read_image(const std::string& full_source_path, const DecodeOptions& options, DecodeScratch& scratch);
+            friend ImageCpu decode_image(const gsl::span<std::uint8_t>  &data, const DecodeOptions& options, DecodeScratch& scratch);
+
+            std::unique_ptr<State>  _state;
+        };
+
+        //Row filter of PNG scanlines, adaptive tries all per row and keeps the smallest
+        enum class PngFilter {
+            adaptive = -1, none = 0, sub = 1, up = 2, average = 3, paeth = 4
+        };
+
+        struct EncodeOptions
+        {
+            int        jpg_quality     = 100;   //1 to 100
+            int        png_compression = 8;     //zlib level 0 to 9, lower is faster and larger
+            PngFilter  png_filter      = PngFilter::adaptive;
+        };
+
+        //Receives the encoded bytes in order, possibly over several calls
+        using EncodeSink = std::function<void(const std::uint8_t  *data, std::size_t  size)>;
+
+        /**
+         * Encoders take views of 1 to 4 interleaved 8 bit channels (grey, grey alpha, rgb, rgba),
+         * so a region of an image is encoded without copying it out first
+         * @throws std::invalid_argument for other formats
+         * @throws std::runtime_error if encoding or writing fails
+         * */
+        NIMAGE_EXPORT void encode_png(const ConstImageView& source_image, const EncodeSink& sink, const EncodeOptions& options = {});
+        NIMAGE_EXPORT void encode_jpg(const ConstImageView& source_image, const EncodeSink& sink, const EncodeOptions& options = {});
+        NIMAGE_EXPORT void encode_bmp(const ConstImageView& source_image, const EncodeSink& sink);
+
+        NIMAGE_EXPORT auto encode_png(const ConstImageView& source_image, const EncodeOptions& options = {}) -> std::vector<std::uint8_t>;
+        NIMAGE_EXPORT auto encode_jpg(const ConstImageView& source_image, const EncodeOptions& options = {}) -> std::vector<std::uint8_t>;
+        NIMAGE_EXPORT auto encode_bmp(const ConstImageView& source_image) -> std::vector<std::uint8_t>;
+
+        NIMAGE_EXPORT void write_image_png(const std::string& full_target_path, const ConstImageView& source_image, const EncodeOptions& options = {});
+        NIMAGE_EXPORT void write_image_jpg(const std::string& full_target_path, const ConstImageView& source_image, const EncodeOptions& options = {});
+        NIMAGE_EXPORT void write_image_bmp(const std::string& full_target_path, const ConstImageView& source_image);
+
+        /**
+         * Lossless QOI codec for RGB8 and RGBA8, rows are encoded and decoded in place through their steps
+         * and the sink receives the file one row at a time
+         * @throws std::invalid_argument for other formats, empty images or a target of another size
+         * @throws std::runtime_error for malformed or truncated data and I/O failures
+         * */
+        NIMAGE_EXPORT void encode_qoi(const ConstImageView& source_image, const EncodeSink& sink);
+        NIMAGE_EXPORT auto encode_qoi(const ConstImageView& source_image) -> std::vector<std::uint8_t>;
+        NIMAGE_EXPORT void write_image_qoi(const std::string& full_target_path, const ConstImageView& source_image);
+
+        //A 3 channel file decodes into an RGBA8 target with opaque alpha, a 4 channel one into RGB8 drops alpha
+        NIMAGE_EXPORT auto decode_qoi(const gsl::span<const std::uint8_t>& data) -> ImageCpu;
+        NIMAGE_EXPORT void decode_qoi(const gsl::span<const std::uint8_t>& data, const ImageView& target_image);
+        NIMAGE_EXPORT auto read_image_qoi(const std::string& full_source_path) -> ImageCpu;
+
+        /**
+         * Binary Netpbm, GREY is written as PGM (P5), RGB as PPM (P6) and RGBA as PAM (P7), each with 8 or 16 bit samples.
+         * Readers take all three, samples above 8 bits are big endian in the file and byte swapped with SIMD.
+         * A maxval other than 255 or 65535 (e.g. 1023 or 4095 of 10 and 12 bit sensors) is rescaled to the full range.
+         * Rows go between image and file without packing, so padded rows and regions are not copied first
+         * @throws std::invalid_argument for other formats or a target of another size or format
+         * @throws std::runtime_error for malformed or truncated data and I/O failures
+         * */
+        NIMAGE_EXPORT void encode_pnm(const ConstImageView& source_image, const EncodeSink& sink);
+        NIMAGE_EXPORT auto encode_pnm(const ConstImageView& source_image) -> std::vector<std::uint8_t>;
+        NIMAGE_EXPORT void write_image_pnm(const std::string& full_target_path, const ConstImageView& source_image);
+
+        NIMAGE_EXPORT auto decode_pnm(const gsl::span<const std::uint8_t>& data) -> ImageCpu;
+        NIMAGE_EXPORT void decode_pnm(const gsl::span<const std::uint8_t>& data, const ImageView& target_image);
+        NIMAGE_EXPORT auto read_image_pnm(const std::string& full_source_path) -> ImageCpu;
+
+        /**
+         * Native raw container, a fixed header with the ImageMetaData followed by the planes at a page
+         * aligned offset in the create_cpu buffer layout. No encoding, opening maps the planes in place.
+         * Files are read back in the predefined formats of pixel.hpp only, the header is not trusted with another layout
+         * @throws std::runtime_error for a damaged or truncated file
+         * @throws std::system_error if the file cannot be created or mapped
+         * */
+        NIMAGE_EXPORT void write_image_raw(const std::string& full_target_path, const ConstImageView& source_image);
+        NIMAGE_EXPORT auto open_image_raw(const std::string& full_source_path, MapMode mode = MapMode::read_only) -> ImageMapped;
+        //Copies the planes into an ImageCpu with one read
+        NIMAGE_EXPORT auto read_image_raw(const std::string& full_source_path) -> ImageCpu;
+
+        //Called on a worker thread once per item, result is null and error is set if the item failed
+        using DecodeCallback = std::function<void(std::size_t index, ImageCpu *image, std::exception_ptr error)>;
+        using EncodeCallback = std::function<void(std::size_t index, std::vector<std::uint8_t> *encoded, std::exception_ptr error)>;
+
+        /**
+         * Batch decode on a thread pool, one future per item in input order.
+         * At most max_parallel items (0 is one per worker) are decoded at a time and the batch takes that many
+         * queue slots, other work on the pool keeps running in between.
+         * The encoded buffers must stay valid until their futures are ready, the span of them is copied.
+         * QOI and Netpbm items go to decode_qoi and decode_pnm, the others to stb with decoder memory from a
+         * scratch per running task, kept until the batch is done. Options apply to every format, Netpbm
+         * items reach a requested format of other channels only where a converter takes them there.
+         * A failed item rethrows from its own future, the other items are not affected
+         * */
+        NIMAGE_EXPORT auto decode_images(const gsl::span<const gsl::span<std::uint8_t>>& data, nitros::image::ThreadPool& pool,
+                                         const DecodeOptions& options = {}, std::size_t max_parallel = 0) -> std::vector<std::future<ImageCpu>>;
+        NIMAGE_EXPORT auto read_images(const gsl::span<const std::string>& full_source_paths, nitros::image::ThreadPool& pool,
+                                       const DecodeOptions& options = {}, std::size_t max_parallel = 0) -> std::vector<std::future<ImageCpu>>;
+
+        //Hands each image to callback as soon as it is decoded, the future is ready after the last callback returned
+        NIMAGE_EXPORT auto decode_images(const gsl::span<const gsl::span<std::uint8_t>>& data, nitros::image::ThreadPool& pool, const DecodeCallback& callback,
+                                         const DecodeOptions& options = {}, std::size_t max_parallel = 0) -> std::future<void>;
+        NIMAGE_EXPORT auto read_images(const gsl::span<const std::string>& full_source_paths, nitros::image::ThreadPool& pool, const DecodeCallback& callback,
+                                       const DecodeOptions& options = {}, std::size_t max_parallel = 0) -> std::future<void>;
+
+        /**
+         * Batch encode to png, jpg, bmp, qoi or pnm with the same scheduling as decode_images.
+         * The images viewed must stay valid until the futures are ready.
+         * PNG encodes with options other than the defaults share the stb settings and run one at a time
+         * @throws std::invalid_argument for other file formats, before anything is queued
+         * */
+        NIMAGE_EXPORT auto encode_images(const gsl::span<const ConstImageView>& source_images, FileFormat file_format, nitros::image::ThreadPool& pool,
+                                         const EncodeOptions& options = {}, std::size_t max_parallel = 0) -> std::vector<std::future<std::vector<std::uint8_t>>>;
+        NIMAGE_EXPORT auto encode_images(const gsl::span<const ConstImageView>& source_images, FileFormat file_format, nitros::image::ThreadPool& pool,
+                                         const EncodeCallback& callback, const EncodeOptions& options = {}, std::size_t max_parallel = 0) -> std::future<void>;
+        //@throws std::invalid_argument also if the number of paths and images differ
+        NIMAGE_EXPORT auto write_images(const gsl::span<const ConstImageView>& source_images, const gsl::span<const std::string>& full_target_paths,
+                                        FileFormat file_format, nitros::image::ThreadPool& pool,
+                                        const EncodeOptions& options = {}, std::size_t max_parallel = 0) -> std::vector<std::future<void>>;
     }
 
 }
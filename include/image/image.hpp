@@ -4,6 +4,7 @@
 #define NITROS_UITLS_IMAGE_HPP
 
 #include "pixel.hpp"
+#include "image/buffer.hpp"
 #include "image/image_export.h"
 #include <gsl/gsl>
 #include <vector>
@@ -66,7 +67,7 @@ namespace nitros::utils
         ImageMetaData       _metaData;
     };
 
-    using ImgBufferCpu = std::vector<std::uint8_t>;
+    using ImgBufferCpu = AlignedBuffer;
     using ImageCpu = Image<ImgBufferCpu>;
 
     namespace   image
@@ -76,9 +77,16 @@ namespace nitros::utils
          * */
         NIMAGE_EXPORT auto memory_aligned_step(const std::size_t  &line_step_bits, std::uint32_t  row_alignment_bits) -> std::size_t;
 
+        /**
+         * @returns bytes needed for all planes of the image
+         * */
+        inline auto buffer_size(const ImageMetaData  &meta_data) -> std::size_t;
+
         template<typename Image>
         Image  create(ImgSize size, pixel::Format  format);
         NIMAGE_EXPORT ImageCpu create_cpu(ImgSize size, pixel::Format format);
+        //Buffer contents are uninitialized unless options.zero_fill is set
+        NIMAGE_EXPORT ImageCpu create_cpu(ImgSize size, pixel::Format format, const BufferOptions  &options);
 
         NIMAGE_EXPORT void assign(ImgSize img_size, size_t src_step, const gsl::span<uint8_t> src_ptr, size_t dest_step, gsl::span<uint8_t>  dest_ptr);
     }
@@ -42,20 +42,24 @@ namespace nitros::utils
     
     namespace image
     {
-        template<typename Image>
-        Image  create(ImgSize size, pixel::Format  format)
+        inline auto buffer_size(const ImageMetaData  &meta_data) -> std::size_t
         {
-            ImageMetaData   metaData{size, format};
-            auto s_it = metaData.steps.begin();
-            auto plane_it = metaData.format.planes.begin();
+            auto s_it = meta_data.steps.begin();
+            auto plane_it = meta_data.format.planes.begin();
 
             auto buf_size = std::size_t{};
-            for( ; s_it != metaData.steps.end() ; s_it++, plane_it++) 
+            for( ; s_it != meta_data.steps.end() ; s_it++, plane_it++) 
             {
-                buf_size += (*s_it) * (size.height * plane_it->height_factor.num / plane_it->height_factor.den);
+                buf_size += (*s_it) * (meta_data.size.height * plane_it->height_factor.num / plane_it->height_factor.den);
             }
+            return buf_size;
+        }
 
-            typename Image::buffer_type   buffer( buf_size );
+        template<typename Image>
+        Image  create(ImgSize size, pixel::Format  format)
+        {
+            ImageMetaData   metaData{size, format};
+            typename Image::buffer_type   buffer( buffer_size(metaData) );
             return Image{std::move(metaData), std::move(buffer)};
         }
 
@@ -63,6 +67,13 @@ namespace nitros::utils
         {
             return create<ImageCpu>(size, format);
         }
+
+        inline ImageCpu create_cpu(ImgSize size, pixel::Format format, const BufferOptions  &options)
+        {
+            ImageMetaData   metaData{size, format};
+            auto buffer = ImgBufferCpu( buffer_size(metaData), options );
+            return ImageCpu{std::move(metaData), std::move(buffer)};
+        }
     }
     
 }
\ No newline at end of file
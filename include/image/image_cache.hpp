@@ -0,0 +1,87 @@
+#ifndef NITROS_IMAGE_IMAGE_CACHE_HPP
+#define NITROS_IMAGE_IMAGE_CACHE_HPP
+
+#include "image/fileio.hpp"
+#include "image/image.hpp"
+#include "image/image_export.h"
+#include <gsl/gsl>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+
+namespace nitros::utils::image
+{
+    struct ImageCacheStats
+    {
+        //Lookups served by a cached image, or by a decode another thread had in flight
+        std::size_t  hits;
+        //Lookups that decoded
+        std::size_t  misses;
+        //Hits that waited on a decode in flight instead of decoding again
+        std::size_t  waits;
+        //Images dropped to stay within the byte budget
+        std::size_t  evictions;
+        std::size_t  resident_images;
+        std::size_t  resident_bytes;
+    };
+
+    /**
+     * Keeps decoded images for reuse, e.g. assets a renderer draws every frame.
+     * Images are shared and immutable, handles stay valid after eviction and after the cache is gone.
+     * Least recently used images are evicted past the byte budget, an image larger than the budget is
+     * returned but not kept. Failed decodes are not cached, the next lookup tries again.
+     * Thread safe, concurrent misses on one key decode once and the other lookups wait for that result
+     * */
+    class NIMAGE_EXPORT ImageCache final
+    {
+        struct State;
+
+        public:
+        using Handle = std::shared_ptr<const ImageCpu>;
+
+        /**
+         * @param max_bytes budget for the buffers of cached images
+         * @param options used for every decode, cache separately for different options
+         * */
+        explicit ImageCache(std::size_t  max_bytes = 256 * 1024 * 1024, const DecodeOptions  &options = DecodeOptions{});
+        ImageCache(const ImageCache&) = delete;
+        ImageCache(ImageCache&&) noexcept;
+        ~ImageCache();
+
+        auto operator=(const ImageCache&) -> ImageCache& = delete;
+        auto operator=(ImageCache&&) noexcept -> ImageCache&;
+
+        /**
+         * read_image keyed by path, modification time and file size, a changed file is decoded again
+         * @throws std::runtime_error if the file does not exist or cannot be decoded, and what read_image throws
+         * */
+        auto read(const std::string  &full_source_path) -> Handle;
+
+        /**
+         * decode_image keyed by a 64 bit hash of the data and its size. The hash is not cryptographic,
+         * do not mix trusted and untrusted data in one cache
+         * @throws what decode_image throws
+         * */
+        auto decode(const gsl::span<std::uint8_t>  &data) -> Handle;
+
+        //Calls load on a miss, for images from other sources. Keys never match the ones of read() and decode()
+        auto get(const std::string  &key, const std::function<ImageCpu()>  &load) -> Handle;
+
+        auto stats() const -> ImageCacheStats;
+        auto max_bytes() const -> std::size_t;
+        //Evicts least recently used images until the new budget holds
+        void set_max_bytes(std::size_t  bytes);
+        //Drops all cached images, decodes in flight still complete for their waiters
+        void clear();
+
+        private:
+        std::unique_ptr<State>  _state;
+    };
+
+    //Hash of data for keying, 64 bit words folded with multiply and rotate, not cryptographic
+    NIMAGE_EXPORT auto content_hash(const gsl::span<const std::uint8_t>  &data) noexcept -> std::uint64_t;
+} // namespace nitros::utils::image
+
+#endif
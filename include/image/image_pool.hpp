@@ -0,0 +1,76 @@
+#ifndef NITROS_IMAGE_IMAGE_POOL_HPP
+#define NITROS_IMAGE_IMAGE_POOL_HPP
+
+#include "image/image.hpp"
+#include "image/image_export.h"
+#include <cstddef>
+#include <memory>
+
+namespace nitros::utils
+{
+    struct ImagePoolStats
+    {
+        //acquire() calls served from retained images
+        std::size_t  hits;
+        //acquire() calls that had to allocate
+        std::size_t  misses;
+        //Released images freed instead of retained, because of the byte cap
+        std::size_t  dropped;
+        std::size_t  retained_images;
+        std::size_t  retained_bytes;
+    };
+
+    /**
+     * Recycles images of the same size and format, e.g. one per video frame
+     * Images go back to the pool when their handle is destroyed, handles may outlive the pool
+     * Thread safe
+     * */
+    class NIMAGE_EXPORT ImagePool final
+    {
+        struct State;
+
+        public:
+        //Returns the image to its pool, or frees it once the pool is gone
+        struct NIMAGE_EXPORT Recycler
+        {
+            void operator()(ImageCpu  *ptr) const noexcept;
+
+            std::weak_ptr<State>  state;
+        };
+
+        using Handle = std::unique_ptr<ImageCpu, Recycler>;
+
+        /**
+         * @param max_retained_bytes cap on buffer bytes kept for reuse, released images beyond it are freed
+         * @param options used for every buffer the pool allocates
+         * */
+        explicit ImagePool(std::size_t  max_retained_bytes = 256 * 1024 * 1024, const BufferOptions  &options = BufferOptions{});
+        ImagePool(const ImagePool&) = delete;
+        ImagePool(ImagePool&&) noexcept = default;
+        ~ImagePool();
+
+        auto operator=(const ImagePool&) -> ImagePool& = delete;
+        auto operator=(ImagePool&&) noexcept -> ImagePool& = default;
+
+        /**
+         * @returns an image of the given size and format, the contents are unspecified (last frame or uninitialized)
+         * Handles are move only, a shared owner can be made with std::shared_ptr<ImageCpu>{std::move(handle)}
+         * */
+        auto acquire(ImgSize  size, const pixel::Format  &format) -> Handle;
+
+        //Allocates images up front so the first count acquire() calls hit, limited by the byte cap
+        void reserve(ImgSize  size, const pixel::Format  &format, std::size_t  count);
+
+        auto stats() const -> ImagePoolStats;
+        auto max_retained_bytes() const -> std::size_t;
+        //Frees retained images until the new cap holds
+        void set_max_retained_bytes(std::size_t  bytes);
+        //Frees all retained images, images in use still return to the pool
+        void clear();
+
+        private:
+        std::shared_ptr<State>  _state;
+    };
+} // namespace nitros::utils
+
+#endif
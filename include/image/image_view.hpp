@@ -0,0 +1,83 @@
+#ifndef NITROS_IMAGE_IMAGE_VIEW_HPP
+#define NITROS_IMAGE_IMAGE_VIEW_HPP
+
+#include "image/image.hpp"
+#include "image/utils.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace nitros::utils
+{
+    /**
+     * Non owning view of an image: meta data plus the start address of every Plane.
+     * Rows of Plane i are meta_data().steps[i] bytes apart, so a view may cover a region of a larger image.
+     *
+     * byte_type_ is const std::uint8_t for read only access
+     * */
+    template <typename byte_type_>
+    class BasicImageView
+    {
+        public:
+        using byte_type = byte_type_;
+        using Planes_t  = FixedSizeVec<byte_type_*, 5>;
+
+        /**
+         * @param planes start address of each Plane, one per meta_data.steps entry
+         * */
+        BasicImageView(const ImageMetaData  &meta_data, const Planes_t  &planes) noexcept;
+        //Views the whole image of any buffer type, the image must outlive the view
+        template <typename buffer_type_>
+        BasicImageView(Image<buffer_type_>  &image) noexcept;
+        template <typename buffer_type_, typename B = byte_type_, typename = std::enable_if_t<std::is_const_v<B>>>
+        BasicImageView(const Image<buffer_type_>  &image) noexcept;
+        //Mutable views convert to read only views
+        template <typename other_, typename = std::enable_if_t<std::is_const_v<byte_type_> && !std::is_const_v<other_>>>
+        BasicImageView(const BasicImageView<other_>  &view) noexcept;
+
+        auto meta_data() const noexcept -> const ImageMetaData&;
+        auto size() const noexcept -> ImgSize;
+
+        auto plane(std::size_t  index) const noexcept -> byte_type_*;
+        auto planes() const noexcept -> const Planes_t&;
+        /**
+         * @param plane_row row of the Plane (interpreted)
+         * */
+        auto row(std::size_t  plane_row, std::size_t  index = 0) const noexcept -> byte_type_*;
+
+        private:
+        template <typename buffer_type_>
+        void view_planes(const Image<buffer_type_>  &image) noexcept;
+
+        ImageMetaData  _meta_data;
+        Planes_t       _planes;
+    };
+
+    using ImageView      = BasicImageView<std::uint8_t>;
+    using ConstImageView = BasicImageView<const std::uint8_t>;
+
+    namespace image
+    {
+        template <typename buffer_type_>
+        auto view(Image<buffer_type_>  &image) noexcept -> ImageView;
+        template <typename buffer_type_>
+        auto view(const Image<buffer_type_>  &image) noexcept -> ConstImageView;
+
+        /**
+         * Region origins must be multiples of this, so every Plane starts on a whole (subsampled) byte aligned pixel
+         * e.g. {2, 2} for YUV420p, {2, 1} for YUV422p, {1, 1} for RGBA8
+         * */
+        inline auto roi_alignment(const pixel::Format  &format) -> ImgSize;
+
+        /**
+         * Zero copy sub view of the region starting at (x, y), chroma Planes are offset by their subsampling
+         * @throws std::invalid_argument if the region is not inside the view or (x, y) is not a multiple of roi_alignment
+         * */
+        template <typename byte_type_>
+        auto roi(const BasicImageView<byte_type_>  &view, std::size_t  x, std::size_t  y, ImgSize  size) -> BasicImageView<byte_type_>;
+    }
+} // namespace nitros::utils
+
+#include "image_view.inl"
+
+#endif
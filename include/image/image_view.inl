@@ -0,0 +1,152 @@
+#include "image_view.hpp"
+#include <numeric>
+#include <stdexcept>
+
+namespace nitros::utils
+{
+    template <typename byte_type_>
+    BasicImageView<byte_type_>::BasicImageView(const ImageMetaData  &meta_data, const Planes_t  &planes) noexcept
+        :_meta_data{meta_data}
+        ,_planes{planes}
+    {}
+
+    template <typename byte_type_>
+    template <typename buffer_type_>
+    BasicImageView<byte_type_>::BasicImageView(Image<buffer_type_>  &image) noexcept
+        :_meta_data{image.meta_data()}
+        ,_planes{}
+    {
+        view_planes(image);
+    }
+
+    template <typename byte_type_>
+    template <typename buffer_type_, typename B, typename>
+    BasicImageView<byte_type_>::BasicImageView(const Image<buffer_type_>  &image) noexcept
+        :_meta_data{image.meta_data()}
+        ,_planes{}
+    {
+        view_planes(image);
+    }
+
+    template <typename byte_type_>
+    template <typename buffer_type_>
+    void BasicImageView<byte_type_>::view_planes(const Image<buffer_type_>  &image) noexcept
+    {
+        auto data = const_cast<byte_type_*>( reinterpret_cast<const std::uint8_t*>(image.buffer().data()) );
+        for(auto i = std::size_t{0}; i < image.meta_data().steps.size(); i++) {
+            _planes.push_back( data + plane_offset(image.meta_data(), i) );
+        }
+    }
+
+    template <typename byte_type_>
+    template <typename other_, typename>
+    BasicImageView<byte_type_>::BasicImageView(const BasicImageView<other_>  &view) noexcept
+        :_meta_data{view.meta_data()}
+        ,_planes{}
+    {
+        for(auto plane : view.planes()) {
+            _planes.push_back(plane);
+        }
+    }
+
+    template <typename byte_type_>
+    auto BasicImageView<byte_type_>::meta_data() const noexcept -> const ImageMetaData&
+    {
+        return _meta_data;
+    }
+
+    template <typename byte_type_>
+    auto BasicImageView<byte_type_>::size() const noexcept -> ImgSize
+    {
+        return _meta_data.size;
+    }
+
+    template <typename byte_type_>
+    auto BasicImageView<byte_type_>::plane(std::size_t  index) const noexcept -> byte_type_*
+    {
+        return _planes[index];
+    }
+
+    template <typename byte_type_>
+    auto BasicImageView<byte_type_>::planes() const noexcept -> const Planes_t&
+    {
+        return _planes;
+    }
+
+    template <typename byte_type_>
+    auto BasicImageView<byte_type_>::row(std::size_t  plane_row, std::size_t  index) const noexcept -> byte_type_*
+    {
+        return _planes[index] + plane_row * _meta_data.steps[index];
+    }
+
+    namespace image
+    {
+        template <typename buffer_type_>
+        auto view(Image<buffer_type_>  &image) noexcept -> ImageView
+        {
+            return ImageView{image};
+        }
+
+        template <typename buffer_type_>
+        auto view(const Image<buffer_type_>  &image) noexcept -> ConstImageView
+        {
+            return ConstImageView{image};
+        }
+
+        inline auto roi_alignment(const pixel::Format  &format) -> ImgSize
+        {
+            if(!format.planar_info.is_planar) {
+                return {format.pixel_layout.group_pixels, 1};
+            }
+
+            auto alignment = ImgSize{1, 1};
+            auto locations = channel_locations(format);
+            for(auto &loc : locations)
+            {
+                auto &plane = format.planes[loc.plane];
+                //x / den Plane pixels of pixel_bits * num bits must end on a byte
+                auto x = std::size_t{plane.width_factor.den} * (8 / std::gcd<std::size_t>(std::size_t{plane.width_factor.num} * loc.pixel_bits, 8));
+                alignment.width  = std::lcm(alignment.width, x);
+                alignment.height = std::lcm<std::size_t>(alignment.height, plane.height_factor.den);
+            }
+            return alignment;
+        }
+
+        template <typename byte_type_>
+        auto roi(const BasicImageView<byte_type_>  &view, std::size_t  x, std::size_t  y, ImgSize  size) -> BasicImageView<byte_type_>
+        {
+            auto &meta = view.meta_data();
+            if(x + size.width > meta.size.width || y + size.height > meta.size.height) {
+                throw std::invalid_argument("Region outside of the Image");
+            }
+
+            auto alignment = roi_alignment(meta.format);
+            if(x % alignment.width != 0 || y % alignment.height != 0) {
+                throw std::invalid_argument("Region origin not aligned to the Plane subsampling");
+            }
+
+            auto roi_meta = meta;
+            roi_meta.size = size;
+
+            auto planes = typename BasicImageView<byte_type_>::Planes_t{};
+            if(!meta.format.planar_info.is_planar)
+            {
+                auto x_bytes = x * meta.format.pixel_layout.bytes / meta.format.pixel_layout.group_pixels;
+                planes.push_back( view.row(y, 0) + x_bytes );
+            }
+            else
+            {
+                auto locations = channel_locations(meta.format);
+                for(auto i = std::size_t{0}; i < meta.format.planes.size(); i++)
+                {
+                    auto &plane = meta.format.planes[i];
+                    auto it = std::find_if(locations.begin(), locations.end(), [i](const ChannelLocation  &loc) { return loc.plane == i; });
+                    auto px = x * plane.width_factor.num / plane.width_factor.den;
+                    auto py = y * plane.height_factor.num / plane.height_factor.den;
+                    planes.push_back( view.row(py, i) + px * it->pixel_bits / 8 );
+                }
+            }
+            return BasicImageView<byte_type_>{roi_meta, planes};
+        }
+    }
+} // namespace nitros::utils
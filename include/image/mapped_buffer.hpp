@@ -0,0 +1,110 @@
+#ifndef NITROS_IMAGE_MAPPED_BUFFER_HPP
+#define NITROS_IMAGE_MAPPED_BUFFER_HPP
+
+#include "image/image.hpp"
+#include "image/image_export.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace nitros::utils
+{
+    enum class MapMode {
+        read_only,
+        read_write,     //Writes go to the file and are shared with other processes mapping it
+        copy_on_write   //Writes stay private to this mapping
+    };
+
+    /**
+     * Image buffer backed by a memory mapped file.
+     * Pages are read in lazily on first access and shared through the page cache between processes.
+     * Move only, the mapping is released on destruction. Writing to a read_only mapping crashes.
+     * */
+    class NIMAGE_EXPORT MappedBuffer final
+    {
+        public:
+        using value_type      = std::uint8_t;
+        using size_type       = std::size_t;
+        using pointer         = std::uint8_t*;
+        using const_pointer   = const std::uint8_t*;
+        using reference       = std::uint8_t&;
+        using const_reference = const std::uint8_t&;
+        using iterator        = std::uint8_t*;
+        using const_iterator  = const std::uint8_t*;
+
+        MappedBuffer() noexcept;
+        /**
+         * Maps size bytes of an existing file starting at offset, offset needs no alignment
+         * @param size 0 maps up to the end of the file
+         * @throws std::system_error if the file cannot be opened or mapped
+         * @throws std::invalid_argument if the range goes past the end of the file
+         * */
+        MappedBuffer(const std::string  &path, MapMode  mode, size_type  offset = 0, size_type  size = 0);
+        MappedBuffer(const MappedBuffer&) = delete;
+        MappedBuffer(MappedBuffer  &&other) noexcept;
+        ~MappedBuffer();
+
+        auto operator=(const MappedBuffer&) -> MappedBuffer& = delete;
+        auto operator=(MappedBuffer  &&other) noexcept -> MappedBuffer&;
+
+        /**
+         * Creates (or truncates) the file with size bytes and maps it read_write
+         * @throws std::system_error if the file cannot be created or mapped
+         * */
+        static auto create(const std::string  &path, size_type  size) -> MappedBuffer;
+
+        auto data() noexcept -> pointer;
+        auto data() const noexcept -> const_pointer;
+        auto size() const noexcept -> size_type;
+        auto empty() const noexcept -> bool;
+        auto mode() const noexcept -> MapMode;
+
+        auto begin() noexcept -> iterator;
+        auto end() noexcept -> iterator;
+        auto begin() const noexcept -> const_iterator;
+        auto end() const noexcept -> const_iterator;
+
+        auto operator[](size_type  index) noexcept -> reference;
+        auto operator[](size_type  index) const noexcept -> const_reference;
+
+        /**
+         * Writes modified pages of a read_write mapping back to the file and waits for it
+         * @throws std::system_error on failure
+         * */
+        void flush();
+        void swap(MappedBuffer  &other) noexcept;
+
+        private:
+        void unmap() noexcept;
+
+        pointer    _data;
+        size_type  _size;
+        //The mapping starts on a page boundary at or before _data
+        void*      _map;
+        size_type  _map_size;
+        MapMode    _mode;
+    };
+
+    inline void swap(MappedBuffer  &lhs, MappedBuffer  &rhs) noexcept
+    {
+        lhs.swap(rhs);
+    }
+
+    using ImageMapped = Image<MappedBuffer>;
+
+    namespace image
+    {
+        /**
+         * Lays the planes out in a new file exactly like the buffer of create_cpu, without a header
+         * */
+        NIMAGE_EXPORT auto create_mapped(const std::string  &path, ImgSize  size, pixel::Format  format) -> ImageMapped;
+
+        /**
+         * Maps an image whose planes start at offset of the file, laid out as by create_mapped
+         * @throws std::invalid_argument if the file is smaller than offset + buffer_size(meta_data)
+         * */
+        NIMAGE_EXPORT auto open_mapped(const std::string  &path, const ImageMetaData  &meta_data, MapMode  mode = MapMode::read_only, std::size_t  offset = 0) -> ImageMapped;
+    }
+} // namespace nitros::utils
+
+#endif
@@ -5,6 +5,7 @@
 
 #include "utilities/algorithm.hpp"
 #include "utilities/containers.hpp"
+#include <cstddef>
 #include <cstdint>
 #include <ratio>
 #include <initializer_list>
@@ -114,6 +115,14 @@ namespace nitros::utils
             Array<Plane>  planes;
         };
 
+        //Hashes the fields operator== compares, for unordered containers keyed by Format
+        struct FormatHash
+        {
+            inline auto operator()(const Format  &format) const noexcept -> std::size_t;
+        };
+
+        inline void hash_combine(std::size_t  &seed, std::size_t  value) noexcept;
+
         template <type pix_type_, typename Layout_, typename Planar_, typename ... Plane_>
         struct format_factory {
             static constexpr auto pix_type = pix_type_;
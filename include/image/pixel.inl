@@ -35,5 +35,32 @@ namespace nitros::utils
         inline auto operator==(const Plane  &lhs, const Plane  &rhs) noexcept -> bool {
             return !(lhs < rhs) && !(rhs < lhs);
         }
+
+        inline void hash_combine(std::size_t  &seed, std::size_t  value) noexcept
+        {
+            seed ^= value + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2);
+        }
+
+        inline auto FormatHash::operator()(const Format  &format) const noexcept -> std::size_t
+        {
+            auto seed = std::size_t{0};
+            hash_combine(seed, static_cast<std::size_t>(format.pixel_type));
+            hash_combine(seed, format.pixel_layout.bytes);
+            hash_combine(seed, format.pixel_layout.channels);
+            hash_combine(seed, format.pixel_layout.group_pixels);
+            hash_combine(seed, format.pixel_layout.normalized);
+            hash_combine(seed, format.planar_info.is_planar);
+            for(auto bits : format.planar_info.pixel_bits) {
+                hash_combine(seed, bits);
+            }
+            for(auto &plane : format.planes) {
+                hash_combine(seed, plane.width_factor.num);
+                hash_combine(seed, plane.width_factor.den);
+                hash_combine(seed, plane.height_factor.num);
+                hash_combine(seed, plane.height_factor.den);
+                hash_combine(seed, plane.row_alignment);
+            }
+            return seed;
+        }
     } // namespace pixel
 } // namespace nitros::utils
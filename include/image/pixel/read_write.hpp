@@ -3,7 +3,10 @@
 #ifndef IMAGE_PIXEL_READER_WRITER_HPP
 #define IMAGE_PIXEL_READER_WRITER_HPP
 #include "image/image.hpp"
+#include "image/image_view.hpp"
+#include "image/utils.hpp"
 #include "utilities/data/vecs.hpp"
+#include <gsl/span>
 #include <optional>
 
 namespace nitros::utils
@@ -34,42 +37,70 @@ namespace nitros::utils
         struct Reader
         {
             public:
-            explicit Reader(const ImageCpu  &image) noexcept;
+            explicit Reader(const ConstImageView  &image) noexcept;
 
             [[nodiscard]] auto at(const utils::vec2Ui  &pt) const noexcept -> PixelData<num_type_>;
             [[nodiscard]] auto next() noexcept -> std::optional<PixelData<num_type_>>;
             void reset() noexcept;
 
+            /**
+             * @param y image row (Non interpreted)
+             * @returns pixel bytes of the Plane row covering image row y
+             * */
+            [[nodiscard]] auto row(std::uint32_t  y, std::size_t  plane = 0) const noexcept -> gsl::span<const std::uint8_t>;
+            //pixels should hold atleast image width elements
+            void read_row(std::uint32_t  y, gsl::span<PixelData<num_type_>>  pixels) const noexcept;
+
             private:
+            template<template <typename> typename, typename>
+            friend struct ReaderWrap;
 
             auto at_packed(const utils::vec2Ui  &pt) const noexcept -> PixelData<num_type_>;
             auto at_planar(const utils::vec2Ui  &pt) const noexcept -> PixelData<num_type_>;
             void increment_point() noexcept;
 
-            const ImageCpu&  _image;
+            template <typename Fn>
+            void read_channel(std::size_t  channel, std::uint32_t  y, Fn  &&fn) const noexcept;
+
+            ConstImageView  _image;
             std::uint32_t  _x, _y;
             FixedSizeVec<const std::uint8_t*, 5>  _start_address;
+            FixedSizeVec<ChannelLocation, 5>  _channels;
         };
 
         template<typename num_type_>
         struct Writer
         {
             public:
-            explicit Writer(ImageCpu  &image) noexcept;
+            explicit Writer(const ImageView  &image) noexcept;
 
             void at(const PixelData<num_type_>  &px_data, const utils::vec2Ui  &pt) noexcept;
             [[nodiscard]] auto next(const PixelData<num_type_> &px_data) noexcept -> bool;
             void reset() noexcept;
 
+            /**
+             * @param y image row (Non interpreted)
+             * @returns pixel bytes of the Plane row covering image row y
+             * */
+            [[nodiscard]] auto row(std::uint32_t  y, std::size_t  plane = 0) noexcept -> gsl::span<std::uint8_t>;
+            //Subsampled Plane pixels take the value of the first image pixel covering them
+            void write_row(std::uint32_t  y, gsl::span<const PixelData<num_type_>>  pixels) noexcept;
+
             private:
+            template<template <typename> typename, typename>
+            friend struct WriterWrap;
 
             void at_packed(const PixelData<num_type_>  &px_data, const utils::vec2Ui  &pt) noexcept;
             void at_planar(const PixelData<num_type_>  &px_data, const utils::vec2Ui  &pt) noexcept;
             void increment_point() noexcept;
 
-            ImageCpu&  _image;
+            template <typename Fn>
+            void write_channel(std::size_t  channel, std::uint32_t  y, Fn  &&fn) noexcept;
+
+            ImageView  _image;
             std::uint32_t  _x, _y;
             FixedSizeVec<const std::uint8_t*, 5>  _start_address;
+            FixedSizeVec<ChannelLocation, 5>  _channels;
         };
 
         template <typename num_type_>
@@ -83,8 +114,13 @@ namespace nitros::utils
             auto get_pixel(const PixelData<num_type_>  &data) const noexcept -> Pixel_t;
             auto get_pixel(const Pixel_t  &data) const noexcept -> PixelData<num_type_>;
 
+            //Pixel_t member of each stored channel, missing members take default_pixel values
+            auto fields() const noexcept -> const FixedSizeVec<num_type_ Pixel_t::*, 5>&;
+            auto default_pixel() const noexcept -> Pixel_t;
+
             private:
             Format  _format;
+            FixedSizeVec<num_type_ Pixel_t::*, 5>  _fields;
         };
 
         template <typename num_type_>
@@ -98,8 +134,13 @@ namespace nitros::utils
             auto get_pixel(const PixelData<num_type_>  &data) const noexcept -> Pixel_t;
             auto get_pixel(const Pixel_t  &data) const noexcept -> PixelData<num_type_>;
 
+            //Pixel_t member of each stored channel, missing members take default_pixel values
+            auto fields() const noexcept -> const FixedSizeVec<num_type_ Pixel_t::*, 5>&;
+            auto default_pixel() const noexcept -> Pixel_t;
+
             private:
             Format  _format;
+            FixedSizeVec<num_type_ Pixel_t::*, 5>  _fields;
         };
 
         template<template <typename> typename format_interpret_, typename num_type_ >
@@ -107,12 +148,16 @@ namespace nitros::utils
         {
             public:
             using Pixel_t = typename format_interpret_<num_type_>::Pixel_t;
-            explicit ReaderWrap(const ImageCpu  &image) noexcept;
+            explicit ReaderWrap(const ConstImageView  &image) noexcept;
 
             [[nodiscard]] auto at(const utils::vec2Ui  &pt) const noexcept -> Pixel_t;
             [[nodiscard]] auto next() noexcept -> std::optional<Pixel_t>;
             void reset() noexcept;
 
+            [[nodiscard]] auto row(std::uint32_t  y, std::size_t  plane = 0) const noexcept -> gsl::span<const std::uint8_t>;
+            //pixels should hold atleast image width elements
+            void read_row(std::uint32_t  y, gsl::span<Pixel_t>  pixels) const noexcept;
+
             private:
             Reader<num_type_>   _reader;
         };
@@ -122,12 +167,16 @@ namespace nitros::utils
         {
             public:
             using Pixel_t = typename format_interpret_<num_type_>::Pixel_t;
-            explicit WriterWrap(ImageCpu  &image) noexcept;
+            explicit WriterWrap(const ImageView  &image) noexcept;
 
             void at(const Pixel_t  &px_data, const utils::vec2Ui  &pt) noexcept;
             [[nodiscard]] auto next(const Pixel_t  &px_data) noexcept -> bool;
             void reset() noexcept;
 
+            [[nodiscard]] auto row(std::uint32_t  y, std::size_t  plane = 0) noexcept -> gsl::span<std::uint8_t>;
+            //Subsampled Plane pixels take the value of the first image pixel covering them
+            void write_row(std::uint32_t  y, gsl::span<const Pixel_t>  pixels) noexcept;
+
             private:
             Writer<num_type_>   _writer;
         };
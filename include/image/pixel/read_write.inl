@@ -2,6 +2,8 @@
 
 #include "read_write.hpp"
 #include "image/utils.hpp"
+#include <algorithm>
+#include <limits>
 #include <optional>
 
 namespace nitros::utils
@@ -9,27 +11,19 @@ namespace nitros::utils
     namespace pixel
     {
         template <typename num_type_>
-        Reader<num_type_>::Reader(const ImageCpu  &image) noexcept
+        Reader<num_type_>::Reader(const ConstImageView  &image) noexcept
             :_image{image}
             ,_x{0}
             ,_y{0}
-            ,_start_address{}
-        {
-            for(auto i = 0; i < image.meta_data().format.planes.size(); i++) {
-                _start_address.push_back( plane_start_address(_image, i) );
-            }
-        }
+            ,_start_address{image.planes()}
+            ,_channels{channel_locations(image.meta_data().format)}
+        {}
 
         template <typename num_type_>
         auto Reader<num_type_>::at(const utils::vec2Ui  &pt) const noexcept -> PixelData<num_type_>
         {
-            using Pixel_t = PixelData<num_type_>;
-
-            auto meta = _image.meta_data();
-            auto format = meta.format;
-
             //If Planar
-            if(!format.planar_info.is_planar) {
+            if(!_image.meta_data().format.planar_info.is_planar) {
                 return at_packed(pt);
             }
             else {
@@ -57,12 +51,52 @@ namespace nitros::utils
             _y = 0;
         }
 
+        template <typename num_type_>
+        auto Reader<num_type_>::row(std::uint32_t  y, std::size_t  plane) const noexcept -> gsl::span<const std::uint8_t>
+        {
+            auto& meta = _image.meta_data();
+            auto& plane_desc = meta.format.planes[plane];
+            auto py = y * plane_desc.height_factor.num / plane_desc.height_factor.den;
+            return {_start_address[plane] + meta.steps[plane] * py, gsl::narrow_cast<std::ptrdiff_t>(plane_row_bytes(meta, plane))};
+        }
+
+        template <typename num_type_>
+        void Reader<num_type_>::read_row(std::uint32_t  y, gsl::span<PixelData<num_type_>>  pixels) const noexcept
+        {
+            auto width = _image.meta_data().size.width;
+            for(auto x = std::size_t{0}; x < width; x++) {
+                pixels[x] = PixelData<num_type_>{};
+            }
+
+            //Channels are read in storage order, so each pixel is filled in order
+            for(auto c = std::size_t{0}; c < _channels.size(); c++) {
+                read_channel(c, y, [&pixels](std::size_t x, num_type_ value) { pixels[x].push_back(value); });
+            }
+        }
+
+        template <typename num_type_>
+        template <typename Fn>
+        void Reader<num_type_>::read_channel(std::size_t  channel, std::uint32_t  y, Fn  &&fn) const noexcept
+        {
+            auto& meta = _image.meta_data();
+            auto& loc = _channels[channel];
+            auto& plane_desc = meta.format.planes[loc.plane];
+            auto plane_height = interpreted_plane_img_size(meta, loc.plane).height;
+            if(plane_height == 0) {
+                return;
+            }
+            //A trailing odd row shares the last row of a subsampled plane
+            auto py = std::min<std::size_t>(y * plane_desc.height_factor.num / plane_desc.height_factor.den, plane_height - 1);
+
+            read_channel_row<num_type_>(_start_address[loc.plane] + meta.steps[loc.plane] * py, loc, plane_desc.width_factor, meta.size.width, std::forward<Fn>(fn));
+        }
+
         template <typename num_type_>
         auto Reader<num_type_>::at_packed(const utils::vec2Ui  &pt) const noexcept -> PixelData<num_type_>
         {   
             auto& meta = _image.meta_data();
             auto& format = _image.meta_data().format;
-            auto start_addr = _image.buffer().data() + pt[1] * meta.steps[0] + (pt[0] * format.pixel_layout.bytes / format.pixel_layout.group_pixels );
+            auto start_addr = _start_address[0] + pt[1] * meta.steps[0] + (pt[0] * format.pixel_layout.bytes / format.pixel_layout.group_pixels );
             
             auto ar = PixelData<num_type_>{};
             auto offset = std::size_t{};
@@ -111,25 +145,19 @@ namespace nitros::utils
 
 
         template <typename num_type_>
-        Writer<num_type_>::Writer(ImageCpu  &image) noexcept
+        Writer<num_type_>::Writer(const ImageView  &image) noexcept
             :_image{image}
             ,_x{0}
             ,_y{0}
-            ,_start_address{}
-        {
-            for(auto i = 0; i < image.meta_data().format.planes.size(); i++) {
-                _start_address.push_back( plane_start_address(_image, i) );
-            }
-        }
+            ,_start_address{ConstImageView{image}.planes()}
+            ,_channels{channel_locations(image.meta_data().format)}
+        {}
 
         template <typename num_type_>
         void Writer<num_type_>::at(const PixelData<num_type_>  &px_data, const utils::vec2Ui  &pt) noexcept
         {
-            auto meta = _image.meta_data();
-            auto format = meta.format;
-
             //If Planar
-            if(!format.planar_info.is_planar) {
+            if(!_image.meta_data().format.planar_info.is_planar) {
                 at_packed(px_data, pt);
             }
             else {
@@ -158,6 +186,39 @@ namespace nitros::utils
             _y = 0;
         }
 
+        template <typename num_type_>
+        auto Writer<num_type_>::row(std::uint32_t  y, std::size_t  plane) noexcept -> gsl::span<std::uint8_t>
+        {
+            auto& meta = _image.meta_data();
+            auto& plane_desc = meta.format.planes[plane];
+            auto py = y * plane_desc.height_factor.num / plane_desc.height_factor.den;
+            return {const_cast<std::uint8_t*>(_start_address[plane]) + meta.steps[plane] * py, gsl::narrow_cast<std::ptrdiff_t>(plane_row_bytes(meta, plane))};
+        }
+
+        template <typename num_type_>
+        void Writer<num_type_>::write_row(std::uint32_t  y, gsl::span<const PixelData<num_type_>>  pixels) noexcept
+        {
+            for(auto c = std::size_t{0}; c < _channels.size(); c++) {
+                write_channel(c, y, [&pixels, c](std::size_t x) { return pixels[x][c]; });
+            }
+        }
+
+        template <typename num_type_>
+        template <typename Fn>
+        void Writer<num_type_>::write_channel(std::size_t  channel, std::uint32_t  y, Fn  &&fn) noexcept
+        {
+            auto& meta = _image.meta_data();
+            auto& loc = _channels[channel];
+            auto& plane_desc = meta.format.planes[loc.plane];
+            auto py = y * plane_desc.height_factor.num / plane_desc.height_factor.den;
+            //A trailing odd row has no row of its own in a subsampled plane
+            if(py >= interpreted_plane_img_size(meta, loc.plane).height) {
+                return;
+            }
+
+            write_channel_row<num_type_>(const_cast<std::uint8_t*>(_start_address[loc.plane]) + meta.steps[loc.plane] * py, loc, plane_desc.width_factor, meta.size.width, std::forward<Fn>(fn));
+        }
+
         template <typename num_type_>
         void Writer<num_type_>::at_packed(const PixelData<num_type_>  &px_data, const utils::vec2Ui  &pt) noexcept
         {
@@ -211,7 +272,36 @@ namespace nitros::utils
         template <typename num_type_>
         RGBInterpreter<num_type_>::RGBInterpreter(const Format  &format_) noexcept
             :_format{format_}
-        {}
+            ,_fields{}
+        {
+            auto channels = format_.planar_info.pixel_bits.size();
+            if(channels == 4) {
+                _fields = format_.pixel_type == type::rgba ? FixedSizeVec<num_type_ Pixel_t::*, 5>{&Pixel_t::r, &Pixel_t::g, &Pixel_t::b, &Pixel_t::a}
+                                                           : FixedSizeVec<num_type_ Pixel_t::*, 5>{&Pixel_t::b, &Pixel_t::g, &Pixel_t::r, &Pixel_t::a};
+            }
+            else if(channels == 3) {
+                _fields = format_.pixel_type == type::rgb ? FixedSizeVec<num_type_ Pixel_t::*, 5>{&Pixel_t::r, &Pixel_t::g, &Pixel_t::b}
+                                                          : FixedSizeVec<num_type_ Pixel_t::*, 5>{&Pixel_t::b, &Pixel_t::g, &Pixel_t::r};
+            }
+            else if(channels == 2) {
+                _fields = {&Pixel_t::r, &Pixel_t::g};
+            }
+            else {
+                _fields = {&Pixel_t::r};
+            }
+        }
+
+        template <typename num_type_>
+        auto RGBInterpreter<num_type_>::fields() const noexcept -> const FixedSizeVec<num_type_ Pixel_t::*, 5>&
+        {
+            return _fields;
+        }
+
+        template <typename num_type_>
+        auto RGBInterpreter<num_type_>::default_pixel() const noexcept -> Pixel_t
+        {
+            return Pixel_t{ .r = 0, .g = 0, .b = 0, .a = std::numeric_limits<num_type_>::max() };
+        }
 
         template <typename num_type_>
         auto RGBInterpreter<num_type_>::get_pixel(const PixelData<num_type_>  &ar) const noexcept -> Pixel_t
@@ -331,7 +421,27 @@ namespace nitros::utils
         template <typename num_type_>
         YUVInterpreter<num_type_>::YUVInterpreter(const Format  &format_) noexcept
             :_format{format_}
-        {}
+            ,_fields{}
+        {
+            if(format_.pixel_type == type::yuv) {
+                _fields = {&Pixel_t::y, &Pixel_t::cb, &Pixel_t::cr};
+            }
+            else {
+                _fields = {&Pixel_t::y, &Pixel_t::a, &Pixel_t::cb, &Pixel_t::cr};
+            }
+        }
+
+        template <typename num_type_>
+        auto YUVInterpreter<num_type_>::fields() const noexcept -> const FixedSizeVec<num_type_ Pixel_t::*, 5>&
+        {
+            return _fields;
+        }
+
+        template <typename num_type_>
+        auto YUVInterpreter<num_type_>::default_pixel() const noexcept -> Pixel_t
+        {
+            return Pixel_t{ .y = 0, .cb = 0, .cr = 0, .a = std::numeric_limits<num_type_>::max() };
+        }
 
         template <typename num_type_>
         auto YUVInterpreter<num_type_>::get_pixel(const PixelData<num_type_>  &ar) const noexcept -> Pixel_t
@@ -368,7 +478,7 @@ namespace nitros::utils
         }
 
         template<template <typename> typename format_interpret_, typename num_type_ >
-        ReaderWrap<format_interpret_, num_type_>::ReaderWrap(const ImageCpu  &image) noexcept
+        ReaderWrap<format_interpret_, num_type_>::ReaderWrap(const ConstImageView  &image) noexcept
             :format_interpret_<num_type_>{image.meta_data().format}
             ,_reader{image}
         {}
@@ -396,10 +506,30 @@ namespace nitros::utils
             return _reader.reset();
         }
 
+        template<template <typename> typename format_interpret_, typename num_type_ >
+        auto ReaderWrap<format_interpret_, num_type_>::row(std::uint32_t  y, std::size_t  plane) const noexcept -> gsl::span<const std::uint8_t>
+        {
+            return _reader.row(y, plane);
+        }
+
+        template<template <typename> typename format_interpret_, typename num_type_ >
+        void ReaderWrap<format_interpret_, num_type_>::read_row(std::uint32_t  y, gsl::span<Pixel_t>  pixels) const noexcept
+        {
+            auto& fields = format_interpret_<num_type_>::fields();
+            if(fields.size() < 4) {
+                std::fill_n(pixels.begin(), _reader._image.meta_data().size.width, format_interpret_<num_type_>::default_pixel());
+            }
+
+            for(auto c = std::size_t{0}; c < fields.size(); c++) {
+                auto field = fields[c];
+                _reader.read_channel(c, y, [&pixels, field](std::size_t x, num_type_ value) { pixels[x].*field = value; });
+            }
+        }
+
     //-----------------------------------------------------------------------------------------------
 
         template<template <typename> typename format_interpret_, typename num_type_ >
-        WriterWrap<format_interpret_, num_type_>::WriterWrap(ImageCpu  &image) noexcept
+        WriterWrap<format_interpret_, num_type_>::WriterWrap(const ImageView  &image) noexcept
             :format_interpret_<num_type_>{image.meta_data().format}
             ,_writer{image}
         {}
@@ -421,5 +551,21 @@ namespace nitros::utils
         {
             return _writer.reset() ; 
         }
+
+        template<template <typename> typename format_interpret_, typename num_type_ >
+        auto WriterWrap<format_interpret_, num_type_>::row(std::uint32_t  y, std::size_t  plane) noexcept -> gsl::span<std::uint8_t>
+        {
+            return _writer.row(y, plane);
+        }
+
+        template<template <typename> typename format_interpret_, typename num_type_ >
+        void WriterWrap<format_interpret_, num_type_>::write_row(std::uint32_t  y, gsl::span<const Pixel_t>  pixels) noexcept
+        {
+            auto& fields = format_interpret_<num_type_>::fields();
+            for(auto c = std::size_t{0}; c < fields.size(); c++) {
+                auto field = fields[c];
+                _writer.write_channel(c, y, [&pixels, field](std::size_t x) { return pixels[x].*field; });
+            }
+        }
     } // namespace pixel
 }
\ No newline at end of file
@@ -0,0 +1,147 @@
+
+
+#ifndef IMAGE_PIXEL_TYPED_HPP
+#define IMAGE_PIXEL_TYPED_HPP
+
+#include "image/image.hpp"
+#include "image/image_view.hpp"
+#include "utilities/data/vecs.hpp"
+#include <array>
+#include <tuple>
+#include <type_traits>
+
+namespace nitros::utils
+{
+    namespace pixel
+    {
+        namespace internal
+        {
+            template <typename Bits>
+            struct bits_array;
+
+            template <std::uint8_t ... Bits_>
+            struct bits_array<std::integer_sequence<std::uint8_t, Bits_...>>
+            {
+                static constexpr auto value = std::array<std::uint8_t, sizeof...(Bits_)>{Bits_...};
+            };
+
+            template <typename Planes>
+            struct planes_array;
+
+            template <typename ... Plane_>
+            struct planes_array<std::tuple<Plane_...>>
+            {
+                static constexpr auto value = std::array<Plane, sizeof...(Plane_)>{Plane_::value ...};
+            };
+        } // namespace internal
+
+        /**
+         * Compile time description of a format_factory format.
+         * Channels are numbered in storage order, same as PixelData returned by Reader
+         * */
+        template <typename format_>
+        struct format_traits
+        {
+            using format = format_;
+
+            static constexpr auto value     = format_::value;
+            static constexpr auto is_planar = format_::Planar::is_planar;
+
+            static constexpr auto bits         = internal::bits_array<typename format_::Planar::Bits>::value;
+            static constexpr auto plane_values = internal::planes_array<typename format_::Planes>::value;
+
+            static constexpr std::size_t channels = bits.size();
+            static constexpr std::size_t planes   = plane_values.size();
+
+            //Plane Index of each Channel
+            static constexpr auto plane_index = []() {
+                auto ar = std::array<std::size_t, channels>{};
+                for(std::size_t p = 0, c = 0; p < planes; p++) {
+                    for(std::size_t j = 0; j < plane_values[p].channels; j++, c++) {
+                        ar[c] = p;
+                    }
+                }
+                return ar;
+            }();
+
+            //Bit offset of each Channel inside the Plane pixel
+            static constexpr auto bit_offset = []() {
+                auto ar = std::array<std::size_t, channels>{};
+                for(std::size_t p = 0, c = 0; p < planes; p++) {
+                    auto offset = std::size_t{0};
+                    for(std::size_t j = 0; j < plane_values[p].channels; j++, c++) {
+                        ar[c] = offset;
+                        offset += bits[c];
+                    }
+                }
+                return ar;
+            }();
+
+            //Bits of one pixel of the Plane
+            static constexpr auto pixel_bits = []() {
+                auto ar = std::array<std::size_t, planes>{};
+                for(std::size_t c = 0; c < channels; c++) {
+                    ar[plane_index[c]] += bits[c];
+                }
+                return ar;
+            }();
+
+            static_assert( is_planar || value.pixel_layout.group_pixels == 1, "Grouped packed formats are not supported" );
+            static_assert( is_planar || pixel_bits[0] == value.pixel_layout.bytes * 8 );
+        };
+
+        template <typename num_type_, std::size_t N>
+        using TypedPixel = std::array<num_type_, N>;
+
+        /**
+         * Pixel accessor whose Format is fixed at compile time.
+         * Plane strides are read once at construction, channel offsets and bit depths are constants,
+         * so byte aligned channels are a single load / store.
+         *
+         * byte_type_ is const std::uint8_t for read only access
+         * */
+        template <typename format_, typename num_type_, typename byte_type_>
+        class TypedView
+        {
+            public:
+            using traits  = format_traits<format_>;
+            using Pixel_t = TypedPixel<num_type_, traits::channels>;
+            using Image_t = std::conditional_t<std::is_const_v<byte_type_>, const ImageCpu, ImageCpu>;
+
+            explicit TypedView(Image_t  &image) noexcept;
+            explicit TypedView(const BasicImageView<byte_type_>  &view) noexcept;
+
+            template <std::size_t C>
+            [[nodiscard]] auto get(const utils::vec2Ui  &pt) const noexcept -> num_type_;
+            template <std::size_t C>
+            void set(const num_type_  &value, const utils::vec2Ui  &pt) const noexcept;
+
+            [[nodiscard]] auto at(const utils::vec2Ui  &pt) const noexcept -> Pixel_t;
+            void at(const Pixel_t  &px_data, const utils::vec2Ui  &pt) const noexcept;
+
+            [[nodiscard]] auto size() const noexcept -> ImgSize;
+
+            private:
+            template <std::size_t C>
+            auto channel_address(const utils::vec2Ui  &pt) const noexcept -> byte_type_*;
+
+            template <std::size_t ... C>
+            auto at_impl(const utils::vec2Ui  &pt, std::index_sequence<C...>) const noexcept -> Pixel_t;
+            template <std::size_t ... C>
+            void at_impl(const Pixel_t  &px_data, const utils::vec2Ui  &pt, std::index_sequence<C...>) const noexcept;
+
+            ImgSize  _size;
+            std::array<byte_type_*, traits::planes>  _start_address;
+            std::array<std::size_t, traits::planes>  _steps;
+        };
+
+        template <typename format_, typename num_type_>
+        using TypedReader = TypedView<format_, num_type_, const std::uint8_t>;
+        template <typename format_, typename num_type_>
+        using TypedWriter = TypedView<format_, num_type_, std::uint8_t>;
+    }
+} // namespace nitros::utils
+
+#include "typed.inl"
+
+#endif
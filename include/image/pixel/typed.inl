@@ -0,0 +1,155 @@
+
+#include "typed.hpp"
+#include "image/utils.hpp"
+#include <cstring>
+#include <gsl/gsl>
+
+namespace nitros::utils
+{
+    namespace pixel
+    {
+        namespace internal
+        {
+            template <std::size_t bits>
+            using storage_t = std::conditional_t<bits == 8,  std::uint8_t,
+                              std::conditional_t<bits == 16, std::uint16_t,
+                              std::conditional_t<bits == 32, std::uint32_t,
+                              std::conditional_t<bits == 64, std::uint64_t, void>>>>;
+        } // namespace internal
+
+        template <typename format_, typename num_type_, typename byte_type_>
+        TypedView<format_, num_type_, byte_type_>::TypedView(Image_t  &image) noexcept
+            :TypedView(BasicImageView<byte_type_>{image})
+        {}
+
+        template <typename format_, typename num_type_, typename byte_type_>
+        TypedView<format_, num_type_, byte_type_>::TypedView(const BasicImageView<byte_type_>  &view) noexcept
+            :_size{view.size()}
+            ,_start_address{}
+            ,_steps{}
+        {
+            Expects( view.meta_data().format == traits::value );
+
+            for(auto i = std::size_t{0}; i < traits::planes; i++) {
+                _start_address[i] = view.plane(i);
+                _steps[i] = view.meta_data().steps[i];
+            }
+        }
+
+        template <typename format_, typename num_type_, typename byte_type_>
+        template <std::size_t C>
+        auto TypedView<format_, num_type_, byte_type_>::channel_address(const utils::vec2Ui  &pt) const noexcept -> byte_type_*
+        {
+            constexpr auto plane = traits::plane_index[C];
+            constexpr auto plane_desc = traits::plane_values[plane];
+
+            auto x = pt[0] * plane_desc.width_factor.num / plane_desc.width_factor.den;
+            auto y = pt[1] * plane_desc.height_factor.num / plane_desc.height_factor.den;
+            auto row = _start_address[plane] + _steps[plane] * y;
+
+            if constexpr (traits::pixel_bits[plane] % 8 == 0 && traits::bit_offset[C] % 8 == 0) {
+                return row + x * (traits::pixel_bits[plane] / 8) + traits::bit_offset[C] / 8;
+            }
+            else {
+                //Bit position is resolved by the masked accessors
+                return row;
+            }
+        }
+
+        template <typename format_, typename num_type_, typename byte_type_>
+        template <std::size_t C>
+        auto TypedView<format_, num_type_, byte_type_>::get(const utils::vec2Ui  &pt) const noexcept -> num_type_
+        {
+            static_assert( C < traits::channels );
+            constexpr auto bits  = std::size_t{traits::bits[C]};
+            constexpr auto plane = traits::plane_index[C];
+            auto ptr = channel_address<C>(pt);
+
+            if constexpr (traits::pixel_bits[plane] % 8 == 0 && traits::bit_offset[C] % 8 == 0)
+            {
+                if constexpr (bits == sizeof(num_type_) * 8) {
+                    auto num = num_type_{};
+                    std::memcpy(&num, ptr, sizeof(num_type_));
+                    return num;
+                }
+                else if constexpr (std::is_integral_v<num_type_> && !std::is_void_v<internal::storage_t<bits>>) {
+                    auto num = internal::storage_t<bits>{};
+                    std::memcpy(&num, ptr, sizeof(num));
+                    return static_cast<num_type_>(num);
+                }
+                else {
+                    return get_data_masked<num_type_>(ptr, 0, bits);
+                }
+            }
+            else
+            {
+                constexpr auto plane_desc = traits::plane_values[plane];
+                auto x = pt[0] * plane_desc.width_factor.num / plane_desc.width_factor.den;
+                return get_data_masked<num_type_>(ptr, x * traits::pixel_bits[plane] + traits::bit_offset[C], bits);
+            }
+        }
+
+        template <typename format_, typename num_type_, typename byte_type_>
+        template <std::size_t C>
+        void TypedView<format_, num_type_, byte_type_>::set(const num_type_  &value, const utils::vec2Ui  &pt) const noexcept
+        {
+            static_assert( C < traits::channels );
+            static_assert( !std::is_const_v<byte_type_>, "TypedReader is read only" );
+            constexpr auto bits  = std::size_t{traits::bits[C]};
+            constexpr auto plane = traits::plane_index[C];
+            auto ptr = channel_address<C>(pt);
+
+            if constexpr (traits::pixel_bits[plane] % 8 == 0 && traits::bit_offset[C] % 8 == 0)
+            {
+                if constexpr (bits == sizeof(num_type_) * 8) {
+                    std::memcpy(ptr, &value, sizeof(num_type_));
+                }
+                else if constexpr (std::is_integral_v<num_type_> && !std::is_void_v<internal::storage_t<bits>>) {
+                    auto num = static_cast<internal::storage_t<bits>>(value);
+                    std::memcpy(ptr, &num, sizeof(num));
+                }
+                else {
+                    write_data_masked<num_type_>(ptr, 0, bits, value);
+                }
+            }
+            else
+            {
+                constexpr auto plane_desc = traits::plane_values[plane];
+                auto x = pt[0] * plane_desc.width_factor.num / plane_desc.width_factor.den;
+                write_data_masked<num_type_>(ptr, x * traits::pixel_bits[plane] + traits::bit_offset[C], bits, value);
+            }
+        }
+
+        template <typename format_, typename num_type_, typename byte_type_>
+        template <std::size_t ... C>
+        auto TypedView<format_, num_type_, byte_type_>::at_impl(const utils::vec2Ui  &pt, std::index_sequence<C...>) const noexcept -> Pixel_t
+        {
+            return Pixel_t{ get<C>(pt) ... };
+        }
+
+        template <typename format_, typename num_type_, typename byte_type_>
+        template <std::size_t ... C>
+        void TypedView<format_, num_type_, byte_type_>::at_impl(const Pixel_t  &px_data, const utils::vec2Ui  &pt, std::index_sequence<C...>) const noexcept
+        {
+            ( set<C>(px_data[C], pt), ... );
+        }
+
+        template <typename format_, typename num_type_, typename byte_type_>
+        auto TypedView<format_, num_type_, byte_type_>::at(const utils::vec2Ui  &pt) const noexcept -> Pixel_t
+        {
+            return at_impl(pt, std::make_index_sequence<traits::channels>{});
+        }
+
+        template <typename format_, typename num_type_, typename byte_type_>
+        void TypedView<format_, num_type_, byte_type_>::at(const Pixel_t  &px_data, const utils::vec2Ui  &pt) const noexcept
+        {
+            at_impl(px_data, pt, std::make_index_sequence<traits::channels>{});
+        }
+
+        template <typename format_, typename num_type_, typename byte_type_>
+        auto TypedView<format_, num_type_, byte_type_>::size() const noexcept -> ImgSize
+        {
+            return _size;
+        }
+    } // namespace pixel
+}
@@ -2,15 +2,21 @@
 #define NITROS_IMAGE_CONVERSION_HPP
 
 #include "image/image.hpp"
+#include "image/image_view.hpp"
 #include "image/image_export.h"
+#include "image/process/thread_pool.hpp"
 #include <gsl/span>
 
 namespace nitros::image
 {
-    NIMAGE_EXPORT auto color_convert(const utils::ImageCpu  &src_image, utils::ImageCpu  &dest_image) -> bool;
+    //Images convert to views implicitly, so both work on whole images and on roi() regions
+    NIMAGE_EXPORT auto color_convert(const utils::ConstImageView  &src_image, const utils::ImageView  &dest_image) -> bool;
+    //Converts row bands on the pool, bands start on even rows for vertically subsampled formats
+    NIMAGE_EXPORT auto color_convert(const utils::ConstImageView  &src_image, const utils::ImageView  &dest_image, ThreadPool  &pool) -> bool;
 
-    //Handles only one plane now
-    NIMAGE_EXPORT auto flip_y(const utils::ImageCpu &src_image, utils::ImageCpu  &dest_image) -> bool;
+    //Flips every plane, source and destination must not overlap
+    NIMAGE_EXPORT auto flip_y(const utils::ConstImageView  &src_image, const utils::ImageView  &dest_image) -> bool;
+    NIMAGE_EXPORT auto flip_y(const utils::ConstImageView  &src_image, const utils::ImageView  &dest_image, ThreadPool  &pool) -> bool;
 } // namespace nitros::image
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,68 @@
+#ifndef NITROS_IMAGE_CONVERTER_HPP
+#define NITROS_IMAGE_CONVERTER_HPP
+
+#include "image/image.hpp"
+#include "image/image_view.hpp"
+#include "image/image_export.h"
+#include "image/process/thread_pool.hpp"
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace nitros::image
+{
+    /**
+     * Converts the rows [first_row, last_row) of src into dest, both views have the same size
+     * Rows of one call must not share a subsampled plane row with rows of a concurrent call
+     * */
+    using ConvertRowsFn = std::function<void(const utils::ConstImageView  &src, const utils::ImageView  &dest, std::size_t  first_row, std::size_t  last_row)>;
+
+    /**
+     * Converter resolved once for a (source, destination) Format pair, cheap to copy and reusable across frames
+     * */
+    class NIMAGE_EXPORT ConversionPlan final
+    {
+        public:
+        struct Entry;
+
+        ConversionPlan() noexcept = default;
+        explicit ConversionPlan(std::shared_ptr<const Entry>  entry) noexcept;
+
+        explicit operator bool() const noexcept;
+
+        //Converter is a dedicated kernel, false for the generic per channel path
+        auto is_fast() const noexcept -> bool;
+        //Bands handed to the converter start on multiples of this row count
+        auto row_alignment() const noexcept -> std::size_t;
+
+        /**
+         * @returns false if the plan is empty, the view formats must match the planned pair
+         * */
+        auto operator()(const utils::ConstImageView  &src, const utils::ImageView  &dest) const -> bool;
+        auto operator()(const utils::ConstImageView  &src, const utils::ImageView  &dest, ThreadPool  &pool) const -> bool;
+
+        private:
+        std::shared_ptr<const Entry>  _entry;
+    };
+
+    /**
+     * Looks the pair up in the converter registry, falls back to the generic path
+     * @returns empty plan if the pair cannot be converted
+     * */
+    NIMAGE_EXPORT auto plan_conversion(const utils::pixel::Format  &src, const utils::pixel::Format  &dest) -> ConversionPlan;
+
+    //Pair has a dedicated (built in or registered) converter
+    NIMAGE_EXPORT auto has_fast_path(const utils::pixel::Format  &src, const utils::pixel::Format  &dest) -> bool;
+
+    //All pairs with a dedicated converter
+    NIMAGE_EXPORT auto fast_conversions() -> std::vector<std::pair<utils::pixel::Format, utils::pixel::Format>>;
+
+    /**
+     * Registers or replaces the converter of a pair, plans resolved before keep their converter
+     * @param row_alignment band alignment the converter needs on top of the formats subsampling
+     * */
+    NIMAGE_EXPORT void register_converter(const utils::pixel::Format  &src, const utils::pixel::Format  &dest, ConvertRowsFn  convert, std::size_t  row_alignment = 1);
+} // namespace nitros::image
+
+#endif
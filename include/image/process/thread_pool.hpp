@@ -0,0 +1,79 @@
+#ifndef NITROS_IMAGE_THREAD_POOL_HPP
+#define NITROS_IMAGE_THREAD_POOL_HPP
+
+#include "image/image_export.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace nitros::image
+{
+    /**
+     * Fixed set of worker threads, used to split image operations into row bands
+     * */
+    class NIMAGE_EXPORT ThreadPool final
+    {
+        public:
+        using BandFn = std::function<void(std::size_t first, std::size_t last)>;
+
+        /**
+         * @param threads number of workers, 0 runs every task on the calling thread
+         * */
+        explicit ThreadPool(std::size_t  threads = std::thread::hardware_concurrency());
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool(ThreadPool&&) = delete;
+        ~ThreadPool();
+
+        auto operator=(const ThreadPool&) -> ThreadPool& = delete;
+        auto operator=(ThreadPool&&) -> ThreadPool& = delete;
+
+        auto size() const noexcept -> std::size_t;
+
+        template <typename Fn>
+        auto submit(Fn  &&fn) -> std::future<std::invoke_result_t<std::decay_t<Fn>>>;
+
+        /**
+         * Splits [begin, end) into one band per worker plus one for the calling thread and waits for all of them
+         * @param alignment every band except the last starts and ends on a multiple of alignment (relative to begin)
+         * Exceptions thrown by fn are rethrown after all bands finished
+         * */
+        void parallel_for(std::size_t  begin, std::size_t  end, std::size_t  alignment, const BandFn  &fn);
+
+        /**
+         * Calls fn(index) for every index of [0, count) without waiting for it. At most max_parallel runners
+         * (0 is one per worker) pull indices from a shared counter, so a batch occupies a bounded number of queue slots.
+         * fn is called concurrently from several threads
+         * @returns future ready after the last call, it rethrows the first exception thrown by fn
+         * */
+        template <typename Fn>
+        auto for_each(std::size_t  count, Fn  &&fn, std::size_t  max_parallel = 0) -> std::future<void>;
+
+        /**
+         * Like for_each, with one future per index for the result of fn(index)
+         * */
+        template <typename Fn>
+        auto map(std::size_t  count, Fn  &&fn, std::size_t  max_parallel = 0) -> std::vector<std::future<std::invoke_result_t<std::decay_t<Fn>, std::size_t>>>;
+
+        private:
+        void enqueue(std::function<void()>  &&task);
+        auto run_pending() -> bool;
+        void worker();
+
+        std::vector<std::thread>            _workers;
+        std::deque<std::function<void()>>   _tasks;
+        std::mutex                          _mutex;
+        std::condition_variable             _cv;
+        bool                                _stop;
+    };
+} // namespace nitros::image
+
+#include "thread_pool.inl"
+
+#endif
@@ -0,0 +1,103 @@
+
+#include "thread_pool.hpp"
+#include <algorithm>
+#include <exception>
+#include <memory>
+
+namespace nitros::image
+{
+    template <typename Fn>
+    auto ThreadPool::submit(Fn  &&fn) -> std::future<std::invoke_result_t<std::decay_t<Fn>>>
+    {
+        using Result = std::invoke_result_t<std::decay_t<Fn>>;
+
+        //std::function needs a copyable target
+        auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<Fn>(fn));
+        auto future = task->get_future();
+        enqueue([task]() { (*task)(); });
+        return future;
+    }
+
+    template <typename Fn>
+    auto ThreadPool::for_each(std::size_t  count, Fn  &&fn, std::size_t  max_parallel) -> std::future<void>
+    {
+        struct Batch
+        {
+            Batch(std::decay_t<Fn>  &&fn_, std::size_t  count_, std::size_t  runners_)
+                :fn{std::move(fn_)}
+                ,count{count_}
+                ,next{0}
+                ,running{runners_}
+            {}
+
+            std::decay_t<Fn>          fn;
+            std::size_t               count;
+            std::atomic<std::size_t>  next;
+            std::atomic<std::size_t>  running;
+            std::promise<void>        done;
+            std::mutex                error_mutex;
+            std::exception_ptr        error;
+        };
+
+        auto runners = std::min(count, max_parallel == 0 ? std::max<std::size_t>(size(), 1) : max_parallel);
+        auto batch = std::make_shared<Batch>(std::decay_t<Fn>{std::forward<Fn>(fn)}, count, runners);
+        auto future = batch->done.get_future();
+        if(count == 0) {
+            batch->done.set_value();
+            return future;
+        }
+
+        for(auto i = std::size_t{0}; i < runners; i++)
+        {
+            enqueue([batch]() {
+                for(auto index = batch->next++; index < batch->count; index = batch->next++)
+                {
+                    try {
+                        batch->fn(index);
+                    }
+                    catch(...) {
+                        auto lock = std::lock_guard{batch->error_mutex};
+                        if(!batch->error) {
+                            batch->error = std::current_exception();
+                        }
+                    }
+                }
+
+                if(--batch->running == 0) {
+                    batch->error ? batch->done.set_exception(batch->error) : batch->done.set_value();
+                }
+            });
+        }
+        return future;
+    }
+
+    template <typename Fn>
+    auto ThreadPool::map(std::size_t  count, Fn  &&fn, std::size_t  max_parallel) -> std::vector<std::future<std::invoke_result_t<std::decay_t<Fn>, std::size_t>>>
+    {
+        using Result = std::invoke_result_t<std::decay_t<Fn>, std::size_t>;
+
+        auto promises = std::make_shared<std::vector<std::promise<Result>>>(count);
+        auto futures = std::vector<std::future<Result>>{};
+        futures.reserve(count);
+        for(auto &promise : *promises) {
+            futures.push_back(promise.get_future());
+        }
+
+        for_each(count, [promises, fn = std::decay_t<Fn>{std::forward<Fn>(fn)}](std::size_t  index) {
+            auto &promise = (*promises)[index];
+            try {
+                if constexpr(std::is_void_v<Result>) {
+                    fn(index);
+                    promise.set_value();
+                }
+                else {
+                    promise.set_value(fn(index));
+                }
+            }
+            catch(...) {
+                promise.set_exception(std::current_exception());
+            }
+        }, max_parallel);
+        return futures;
+    }
+} // namespace nitros::image
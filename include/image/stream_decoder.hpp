@@ -0,0 +1,71 @@
+#ifndef NITROS_IMAGE_STREAM_DECODER_HPP
+#define NITROS_IMAGE_STREAM_DECODER_HPP
+
+#include "image/fileio.hpp"
+#include "image/image.hpp"
+#include "image/image_view.hpp"
+#include "image/image_export.h"
+#include <gsl/span>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+namespace nitros::utils::image
+{
+    /**
+     * Push based decoder for encoded images arriving in chunks, e.g. from a socket.
+     * QOI and binary Netpbm are decoded as the bytes come in, rows are final as soon as they are reported
+     * and at most one row or op of input is held back, never the whole payload.
+     * Other formats are collected and decoded with decode_image when finish() is called.
+     * Not thread safe, one decoder per stream
+     * */
+    class NIMAGE_EXPORT StreamDecoder final
+    {
+        struct State;
+
+        public:
+        //Rows [first_row, last_row) of image were completed by the last push, called on the pushing thread
+        using RowsCallback = std::function<void(const ConstImageView  &image, std::size_t  first_row, std::size_t  last_row)>;
+
+        /**
+         * @param options the streamed formats decode to their native format (QOI also to RGB8 or RGBA8)
+         *                and without reduction, other requests are rejected once the header arrived
+         * */
+        explicit StreamDecoder(const DecodeOptions  &options = {}, RowsCallback  on_rows = {});
+        StreamDecoder(const StreamDecoder&) = delete;
+        StreamDecoder(StreamDecoder&&) noexcept;
+        ~StreamDecoder();
+
+        auto operator=(const StreamDecoder&) -> StreamDecoder& = delete;
+        auto operator=(StreamDecoder&&) noexcept -> StreamDecoder&;
+
+        /**
+         * Decodes what the bytes so far allow, chunks may be split anywhere
+         * @throws std::invalid_argument if options cannot be met for the streamed formats
+         * @throws std::length_error if the header exceeds options.max_pixels or options.max_bytes
+         * @throws std::runtime_error for malformed data or a push after finish()
+         * */
+        void push(gsl::span<const std::uint8_t>  data);
+
+        /**
+         * Marks the end of the input, the collected formats are decoded here
+         * @throws std::runtime_error if the data ended before the image did or cannot be decoded
+         * */
+        void finish();
+
+        auto header_ready() const noexcept -> bool;
+        //Rows [0, rows_ready()) of image() are decoded
+        auto rows_ready() const noexcept -> std::size_t;
+        auto finished() const noexcept -> bool;
+
+        //The image being decoded, null until the header arrived. It may be moved out once finished
+        auto image() noexcept -> ImageCpu*;
+        auto image() const noexcept -> const ImageCpu*;
+
+        private:
+        std::unique_ptr<State>  _state;
+    };
+} // namespace nitros::utils::image
+
+#endif
@@ -0,0 +1,108 @@
+#ifndef NITROS_IMAGE_STRIP_IO_HPP
+#define NITROS_IMAGE_STRIP_IO_HPP
+
+#include "image/fileio.hpp"
+#include "image/image.hpp"
+#include "image/image_view.hpp"
+#include "image/image_export.h"
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <string>
+
+namespace nitros::utils::image
+{
+    /**
+     * Reads an image file top to bottom a strip of rows at a time into one reused strip image,
+     * so images larger than memory can be processed (e.g. with color_convert) strip by strip.
+     * Raw containers, binary Netpbm, QOI and uncompressed BMP (grey, BGR or BGRA, top down or bottom up)
+     * are read incrementally and memory stays at one strip plus a small read buffer whatever the height.
+     * Other formats, PNG among them, have no partial decode in stb_image and are rejected, decode them
+     * whole with read_image and DecodeOptions limits instead.
+     * Move only, not thread safe
+     * */
+    class NIMAGE_EXPORT StripReader final
+    {
+        struct State;
+
+        public:
+        /**
+         * @param strip_rows rows per strip, rounded up to the vertical subsampling of planar formats
+         * @throws std::invalid_argument if strip_rows is 0 or the file is not raw, binary Netpbm, QOI or uncompressed BMP
+         * @throws std::runtime_error if the file cannot be read or its header is malformed
+         * */
+        StripReader(const std::string  &full_source_path, std::size_t  strip_rows);
+        StripReader(const StripReader&) = delete;
+        StripReader(StripReader&&) noexcept;
+        ~StripReader();
+
+        auto operator=(const StripReader&) -> StripReader& = delete;
+        auto operator=(StripReader&&) noexcept -> StripReader&;
+
+        //Size and format of the whole image
+        auto meta_data() const noexcept -> const ImageMetaData&;
+        //raw, pnm, qoi or bmp
+        auto file_format() const noexcept -> FileFormat;
+        auto strip_rows() const noexcept -> std::size_t;
+        //Image rows returned so far, the next strip starts at this row
+        auto rows_read() const noexcept -> std::size_t;
+
+        /**
+         * Decodes the next strip, the view is valid until the next call and may be modified in place.
+         * The last strip has the remaining rows only
+         * @returns nullopt after the last row
+         * @throws std::runtime_error if the file is truncated or malformed
+         * */
+        auto next() -> std::optional<ImageView>;
+
+        private:
+        std::unique_ptr<State>  _state;
+    };
+
+    /**
+     * Writes an image file top to bottom from strips of rows, nothing but the current strip is held in memory.
+     * PNG takes 1 to 4 interleaved 8 bit channels and is written with stored (uncompressed) deflate blocks,
+     * stb_image_write has no streaming compressor, StripReader does not read PNG back (write raw or bmp for that).
+     * BMP takes GREY8, RGB8 and RGBA8 and is written top down.
+     * The raw container takes any format, its file is created at full size and filled through a mapping.
+     * Move only, not thread safe
+     * */
+    class NIMAGE_EXPORT StripWriter final
+    {
+        struct State;
+
+        public:
+        /**
+         * @throws std::invalid_argument if file_format is not png, bmp or raw, or cannot hold format
+         * @throws std::runtime_error if the file cannot be created
+         * */
+        StripWriter(const std::string  &full_target_path, ImgSize  size, const pixel::Format  &format, FileFormat  file_format);
+        StripWriter(const StripWriter&) = delete;
+        StripWriter(StripWriter&&) noexcept;
+        ~StripWriter();
+
+        auto operator=(const StripWriter&) -> StripWriter& = delete;
+        auto operator=(StripWriter&&) noexcept -> StripWriter&;
+
+        auto rows_written() const noexcept -> std::size_t;
+
+        /**
+         * Appends the rows of strip below the ones written so far. Every strip but the last has a height
+         * that is a multiple of the vertical subsampling of planar formats
+         * @throws std::invalid_argument if the width or format differ, or the rows run past the image height
+         * @throws std::runtime_error if writing fails
+         * */
+        void write(const ConstImageView  &strip);
+
+        /**
+         * Completes the file, a writer destroyed before leaves it incomplete
+         * @throws std::runtime_error if fewer rows than the image height were written or writing fails
+         * */
+        void finish();
+
+        private:
+        std::unique_ptr<State>  _state;
+    };
+} // namespace nitros::utils::image
+
+#endif
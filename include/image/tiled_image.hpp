@@ -0,0 +1,101 @@
+#ifndef NITROS_IMAGE_TILED_IMAGE_HPP
+#define NITROS_IMAGE_TILED_IMAGE_HPP
+
+#include "image/image.hpp"
+#include "image/image_view.hpp"
+#include "image/image_export.h"
+#include <cstddef>
+#include <memory>
+#include <string>
+
+namespace nitros::utils::image
+{
+    struct TileCacheStats
+    {
+        //Tile lookups served from memory
+        std::size_t  hits;
+        //Tile lookups that read the tile from the file
+        std::size_t  misses;
+        //Tiles dropped to stay within the cache budget
+        std::size_t  evictions;
+        //Modified tiles written to the file, on eviction or flush
+        std::size_t  write_backs;
+        std::size_t  resident_tiles;
+        std::size_t  resident_bytes;
+    };
+
+    /**
+     * Out of core image split into fixed size tiles, each an ImageCpu of the image format, kept in a file
+     * and paged in through an LRU cache with a byte budget. Rectangles of any size are read and written
+     * by composing the tiles covering them, only those tiles have to be resident.
+     * Edge tiles are stored at full tile size, their pixels outside the image are unused.
+     * Move only. Thread safe, calls are serialized
+     * */
+    class NIMAGE_EXPORT TiledImage final
+    {
+        struct State;
+
+        public:
+        static constexpr auto default_cache_bytes = std::size_t{64 * 1024 * 1024};
+
+        /**
+         * Creates (or truncates) the file with all pixels zero, the file is sparse until tiles are written
+         * @param tile_size rounded up to the plane subsampling of the format
+         * @throws std::invalid_argument for an empty size or tile size
+         * @throws std::runtime_error if the file cannot be created
+         * */
+        static auto create(const std::string  &path, ImgSize  size, const pixel::Format  &format,
+                           ImgSize  tile_size = {256, 256}, std::size_t  cache_bytes = default_cache_bytes) -> TiledImage;
+
+        //@throws std::runtime_error if the file is not a tiled image or is truncated
+        static auto open(const std::string  &path, std::size_t  cache_bytes = default_cache_bytes) -> TiledImage;
+
+        TiledImage(const TiledImage&) = delete;
+        TiledImage(TiledImage&&) noexcept;
+        //Writes modified tiles back, errors are lost, call flush() to see them
+        ~TiledImage();
+
+        auto operator=(const TiledImage&) -> TiledImage& = delete;
+        auto operator=(TiledImage&&) noexcept -> TiledImage&;
+
+        //Size and format of the whole image
+        auto meta_data() const noexcept -> const ImageMetaData&;
+        auto tile_size() const noexcept -> ImgSize;
+        //Number of tile columns and rows
+        auto tile_grid() const noexcept -> ImgSize;
+
+        /**
+         * The tile at (column, row) of the grid, loaded if needed. The handle is an immutable snapshot that stays
+         * valid when the tile is evicted, later writes to a tile with handles out go to a copy of it
+         * @throws std::invalid_argument if the tile is outside the grid
+         * */
+        auto tile(std::size_t  column, std::size_t  row) -> std::shared_ptr<const ImageCpu>;
+
+        /**
+         * Copies the rectangle at (x, y) of the size of target out of the tiles into target.
+         * (x, y) must be a multiple of roi_alignment of the format
+         * @throws std::invalid_argument if the rectangle is outside the image, not aligned or of another format
+         * @throws std::runtime_error if reading or writing the file fails
+         * */
+        void read(std::size_t  x, std::size_t  y, const ImageView  &target);
+        auto region(std::size_t  x, std::size_t  y, ImgSize  size) -> ImageCpu;
+
+        //Copies source into the tiles at (x, y), tiles covered completely are not read first
+        void write(std::size_t  x, std::size_t  y, const ConstImageView  &source);
+
+        //Writes modified tiles to the file, they stay resident
+        void flush();
+
+        auto stats() const -> TileCacheStats;
+        auto cache_bytes() const -> std::size_t;
+        //Evicts least recently used tiles until the new budget holds, one tile always stays resident
+        void set_cache_bytes(std::size_t  bytes);
+
+        private:
+        explicit TiledImage(std::unique_ptr<State>  state) noexcept;
+
+        std::unique_ptr<State>  _state;
+    };
+} // namespace nitros::utils::image
+
+#endif
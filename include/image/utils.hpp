@@ -115,6 +115,20 @@ namespace nitros::utils
         return {x, y};
     }
 
+    /**
+     * @returns byte offset of the Plane from the start of the image buffer
+     * */
+    inline auto plane_offset(const ImageMetaData  &meta_data, std::size_t  index) -> std::size_t
+    {
+        auto offset = std::size_t{0};
+        if(meta_data.format.planar_info.is_planar) {
+            for(auto i = std::size_t{0}; i < index; i++) {
+                offset += interpreted_plane_img_size(meta_data, i).height * meta_data.steps.at(i);
+            }
+        }
+        return offset;
+    }
+
     inline auto plane_start_address(const ImageCpu  &image_, std::size_t  index) -> const std::uint8_t*
     {
         auto&  meta_data = image_.meta_data();
@@ -190,6 +204,127 @@ namespace nitros::utils
             return plane_pixel_address(pt, st, meta_data, index );
         }
     }
+
+    struct ChannelLocation
+    {
+        std::uint32_t   plane;
+        std::uint32_t   bit_offset;     //Offset of the channel inside the Plane pixel
+        std::uint32_t   bit_depth;
+        std::uint32_t   pixel_bits;     //Bits of one Plane pixel
+    };
+
+    /**
+     * Channels are in storage order (same order as Reader PixelData)
+     * @returns location of each channel of the format
+     * */
+    inline auto channel_locations(const pixel::Format  &format) -> FixedSizeVec<ChannelLocation, 5>
+    {
+        auto locations = FixedSizeVec<ChannelLocation, 5>{};
+        auto pre_bits_index = 0u;
+        for(auto i = 0u; i < format.planes.size(); i++)
+        {
+            auto plane_pixel_bits = 0u;
+            for(auto j = 0u; j < format.planes[i].channels; j++) {
+                plane_pixel_bits += format.planar_info.pixel_bits[pre_bits_index + j];
+            }
+
+            for(auto j = 0u, offset = 0u; j < format.planes[i].channels; j++) {
+                auto bit_depth = std::uint32_t{format.planar_info.pixel_bits[pre_bits_index + j]};
+                locations.push_back({ .plane = i, .bit_offset = offset, .bit_depth = bit_depth, .pixel_bits = plane_pixel_bits });
+                offset += bit_depth;
+            }
+            pre_bits_index += format.planes[i].channels;
+        }
+        return locations;
+    }
+
+    /**
+     * @returns bytes occupied by the pixels of one row of the Plane (without row padding)
+     * */
+    inline auto plane_row_bytes(const ImageMetaData  &meta_data, std::size_t index) -> std::size_t
+    {
+        if(!meta_data.format.planar_info.is_planar) {
+            return (meta_data.size.width * meta_data.format.pixel_layout.bytes + meta_data.format.pixel_layout.group_pixels - 1) / meta_data.format.pixel_layout.group_pixels;
+        }
+
+        auto locations = channel_locations(meta_data.format);
+        auto it = std::find_if(locations.begin(), locations.end(), [index](const ChannelLocation  &loc) { return loc.plane == index; });
+        auto [w, h] = interpreted_plane_img_size(meta_data, index);
+        return (w * it->pixel_bits + 7) / 8;
+    }
+
+    /**
+     * Calls fn(x, value) for every image pixel x of the row, trailing odd pixels repeat the last Plane pixel
+     * @param row start of the Plane row
+     * @param width Image width (Non interpreted)
+     * */
+    template <typename NumType, typename Fn>
+    inline void read_channel_row(const std::uint8_t  *row, const ChannelLocation  &loc, const pixel::Plane::factor  &width_factor, std::size_t width, Fn  &&fn)
+    {
+        auto plane_width = width * width_factor.num / width_factor.den;
+        if(plane_width == 0) {
+            return;
+        }
+        auto plane_x = [&width_factor, plane_width](std::size_t x) { return std::min<std::size_t>(x * width_factor.num / width_factor.den, plane_width - 1); };
+
+        if constexpr (std::is_integral_v<NumType>)
+        {
+            if(loc.pixel_bits % 8 == 0 && loc.bit_offset % 8 == 0 && loc.bit_depth == 8)
+            {
+                auto px_bytes = loc.pixel_bits / 8;
+                auto st = row + loc.bit_offset / 8;
+                if(width_factor.num == width_factor.den) {
+                    for(auto x = std::size_t{0}; x < width; x++) {
+                        fn(x, static_cast<NumType>( st[x * px_bytes] ));
+                    }
+                }
+                else {
+                    for(auto x = std::size_t{0}; x < width; x++) {
+                        fn(x, static_cast<NumType>( st[plane_x(x) * px_bytes] ));
+                    }
+                }
+                return;
+            }
+        }
+
+        for(auto x = std::size_t{0}; x < width; x++) {
+            fn(x, get_data_masked<NumType>(row, plane_x(x) * loc.pixel_bits + loc.bit_offset, loc.bit_depth));
+        }
+    }
+
+    /**
+     * Writes fn(x) for every pixel of the Plane row, x is the first image pixel covering the Plane pixel
+     * @param row start of the Plane row
+     * @param width Image width (Non interpreted)
+     * */
+    template <typename NumType, typename Fn>
+    inline void write_channel_row(std::uint8_t  *row, const ChannelLocation  &loc, const pixel::Plane::factor  &width_factor, std::size_t width, Fn  &&fn)
+    {
+        auto plane_width = width * width_factor.num / width_factor.den;
+        if constexpr (std::is_integral_v<NumType>)
+        {
+            if(loc.pixel_bits % 8 == 0 && loc.bit_offset % 8 == 0 && loc.bit_depth == 8)
+            {
+                auto px_bytes = loc.pixel_bits / 8;
+                auto st = row + loc.bit_offset / 8;
+                if(width_factor.num == width_factor.den) {
+                    for(auto x = std::size_t{0}; x < plane_width; x++) {
+                        st[x * px_bytes] = static_cast<std::uint8_t>( fn(x) );
+                    }
+                }
+                else {
+                    for(auto px = std::size_t{0}; px < plane_width; px++) {
+                        st[px * px_bytes] = static_cast<std::uint8_t>( fn(px * width_factor.den / width_factor.num) );
+                    }
+                }
+                return;
+            }
+        }
+
+        for(auto px = std::size_t{0}; px < plane_width; px++) {
+            write_data_masked<NumType>(row, px * loc.pixel_bits + loc.bit_offset, loc.bit_depth, fn(px * width_factor.den / width_factor.num));
+        }
+    }
 } // namespace nitros::utils
 
 #endif
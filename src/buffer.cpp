@@ -0,0 +1,276 @@
+#include "image/buffer.hpp"
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <new>
+#include <utility>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+namespace nitros::utils
+{
+    namespace
+    {
+        constexpr auto page_size = std::size_t{4096};
+        constexpr auto huge_page_size = std::size_t{2 * 1024 * 1024};
+
+        auto allocation_alignment(std::size_t  capacity, const BufferOptions  &options) noexcept -> std::size_t
+        {
+            auto alignment = std::max<std::size_t>(options.alignment, alignof(std::max_align_t));
+            if(capacity >= options.page_threshold) {
+                alignment = std::max(alignment, page_size);
+            }
+#if defined(__linux__)
+            if(options.huge_pages && capacity >= options.huge_page_threshold) {
+                alignment = std::max(alignment, huge_page_size);
+            }
+#endif
+            return alignment;
+        }
+    } // namespace
+
+    AlignedBuffer::AlignedBuffer() noexcept
+        :_data{nullptr}
+        ,_size{0}
+        ,_capacity{0}
+        ,_alignment{0}
+        ,_options{}
+        ,_deleter{nullptr}
+    {}
+
+    AlignedBuffer::AlignedBuffer(size_type  size, const BufferOptions  &options)
+        :_data{nullptr}
+        ,_size{0}
+        ,_capacity{0}
+        ,_alignment{0}
+        ,_options{options}
+        ,_deleter{nullptr}
+    {
+        resize(size);
+    }
+
+    AlignedBuffer::AlignedBuffer(size_type  size, value_type  value)
+        :AlignedBuffer(size)
+    {
+        std::memset(_data, value, _size);
+    }
+
+    AlignedBuffer::AlignedBuffer(std::initializer_list<value_type>  values)
+        :AlignedBuffer(values.size())
+    {
+        std::copy(values.begin(), values.end(), _data);
+    }
+
+    AlignedBuffer::AlignedBuffer(const AlignedBuffer  &other)
+        :AlignedBuffer(other._size, other._options)
+    {
+        if(_size) {
+            std::memcpy(_data, other._data, _size);
+        }
+    }
+
+    AlignedBuffer::AlignedBuffer(AlignedBuffer  &&other) noexcept
+        :_data{std::exchange(other._data, nullptr)}
+        ,_size{std::exchange(other._size, 0)}
+        ,_capacity{std::exchange(other._capacity, 0)}
+        ,_alignment{std::exchange(other._alignment, 0)}
+        ,_options{other._options}
+        ,_deleter{std::exchange(other._deleter, nullptr)}
+    {}
+
+    AlignedBuffer::~AlignedBuffer()
+    {
+        release();
+    }
+
+    auto AlignedBuffer::operator=(const AlignedBuffer  &other) -> AlignedBuffer&
+    {
+        if(this != &other) {
+            auto copy = AlignedBuffer{other};
+            swap(copy);
+        }
+        return *this;
+    }
+
+    auto AlignedBuffer::operator=(AlignedBuffer  &&other) noexcept -> AlignedBuffer&
+    {
+        if(this != &other) {
+            release();
+            _data      = std::exchange(other._data, nullptr);
+            _size      = std::exchange(other._size, 0);
+            _capacity  = std::exchange(other._capacity, 0);
+            _alignment = std::exchange(other._alignment, 0);
+            _options   = other._options;
+            _deleter   = std::exchange(other._deleter, nullptr);
+        }
+        return *this;
+    }
+
+    auto AlignedBuffer::adopt(pointer  data, size_type  size, Deleter  deleter, const BufferOptions  &options) noexcept -> AlignedBuffer
+    {
+        return adopt(data, size, size, deleter, options);
+    }
+
+    auto AlignedBuffer::adopt(pointer  data, size_type  size, size_type  capacity, Deleter  deleter, const BufferOptions  &options) noexcept -> AlignedBuffer
+    {
+        auto buffer = AlignedBuffer{};
+        buffer._options = options;
+        if(data)
+        {
+            buffer._data      = data;
+            buffer._size      = size;
+            buffer._capacity  = std::max(capacity, size);
+            //Largest power of two dividing the address
+            buffer._alignment = std::min<size_type>(size_type{1} << std::countr_zero(reinterpret_cast<std::uintptr_t>(data)), page_size);
+            buffer._deleter   = deleter;
+        }
+        return buffer;
+    }
+
+    auto AlignedBuffer::data() noexcept -> pointer
+    {
+        return _data;
+    }
+
+    auto AlignedBuffer::data() const noexcept -> const_pointer
+    {
+        return _data;
+    }
+
+    auto AlignedBuffer::size() const noexcept -> size_type
+    {
+        return _size;
+    }
+
+    auto AlignedBuffer::capacity() const noexcept -> size_type
+    {
+        return _capacity;
+    }
+
+    auto AlignedBuffer::empty() const noexcept -> bool
+    {
+        return _size == 0;
+    }
+
+    auto AlignedBuffer::alignment() const noexcept -> size_type
+    {
+        return _alignment;
+    }
+
+    auto AlignedBuffer::options() const noexcept -> const BufferOptions&
+    {
+        return _options;
+    }
+
+    auto AlignedBuffer::begin() noexcept -> iterator
+    {
+        return _data;
+    }
+
+    auto AlignedBuffer::end() noexcept -> iterator
+    {
+        return _data + _size;
+    }
+
+    auto AlignedBuffer::begin() const noexcept -> const_iterator
+    {
+        return _data;
+    }
+
+    auto AlignedBuffer::end() const noexcept -> const_iterator
+    {
+        return _data + _size;
+    }
+
+    auto AlignedBuffer::operator[](size_type  index) noexcept -> reference
+    {
+        return _data[index];
+    }
+
+    auto AlignedBuffer::operator[](size_type  index) const noexcept -> const_reference
+    {
+        return _data[index];
+    }
+
+    void AlignedBuffer::resize(size_type  size)
+    {
+        reserve(size);
+        if(size > _size && _options.zero_fill) {
+            std::memset(_data + _size, 0, size - _size);
+        }
+        _size = size;
+    }
+
+    void AlignedBuffer::reserve(size_type  capacity)
+    {
+        if(capacity <= _capacity) {
+            return;
+        }
+
+        //The old memory is released by grown after the swap, also when it was adopted
+        auto grown = AlignedBuffer{};
+        grown._options = _options;
+        grown.allocate(capacity);
+        if(_data) {
+            std::memcpy(grown._data, _data, _size);
+        }
+        grown._size = _size;
+        swap(grown);
+    }
+
+    void AlignedBuffer::clear() noexcept
+    {
+        _size = 0;
+    }
+
+    void AlignedBuffer::swap(AlignedBuffer  &other) noexcept
+    {
+        std::swap(_data, other._data);
+        std::swap(_size, other._size);
+        std::swap(_capacity, other._capacity);
+        std::swap(_alignment, other._alignment);
+        std::swap(_options, other._options);
+        std::swap(_deleter, other._deleter);
+    }
+
+    void AlignedBuffer::allocate(size_type  capacity)
+    {
+        _alignment = allocation_alignment(capacity, _options);
+        //Whole alignment units, so SIMD loads of the last row stay inside the allocation
+        _capacity  = (capacity + _alignment - 1) / _alignment * _alignment;
+        _data      = static_cast<pointer>( ::operator new(_capacity, std::align_val_t{_alignment}) );
+
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+        if(_options.huge_pages && _capacity >= _options.huge_page_threshold) {
+            //Only a hint, the buffer works with normal pages if the kernel declines
+            madvise(_data, _capacity, MADV_HUGEPAGE);
+        }
+#endif
+    }
+
+    void AlignedBuffer::release() noexcept
+    {
+        if(_data && _deleter) {
+            _deleter(_data);
+        }
+        else if(_data) {
+            ::operator delete(_data, std::align_val_t{_alignment});
+        }
+        _data = nullptr;
+        _deleter = nullptr;
+        _size = 0;
+        _capacity = 0;
+    }
+
+    auto operator==(const AlignedBuffer  &lhs, const AlignedBuffer  &rhs) noexcept -> bool
+    {
+        return lhs.size() == rhs.size() && std::equal(lhs.begin(), lhs.end(), rhs.begin());
+    }
+
+    auto operator!=(const AlignedBuffer  &lhs, const AlignedBuffer  &rhs) noexcept -> bool
+    {
+        return !(lhs == rhs);
+    }
+} // namespace nitros::utils
@@ -0,0 +1,111 @@
+#ifndef NITROS_IMAGE_CODEC_INTERNAL_HPP
+#define NITROS_IMAGE_CODEC_INTERNAL_HPP
+
+#include "image/image.hpp"
+#include "image/image_view.hpp"
+#include "image/utils.hpp"
+#include <gsl/span>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+
+//Pieces of the file formats implemented in this library, shared by their readers and writers
+namespace nitros::utils::image::detail
+{
+    //Copies every plane of source into target, both of the same size and format
+    inline void copy_planes(const ConstImageView  &source, const ImageView  &target)
+    {
+        auto &meta = target.meta_data();
+        for(auto i = std::size_t{0}; i < meta.steps.size(); i++)
+        {
+            auto row_bytes = plane_row_bytes(meta, i);
+            auto rows = interpreted_plane_img_size(meta, i).height;
+            for(auto y = std::size_t{0}; y < rows; y++) {
+                std::memcpy(target.row(y, i), source.row(y, i), row_bytes);
+            }
+        }
+    }
+
+    struct PnmHeader
+    {
+        ImgSize        size;
+        pixel::Format  format;
+        std::size_t    data_offset;
+        std::size_t    max_value;      //Samples are scaled from 0..max_value to the full range of format
+    };
+
+    /**
+     * Parses a binary Netpbm header from the start of data, the samples are not looked at
+     * @returns nullopt if data ends before the header does
+     * @throws std::runtime_error if the header is malformed
+     * */
+    auto parse_pnm_header(gsl::span<const std::uint8_t>  data) -> std::optional<PnmHeader>;
+
+    //Copies rows [first_row, first_row + rows) from consecutive file rows at in, 16 bit samples are byte swapped
+    void pnm_rows_in(const std::uint8_t  *in, const PnmHeader  &header, const ImageView  &target, std::size_t  first_row, std::size_t  rows);
+
+    struct QoiHeader
+    {
+        ImgSize        size;
+        std::uint8_t   channels;
+    };
+
+    constexpr auto qoi_header_bytes = std::size_t{14};
+
+    struct QoiPixel
+    {
+        std::uint8_t  r, g, b, a;
+    };
+
+    //@throws std::runtime_error if the qoi_header_bytes at data are not a valid header
+    auto parse_qoi_header(const std::uint8_t  *data) -> QoiHeader;
+
+    /**
+     * State of the QOI op stream, resumable at any op boundary.
+     * Pixels are written as RGB or RGBA bytes, whatever the channel count of the file
+     * */
+    class QoiDecoder
+    {
+        public:
+        explicit QoiDecoder(std::uint8_t  channels) noexcept : _channels{channels} {}
+
+        /**
+         * Decodes up to count pixels to out from the ops in [in, end), stops early before an op that is not complete.
+         * in is advanced past the ops used
+         * @returns the number of pixels written
+         * */
+        auto decode(const std::uint8_t  *&in, const std::uint8_t  *end, std::uint8_t  *out, std::size_t  count) noexcept -> std::size_t;
+
+        private:
+        std::uint8_t              _channels;
+        std::size_t               _run = 0;
+        QoiPixel                  _prev{0, 0, 0, 255};
+        std::array<QoiPixel, 64>  _index{};
+    };
+
+    //Planes of a raw container start at this offset in the create_cpu buffer layout
+    constexpr auto raw_data_offset = std::size_t{4096};
+
+    constexpr auto raw_header_size = std::size_t{512};
+
+    struct RawHeader
+    {
+        ImageMetaData  meta_data;
+        std::size_t    data_offset;
+        std::size_t    data_bytes;
+    };
+
+    //Writes the raw container header for meta_data to the first raw_header_size bytes at out
+    void write_raw_header(std::uint8_t  *out, const ImageMetaData  &meta_data);
+
+    /**
+     * Parses the raw_header_size bytes at in. The format must be a predefined one and every step must hold its row
+     * with all rows of the plane inside data_bytes, the data itself is not checked
+     * @throws std::runtime_error if they are not a valid header
+     * */
+    auto read_raw_header(const std::uint8_t  *in) -> RawHeader;
+} // namespace nitros::utils::image::detail
+
+#endif
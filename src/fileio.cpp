@@ -1,88 +1,1113 @@
 
 
 #include "image/image.hpp"
+#include <cstddef>
+
+namespace nitros::utils::image::detail
+{
+    void* stb_malloc(std::size_t  size);
+    void* stb_realloc(void  *ptr, std::size_t  size);
+    void  stb_free(void  *ptr);
+}
+
+//stb allocations are 64 byte aligned blocks, taken from a DecodeScratch while one is passed to the decode
+#define STBI_MALLOC(size)       ::nitros::utils::image::detail::stb_malloc(size)
+#define STBI_REALLOC(ptr, size) ::nitros::utils::image::detail::stb_realloc(ptr, size)
+#define STBI_FREE(ptr)          ::nitros::utils::image::detail::stb_free(ptr)
 #define STB_IMAGE_IMPLEMENTATION
 #define STB_IMAGE_WRITE_IMPLEMENTATION
 #include <stb/stb_image.h>
 #include <stb/stb_image_write.h>
 #include "image/fileio.hpp"
+#include "image/mapped_buffer.hpp"
+#include "image/utils.hpp"
+#include "codec_internal.hpp"
+#include "image/process/converter.hpp"
 #include <gsl/gsl>
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <shared_mutex>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
 
 namespace nitros::utils::image
 {
+    namespace detail
+    {
+        namespace
+        {
+            //Blocks carry their capacity in front of the data, the header keeps the 64 byte alignment ImgBufferCpu promises
+            constexpr auto block_alignment = std::size_t{64};
+            constexpr auto header_bytes = block_alignment;
+            constexpr auto max_scratch_blocks = std::size_t{16};
+
+            void free_block(void  *ptr)
+            {
+                ::operator delete(static_cast<std::uint8_t*>(ptr) - header_bytes, std::align_val_t{block_alignment});
+            }
+
+            auto capacity_of(void  *ptr) -> std::size_t&
+            {
+                return *reinterpret_cast<std::size_t*>(static_cast<std::uint8_t*>(ptr) - header_bytes);
+            }
+
+            //Rounded up so frames whose decoder buffers differ by a few bytes still share blocks
+            auto block_capacity(std::size_t  size) -> std::size_t
+            {
+                auto granule = size < 4096 ? std::size_t{64} : std::size_t{4096};
+                return (size + granule - 1) / granule * granule;
+            }
+
+            //Blocks retained by a DecodeScratch, fixed slots so returning a block never allocates
+            struct ScratchBlocks
+            {
+                explicit ScratchBlocks(std::size_t  max_bytes_)
+                    :max_bytes{max_bytes_}
+                {}
+                ScratchBlocks(const ScratchBlocks&) = delete;
+                ~ScratchBlocks()
+                {
+                    release();
+                }
+
+                auto operator=(const ScratchBlocks&) -> ScratchBlocks& = delete;
+
+                auto take(std::size_t  capacity) noexcept -> void*
+                {
+                    for(auto i = std::size_t{0}; i < count; i++)
+                    {
+                        auto block = blocks[i];
+                        if(capacity_of(block) == capacity) {
+                            blocks[i] = blocks[--count];
+                            bytes -= capacity;
+                            return block;
+                        }
+                    }
+                    return nullptr;
+                }
+
+                auto keep(void  *block) noexcept -> bool
+                {
+                    auto capacity = capacity_of(block);
+                    if(count == blocks.size() || bytes + capacity > max_bytes) {
+                        return false;
+                    }
+                    blocks[count++] = block;
+                    bytes += capacity;
+                    return true;
+                }
+
+                void release() noexcept
+                {
+                    for(auto i = std::size_t{0}; i < count; i++) {
+                        free_block(blocks[i]);
+                    }
+                    count = 0;
+                    bytes = 0;
+                }
+
+                std::array<void*, max_scratch_blocks>  blocks{};
+                std::size_t  count = 0;
+                std::size_t  bytes = 0;
+                std::size_t  max_bytes;
+            };
+
+            //stb has no allocator context, the scratch of the decode running on this thread is passed here
+            thread_local ScratchBlocks  *active_scratch = nullptr;
+
+            //Routes stb allocations of this thread to scratch while in scope, nullptr allocates and frees plainly
+            class ScratchScope
+            {
+                public:
+                explicit ScratchScope(ScratchBlocks  *scratch) noexcept
+                    :_previous{std::exchange(active_scratch, scratch)}
+                {}
+                ScratchScope(const ScratchScope&) = delete;
+                ~ScratchScope()
+                {
+                    active_scratch = _previous;
+                }
+
+                auto operator=(const ScratchScope&) -> ScratchScope& = delete;
+
+                private:
+                ScratchBlocks  *_previous;
+            };
+        } // namespace
+
+        void* stb_malloc(std::size_t  size)
+        {
+            auto capacity = block_capacity(size);
+            if(active_scratch) {
+                if(auto block = active_scratch->take(capacity)) {
+                    return block;
+                }
+            }
+
+            auto raw = static_cast<std::uint8_t*>(::operator new(header_bytes + capacity, std::align_val_t{block_alignment}, std::nothrow));
+            if(!raw) {
+                return nullptr;
+            }
+            *reinterpret_cast<std::size_t*>(raw) = capacity;
+            return raw + header_bytes;
+        }
+
+        void stb_free(void  *ptr)
+        {
+            if(!ptr) {
+                return;
+            }
+            if(active_scratch && active_scratch->keep(ptr)) {
+                return;
+            }
+            free_block(ptr);
+        }
+
+        void* stb_realloc(void  *ptr, std::size_t  size)
+        {
+            if(!ptr) {
+                return stb_malloc(size);
+            }
+            auto capacity = capacity_of(ptr);
+            if(size <= capacity) {
+                return ptr;
+            }
+
+            auto grown = stb_malloc(size);
+            if(!grown) {
+                return nullptr;
+            }
+            std::memcpy(grown, ptr, capacity);
+            stb_free(ptr);
+            return grown;
+        }
+    } // namespace detail
+
+    namespace
+    {
+        //jpg and bmp writers take no row stride, rows of a region view are packed first
+        auto packed_rows(const ConstImageView  &source_image, std::vector<std::uint8_t>  &storage) -> const std::uint8_t*
+        {
+            auto &meta = source_image.meta_data();
+            auto row_bytes = plane_row_bytes(meta, 0);
+            if(meta.steps[0] == row_bytes) {
+                return source_image.plane(0);
+            }
+
+            storage.resize(row_bytes * meta.size.height);
+            for(auto y = std::size_t{0}; y < meta.size.height; y++) {
+                std::memcpy(storage.data() + y * row_bytes, source_image.row(y), row_bytes);
+            }
+            return storage.data();
+        }
+
+        /**
+         * stb returns tightly packed rows, which is the ImageCpu layout of 8 and 16 bit interleaved formats,
+         * so the decoded pixels become the image buffer without a second allocation
+         * */
+        auto adopt_decoded(void  *data, int  width, int  height, pixel::Format  format) -> ImageCpu
+        {
+            if(!data) {
+                throw std::runtime_error(std::string{"Image decoding failed: "} + stbi_failure_reason());
+            }
+            auto owned = std::unique_ptr<void, void (*)(void*)>{data, stbi_image_free};
+
+            auto size = ImgSize{gsl::narrow_cast<std::size_t>(width), gsl::narrow_cast<std::size_t>(height)};
+            auto meta_data = ImageMetaData{size, format};
+            auto packed_step = size.width * format.pixel_layout.bytes / format.pixel_layout.group_pixels;
+            auto bytes = buffer_size(meta_data);
+
+            if(meta_data.steps.at(0) == packed_step) {
+                //Blocks are 64 byte aligned and whole 64 byte units, like the buffers ImgBufferCpu allocates itself
+                auto capacity = detail::capacity_of(owned.get());
+                auto buffer = ImgBufferCpu::adopt(static_cast<std::uint8_t*>(owned.release()), bytes, capacity, stbi_image_free);
+                return ImageCpu{std::move(meta_data), std::move(buffer)};
+            }
+
+            //Padded rows, copy into a correctly strided buffer
+            auto created_image = create_cpu(size, format);
+            auto packed = static_cast<std::uint8_t*>(owned.get());
+            assign(size, packed_step, {packed, gsl::narrow_cast<std::ptrdiff_t>(packed_step * size.height)}, meta_data.steps.at(0), created_image.buffer());
+            return created_image;
+        }
+
+        //Layouts stb produces, grey with alpha is widened to RGBA as no Format describes it
+        auto stb_format(int  channels, bool  is_16_bit) -> pixel::Format
+        {
+            switch(channels) {
+                case 1:  return is_16_bit ? pixel::GREY16::value : pixel::GREY8::value;
+                case 3:  return is_16_bit ? pixel::RGB16::value  : pixel::RGB8::value;
+                default: return is_16_bit ? pixel::RGBA16::value : pixel::RGBA8::value;
+            }
+        }
+
+        /**
+         * Format stb decodes to for the requested one, BGR orders share the RGB layout and are swapped in place.
+         * Anything stb cannot produce is decoded to 8 bit RGB(A) and converted afterwards
+         * */
+        auto decode_format(const DecodeOptions  &options, int  file_channels, bool  file_is_16_bit) -> pixel::Format
+        {
+            if(!options.format) {
+                return stb_format(file_channels, file_is_16_bit);
+            }
+
+            auto &target = *options.format;
+            static const auto direct = std::array<pixel::Format, 10>{
+                pixel::GREY8::value, pixel::GREY16::value,
+                pixel::RGB8::value,  pixel::RGB16::value,  pixel::RGBA8::value, pixel::RGBA16::value,
+                pixel::BGR8::value,  pixel::BGR16::value,  pixel::BGRA8::value, pixel::BGRA16::value
+            };
+            if(std::find(direct.begin(), direct.end(), target) != direct.end()) {
+                return target;
+            }
+
+            auto has_alpha = target.pixel_type == pixel::type::rgba || target.pixel_type == pixel::type::bgra || target.pixel_type == pixel::type::yuva;
+            return has_alpha ? pixel::RGBA8::value : pixel::RGB8::value;
+        }
+
+        template <typename sample_type_>
+        void swap_red_blue(const ImageView  &image)
+        {
+            auto &meta = image.meta_data();
+            auto channels = meta.format.pixel_layout.channels;
+            for(auto y = std::size_t{0}; y < meta.size.height; y++)
+            {
+                auto row = reinterpret_cast<sample_type_*>(image.row(y));
+                for(auto x = std::size_t{0}; x < meta.size.width; x++) {
+                    std::swap(row[x * channels], row[x * channels + 2]);
+                }
+            }
+        }
+
+        auto is_16_bit(const pixel::Format  &format) -> bool
+        {
+            return format.pixel_layout.bytes == format.pixel_layout.channels * 2;
+        }
+
+        //stb orders channels as RGB, BGR formats are swapped in place after decoding
+        void reorder_decoded(const ImageView  &image)
+        {
+            auto type = image.meta_data().format.pixel_type;
+            if(type != pixel::type::bgr && type != pixel::type::bgra) {
+                return;
+            }
+            is_16_bit(image.meta_data().format) ? swap_red_blue<std::uint16_t>(image) : swap_red_blue<std::uint8_t>(image);
+        }
+
+        auto sniff_file_format(const std::uint8_t  *head, std::size_t  size) -> FileFormat
+        {
+            auto starts_with = [&](std::initializer_list<std::uint8_t>  magic) {
+                return size >= magic.size() && std::equal(magic.begin(), magic.end(), head);
+            };
+
+            if(starts_with({0x89, 'P', 'N', 'G'}))  return FileFormat::png;
+            if(starts_with({0xFF, 0xD8, 0xFF}))     return FileFormat::jpg;
+            if(starts_with({'B', 'M'}))             return FileFormat::bmp;
+            if(starts_with({'G', 'I', 'F', '8'}))   return FileFormat::gif;
+            if(starts_with({'8', 'B', 'P', 'S'}))   return FileFormat::psd;
+            if(starts_with({'#', '?'}))             return FileFormat::hdr;
+            if(starts_with({0x53, 0x80, 0xF6, 0x34})) return FileFormat::pic;
+            if(starts_with({'q', 'o', 'i', 'f'}))   return FileFormat::qoi;
+            if(size >= 2 && head[0] == 'P' && head[1] >= '5' && head[1] <= '7') return FileFormat::pnm;
+            //TGA has no signature, it is what stb accepted when nothing else matched
+            return FileFormat::tga;
+        }
+
+        //stb entry points for files and memory behind one interface, so both decode through the same path
+        class FileSource
+        {
+            public:
+            //The file is opened once, header checks and the decode all read it through the same stdio buffer
+            explicit FileSource(const std::string  &path)
+                :_file{std::fopen(path.c_str(), "rb"), std::fclose}
+            {
+                if(!_file) {
+                    throw std::runtime_error("Cannot open " + path);
+                }
+            }
+
+            auto info(int  *width, int  *height, int  *channels) const -> bool { return stbi_info_from_file(rewound(), width, height, channels) != 0; }
+            auto is_16_bit() const -> bool { return stbi_is_16_bit_from_file(rewound()) != 0; }
+            auto load(int  *width, int  *height, int  *channels, int  req_comp) const -> void* { return stbi_load_from_file(rewound(), width, height, channels, req_comp); }
+            auto load_16(int  *width, int  *height, int  *channels, int  req_comp) const -> void* { return stbi_load_from_file_16(rewound(), width, height, channels, req_comp); }
+            auto file_format() const -> FileFormat
+            {
+                auto head = std::array<std::uint8_t, 4>{};
+                auto size = std::fread(head.data(), 1, head.size(), rewound());
+                return sniff_file_format(head.data(), size);
+            }
+
+            private:
+            //stb reads from the current position, every call starts over at the beginning of the file
+            auto rewound() const -> std::FILE*
+            {
+                std::rewind(_file.get());
+                return _file.get();
+            }
+
+            std::unique_ptr<std::FILE, int (*)(std::FILE*)>  _file;
+        };
+
+        struct MemorySource
+        {
+            auto info(int  *width, int  *height, int  *channels) const -> bool { return stbi_info_from_memory(data.data(), length(), width, height, channels) != 0; }
+            auto is_16_bit() const -> bool { return stbi_is_16_bit_from_memory(data.data(), length()) != 0; }
+            auto load(int  *width, int  *height, int  *channels, int  req_comp) const -> void* { return stbi_load_from_memory(data.data(), length(), width, height, channels, req_comp); }
+            auto load_16(int  *width, int  *height, int  *channels, int  req_comp) const -> void* { return stbi_load_16_from_memory(data.data(), length(), width, height, channels, req_comp); }
+            //stb takes the length as int
+            auto length() const -> int
+            {
+                if(data.size_bytes() > std::numeric_limits<int>::max()) {
+                    throw std::length_error("Encoded image data of 2 GiB or more cannot be decoded from memory");
+                }
+                return gsl::narrow_cast<int>(data.size_bytes());
+            }
+            auto file_format() const -> FileFormat { return sniff_file_format(data.data(), gsl::narrow_cast<std::size_t>(data.size_bytes())); }
+
+            gsl::span<const std::uint8_t>  data;
+        };
+
+        //What stb is asked to produce and how it reaches the requested format, resolved from the header alone
+        struct DecodePlan
+        {
+            ImgSize        size;
+            pixel::Format  format;
+            std::size_t    scale;
+            nitros::image::ConversionPlan  conversion;
+        };
+
+        //Only what decoding needs, probing the file format is left to probe_image
+        template <typename source_type_>
+        auto read_header(const source_type_  &source) -> ImageInfo
+        {
+            int width, height, channels;
+            if(!source.info(&width, &height, &channels)) {
+                throw std::runtime_error(std::string{"Image probing failed: "} + stbi_failure_reason());
+            }
+
+            auto is_16_bit = source.is_16_bit();
+            return ImageInfo{
+                ImgSize{gsl::narrow_cast<std::size_t>(width), gsl::narrow_cast<std::size_t>(height)},
+                gsl::narrow_cast<std::uint32_t>(channels),
+                is_16_bit ? 16u : 8u,
+                stb_format(channels, is_16_bit),
+                FileFormat::tga
+            };
+        }
+
+        template <typename source_type_>
+        auto probe(const source_type_  &source) -> ImageInfo
+        {
+            auto info = read_header(source);
+            info.file_format = source.file_format();
+            return info;
+        }
+
+        auto reduction_for(const DecodeOptions  &options, ImgSize  size) -> std::size_t
+        {
+            if(options.max_dimension == 0) {
+                if(options.scale_denominator != 1 && options.scale_denominator != 2 && options.scale_denominator != 4 && options.scale_denominator != 8) {
+                    throw std::invalid_argument("Decode scale_denominator must be 1, 2, 4 or 8");
+                }
+                return options.scale_denominator;
+            }
+
+            auto largest = std::max(size.width, size.height);
+            auto scale = std::size_t{1};
+            while(scale < 8 && (largest + scale - 1) / scale > options.max_dimension) {
+                scale *= 2;
+            }
+            return scale;
+        }
+
+        auto reduced_size(ImgSize  size, std::size_t  scale) -> ImgSize
+        {
+            return {(size.width + scale - 1) / scale, (size.height + scale - 1) / scale};
+        }
+
+        //Checks the limits and resolves the reduction and conversion for a decoder producing format at size
+        auto plan_for(ImgSize  size, const pixel::Format  &format, const DecodeOptions  &options) -> DecodePlan
+        {
+            auto scale = reduction_for(options, size);
+
+            //Rejected before the decoder allocates anything for the pixels. Bytes are its full resolution output plus the preview and converted copies made from it
+            if(options.max_pixels != 0 && size.width * size.height > options.max_pixels) {
+                throw std::length_error("Image exceeds the decode pixel limit");
+            }
+            auto converts = options.format && !(*options.format == format);
+            auto output_size = reduced_size(size, scale);
+            auto bytes = buffer_size(ImageMetaData{size, format});
+            if(scale != 1) {
+                bytes += buffer_size(ImageMetaData{output_size, format});
+            }
+            if(converts) {
+                bytes += buffer_size(ImageMetaData{output_size, *options.format});
+            }
+            if(options.max_bytes != 0 && bytes > options.max_bytes) {
+                throw std::length_error("Image exceeds the decode byte limit");
+            }
+
+            auto conversion = nitros::image::ConversionPlan{};
+            if(converts) {
+                conversion = nitros::image::plan_conversion(format, *options.format);
+                if(!conversion) {
+                    throw std::invalid_argument("Decoding to the requested format is not supported");
+                }
+            }
+            return DecodePlan{size, format, scale, std::move(conversion)};
+        }
+
+        template <typename source_type_>
+        auto plan_decode(const source_type_  &source, const DecodeOptions  &options) -> DecodePlan
+        {
+            auto info = read_header(source);
+            return plan_for(info.size, decode_format(options, gsl::narrow_cast<int>(info.channels), info.bit_depth == 16), options);
+        }
+
+        //stb converts channel count and bit depth while decoding
+        template <typename source_type_>
+        auto load(const source_type_  &source, const DecodePlan  &plan) -> void*
+        {
+            int width, height, channels;
+            auto req_comp = gsl::narrow_cast<int>(plan.format.pixel_layout.channels);
+            auto *data = is_16_bit(plan.format) ? source.load_16(&width, &height, &channels, req_comp) : source.load(&width, &height, &channels, req_comp);
+            if(data && ImgSize{gsl::narrow_cast<std::size_t>(width), gsl::narrow_cast<std::size_t>(height)} != plan.size) {
+                stbi_image_free(data);
+                throw std::runtime_error("Image decoding failed: size differs from the header");
+            }
+            return data;
+        }
+
+        using DecodedData = std::unique_ptr<void, void (*)(void*)>;
+
+        template <typename source_type_>
+        auto load_owned(const source_type_  &source, const DecodePlan  &plan) -> DecodedData
+        {
+            auto *data = load(source, plan);
+            if(!data) {
+                throw std::runtime_error(std::string{"Image decoding failed: "} + stbi_failure_reason());
+            }
+            return DecodedData{data, stbi_image_free};
+        }
+
+        //stb rows are packed, the view describes them without the aligned steps of ImageMetaData
+        auto packed_view(const DecodedData  &data, const DecodePlan  &plan) -> ImageView
+        {
+            auto meta_data = ImageMetaData{plan.size, plan.format};
+            meta_data.steps[0] = plane_row_bytes(meta_data, 0);
+            return ImageView{meta_data, {static_cast<std::uint8_t*>(data.get())}};
+        }
+
+        /**
+         * Averages scale x scale blocks of src into dst, blocks on the right and bottom edges may be partial.
+         * Rows are summed into one accumulator row, so src is read once top to bottom
+         * */
+        template <typename sample_type_>
+        void box_reduce(const ConstImageView  &src, const ImageView  &dst, std::size_t  scale)
+        {
+            auto channels = src.meta_data().format.pixel_layout.channels;
+            auto src_size = src.size();
+            auto sums = std::vector<std::uint32_t>(dst.size().width * channels);
+
+            for(auto out_y = std::size_t{0}; out_y < dst.size().height; out_y++)
+            {
+                std::fill(sums.begin(), sums.end(), 0u);
+                auto first_row = out_y * scale;
+                auto last_row  = std::min(first_row + scale, src_size.height);
+                for(auto y = first_row; y < last_row; y++)
+                {
+                    auto row = reinterpret_cast<const sample_type_*>(src.row(y));
+                    for(auto x = std::size_t{0}; x < src_size.width; x++) {
+                        auto sum = sums.data() + x / scale * channels;
+                        for(auto c = std::size_t{0}; c < channels; c++) {
+                            sum[c] += row[x * channels + c];
+                        }
+                    }
+                }
+
+                auto out = reinterpret_cast<sample_type_*>(dst.row(out_y));
+                for(auto out_x = std::size_t{0}; out_x < dst.size().width; out_x++)
+                {
+                    auto block_width = std::min(scale, src_size.width - out_x * scale);
+                    auto count = static_cast<std::uint32_t>(block_width * (last_row - first_row));
+                    for(auto c = std::size_t{0}; c < channels; c++) {
+                        out[out_x * channels + c] = static_cast<sample_type_>((sums[out_x * channels + c] + count / 2) / count);
+                    }
+                }
+            }
+        }
+
+        auto reduce(const ConstImageView  &full, const DecodePlan  &plan) -> ImageCpu
+        {
+            auto reduced = create_cpu(reduced_size(plan.size, plan.scale), plan.format);
+            is_16_bit(plan.format) ? box_reduce<std::uint16_t>(full, view(reduced), plan.scale) : box_reduce<std::uint8_t>(full, view(reduced), plan.scale);
+            return reduced;
+        }
+
+        auto convert(ImageCpu  &&image, const DecodePlan  &plan, const DecodeOptions  &options) -> ImageCpu
+        {
+            if(!plan.conversion) {
+                return std::move(image);
+            }
+            auto converted = create_cpu(image.meta_data().size, *options.format);
+            plan.conversion(view(std::as_const(image)), view(converted));
+            return converted;
+        }
+
+        //Decoder memory comes from scratch if set, previews return their full resolution pixels to it
+        template <typename source_type_>
+        auto decode(const source_type_  &source, const DecodeOptions  &options, detail::ScratchBlocks  *scratch = nullptr) -> ImageCpu
+        {
+            auto scope = detail::ScratchScope{scratch};
+            auto plan = plan_decode(source, options);
+
+            auto image = [&]() {
+                if(plan.scale == 1) {
+                    auto full = adopt_decoded(load(source, plan), gsl::narrow_cast<int>(plan.size.width), gsl::narrow_cast<int>(plan.size.height), plan.format);
+                    reorder_decoded(view(full));
+                    return full;
+                }
+
+                //stb cannot scale while decoding, the full resolution pixels are freed once reduced, into the scratch if there is one
+                auto data = load_owned(source, plan);
+                auto decoded = packed_view(data, plan);
+                reorder_decoded(decoded);
+                return reduce(decoded, plan);
+            }();
+            return convert(std::move(image), plan, options);
+        }
+
+        //Decoder memory comes from scratch if set, the scope is entered before the data is loaded so the data returns to it
+        template <typename source_type_>
+        void decode_into(const source_type_  &source, const ImageView  &target, detail::ScratchBlocks  *scratch = nullptr)
+        {
+            auto scope = detail::ScratchScope{scratch};
+            auto plan = plan_decode(source, DecodeOptions{target.meta_data().format});
+            if(plan.size != target.size()) {
+                throw std::invalid_argument("Decoded image size does not match the target image");
+            }
+
+            auto data = load_owned(source, plan);
+            auto decoded = packed_view(data, plan);
+            reorder_decoded(decoded);
+
+            if(plan.conversion) {
+                plan.conversion(decoded, target);
+                return;
+            }
+            for(auto y = std::size_t{0}; y < plan.size.height; y++) {
+                std::memcpy(target.row(y), decoded.row(y), decoded.meta_data().steps[0]);
+            }
+        }
+    } // namespace
+
+    auto probe_image(const std::string& full_source_path) -> ImageInfo
+    {
+        return probe(FileSource{full_source_path});
+    }
+
+    auto probe_image(const gsl::span<std::uint8_t>  &data) -> ImageInfo
+    {
+        return probe(MemorySource{data});
+    }
+
     // read image
     ImageCpu read_image(const std::string& full_source_path)
     {
-        int width, height, channels;
+        return read_image(full_source_path, DecodeOptions{pixel::RGBA8::value});
+    }
 
-        //read the image from the given source path
-        auto *image_data_ptr = stbi_load(full_source_path.c_str(), &width, &height, &channels, 4);
+    ImageCpu  decode_image(const gsl::span<std::uint8_t>  &data)
+    {
+        return decode_image(data, DecodeOptions{pixel::RGBA8::value});
+    }
 
-        //create an image that is of the same size as the source image
-        // it returns a buffer of the same size
-        auto created_image = nitros::utils::image::create_cpu({gsl::narrow_cast<std::size_t>(width), gsl::narrow_cast<std::size_t>(height)}, nitros::utils::pixel::RGBA8::value);
+    ImageCpu read_image(const std::string& full_source_path, const DecodeOptions& options)
+    {
+        //read the image from the given source path, stb decodes straight into the buffer the image takes over
+        return decode(FileSource{full_source_path}, options);
+    }
 
-        auto rgba8_format = pixel::RGBA8::value;
+    ImageCpu decode_image(const gsl::span<std::uint8_t>  &data, const DecodeOptions& options)
+    {
+        return decode(MemorySource{data}, options);
+    }
 
-        //assign the contents of the read image to the newly created empty image of the same size
-        nitros::utils::image::assign({gsl::narrow_cast<std::size_t>(width), gsl::narrow_cast<std::size_t>(height)}, 
-                                      width * rgba8_format.pixel_layout.bytes/rgba8_format.pixel_layout.group_pixels, 
-                                      {image_data_ptr, gsl::narrow_cast<std::ptrdiff_t>(width * height * rgba8_format.pixel_layout.bytes/rgba8_format.pixel_layout.group_pixels)},
-                                      created_image.meta_data().steps.at(0),
-                                      created_image.buffer() );
-        delete image_data_ptr;
-        return created_image;
+    void read_image(const std::string& full_source_path, const ImageView& target_image)
+    {
+        decode_into(FileSource{full_source_path}, target_image);
     }
 
-    ImageCpu  decode_image(const gsl::span<std::uint8_t>  &data)
+    void decode_image(const gsl::span<std::uint8_t>  &data, const ImageView& target_image)
+    {
+        decode_into(MemorySource{data}, target_image);
+    }
+
+    void read_image(const std::string& full_source_path, ImageCpu& target_image)
+    {
+        decode_into(FileSource{full_source_path}, view(target_image));
+    }
+
+    void decode_image(const gsl::span<std::uint8_t>  &data, ImageCpu& target_image)
+    {
+        decode_into(MemorySource{data}, view(target_image));
+    }
+
+    struct DecodeScratch::State
+    {
+        explicit State(std::size_t  max_bytes)
+            :blocks{max_bytes}
+        {}
+
+        detail::ScratchBlocks  blocks;
+    };
+
+    DecodeScratch::DecodeScratch(std::size_t  max_bytes)
+        :_state{std::make_unique<State>(max_bytes)}
+    {}
+
+    DecodeScratch::DecodeScratch(DecodeScratch&&) noexcept = default;
+    DecodeScratch::~DecodeScratch() = default;
+    auto DecodeScratch::operator=(DecodeScratch&&) noexcept -> DecodeScratch& = default;
+
+    auto DecodeScratch::max_bytes() const noexcept -> std::size_t
+    {
+        return _state->blocks.max_bytes;
+    }
+
+    auto DecodeScratch::retained_bytes() const noexcept -> std::size_t
     {
-        int width, height, channels;
-        auto *image_data_ptr = stbi_load_from_memory(data.data(), data.size_bytes(), &width, &height, &channels, 4);
+        return _state->blocks.bytes;
+    }
+
+    void DecodeScratch::release() noexcept
+    {
+        _state->blocks.release();
+    }
+
+    void read_image(const std::string& full_source_path, const ImageView& target_image, DecodeScratch& scratch)
+    {
+        decode_into(FileSource{full_source_path}, target_image, &scratch._state->blocks);
+    }
 
-        auto created_image = nitros::utils::image::create_cpu({gsl::narrow_cast<std::size_t>(width), gsl::narrow_cast<std::size_t>(height)}, nitros::utils::pixel::RGBA8::value);
+    void decode_image(const gsl::span<std::uint8_t>  &data, const ImageView& target_image, DecodeScratch& scratch)
+    {
+        decode_into(MemorySource{data}, target_image, &scratch._state->blocks);
+    }
 
-        auto rgba8_format = pixel::RGBA8::value;
+    ImageCpu read_image(const std::string& full_source_path, const DecodeOptions& options, DecodeScratch& scratch)
+    {
+        return decode(FileSource{full_source_path}, options, &scratch._state->blocks);
+    }
 
-        //assign the contents of the read image to the newly created empty image of the same size
-        nitros::utils::image::assign({gsl::narrow_cast<std::size_t>(width), gsl::narrow_cast<std::size_t>(height)}, 
-                                      width * rgba8_format.pixel_layout.bytes/rgba8_format.pixel_layout.group_pixels, 
-                                      {image_data_ptr, gsl::narrow_cast<std::ptrdiff_t>(width * height * rgba8_format.pixel_layout.bytes/rgba8_format.pixel_layout.group_pixels)},
-                                      created_image.meta_data().steps.at(0),
-                                      created_image.buffer() );
-        delete image_data_ptr;
-        return created_image;
+    ImageCpu decode_image(const gsl::span<std::uint8_t>  &data, const DecodeOptions& options, DecodeScratch& scratch)
+    {
+        return decode(MemorySource{data}, options, &scratch._state->blocks);
+    }
+
+    namespace
+    {
+        //stb takes 1 to 4 interleaved 8 bit channels
+        auto encode_channels(const ConstImageView  &source_image) -> int
+        {
+            auto &format = source_image.meta_data().format;
+            if(format.planar_info.is_planar || format.pixel_layout.bytes != format.pixel_layout.channels || format.pixel_layout.channels > 4) {
+                throw std::invalid_argument("Encoding needs 1 to 4 interleaved 8 bit channels");
+            }
+            return gsl::narrow_cast<int>(format.pixel_layout.channels);
+        }
+
+        void write_to_sink(void  *context, void  *data, int  size)
+        {
+            (*static_cast<const EncodeSink*>(context))(static_cast<const std::uint8_t*>(data), gsl::narrow_cast<std::size_t>(size));
+        }
+
+        void check_encoded(int  result, const char  *codec)
+        {
+            if(result == 0) {
+                throw std::runtime_error(std::string{"Image encoding failed: "} + codec);
+            }
+        }
+
+        /**
+         * Compression level and filter are globals of stb_image_write. Encodes with the default settings share
+         * the lock and run in parallel, others set the globals under the exclusive lock and restore them after
+         * */
+        std::shared_mutex png_settings_mutex;
+
+        auto default_png_settings(const EncodeOptions  &options) noexcept -> bool
+        {
+            auto defaults = EncodeOptions{};
+            return options.png_compression == defaults.png_compression && options.png_filter == defaults.png_filter;
+        }
+
+        template <typename encode_fn_>
+        void write_file(const std::string  &full_target_path, encode_fn_  &&encode)
+        {
+            auto file = std::ofstream(full_target_path, std::ios::binary);
+            if(!file) {
+                throw std::runtime_error("Cannot open " + full_target_path);
+            }
+            encode([&file](const std::uint8_t  *data, std::size_t  size) {
+                file.write(reinterpret_cast<const char*>(data), gsl::narrow_cast<std::streamsize>(size));
+            });
+            file.flush();
+            if(!file) {
+                throw std::runtime_error("Cannot write " + full_target_path);
+            }
+        }
+
+        template <typename encode_fn_>
+        auto encode_to_vector(encode_fn_  &&encode, std::size_t  expected_size) -> std::vector<std::uint8_t>
+        {
+            auto encoded = std::vector<std::uint8_t>{};
+            encoded.reserve(expected_size);
+            encode([&encoded](const std::uint8_t  *data, std::size_t  size) {
+                encoded.insert(encoded.end(), data, data + size);
+            });
+            return encoded;
+        }
+    } // namespace
+
+    void encode_png(const ConstImageView& source_image, const EncodeSink& sink, const EncodeOptions& options)
+    {
+        auto channels = encode_channels(source_image);
+        auto &meta = source_image.meta_data();
+
+        auto encode = [&]() {
+            return stbi_write_png_to_func(write_to_sink, const_cast<EncodeSink*>(&sink),
+                                          gsl::narrow_cast<int>(meta.size.width),
+                                          gsl::narrow_cast<int>(meta.size.height),
+                                          channels,
+                                          source_image.plane(0),
+                                          gsl::narrow_cast<int>(meta.steps[0]));
+        };
+
+        if(default_png_settings(options)) {
+            auto lock = std::shared_lock{png_settings_mutex};
+            check_encoded(encode(), "png");
+            return;
+        }
+
+        auto lock = std::unique_lock{png_settings_mutex};
+        auto defaults = EncodeOptions{};
+        stbi_write_png_compression_level = options.png_compression;
+        stbi_write_force_png_filter = static_cast<int>(options.png_filter);
+        auto result = encode();
+        stbi_write_png_compression_level = defaults.png_compression;
+        stbi_write_force_png_filter = static_cast<int>(defaults.png_filter);
+        check_encoded(result, "png");
+    }
+
+    void encode_jpg(const ConstImageView& source_image, const EncodeSink& sink, const EncodeOptions& options)
+    {
+        auto channels = encode_channels(source_image);
+        auto &meta = source_image.meta_data();
+        auto storage = std::vector<std::uint8_t>{};
+        check_encoded(stbi_write_jpg_to_func(write_to_sink, const_cast<EncodeSink*>(&sink),
+                                             gsl::narrow_cast<int>(meta.size.width),
+                                             gsl::narrow_cast<int>(meta.size.height),
+                                             channels,
+                                             packed_rows(source_image, storage),
+                                             std::clamp(options.jpg_quality, 1, 100)), "jpg");
+    }
+
+    void encode_bmp(const ConstImageView& source_image, const EncodeSink& sink)
+    {
+        auto channels = encode_channels(source_image);
+        auto &meta = source_image.meta_data();
+        auto storage = std::vector<std::uint8_t>{};
+        check_encoded(stbi_write_bmp_to_func(write_to_sink, const_cast<EncodeSink*>(&sink),
+                                             gsl::narrow_cast<int>(meta.size.width),
+                                             gsl::narrow_cast<int>(meta.size.height),
+                                             channels,
+                                             packed_rows(source_image, storage)), "bmp");
+    }
+
+    //Compressed sizes are guesses to skip most regrowth, bmp is exact up to the header
+    auto encode_png(const ConstImageView& source_image, const EncodeOptions& options) -> std::vector<std::uint8_t>
+    {
+        auto sink_encode = [&](const EncodeSink  &sink) { encode_png(source_image, sink, options); };
+        return encode_to_vector(sink_encode, plane_row_bytes(source_image.meta_data(), 0) * source_image.size().height / 2);
+    }
+
+    auto encode_jpg(const ConstImageView& source_image, const EncodeOptions& options) -> std::vector<std::uint8_t>
+    {
+        auto sink_encode = [&](const EncodeSink  &sink) { encode_jpg(source_image, sink, options); };
+        return encode_to_vector(sink_encode, plane_row_bytes(source_image.meta_data(), 0) * source_image.size().height / 8);
+    }
+
+    auto encode_bmp(const ConstImageView& source_image) -> std::vector<std::uint8_t>
+    {
+        auto sink_encode = [&](const EncodeSink  &sink) { encode_bmp(source_image, sink); };
+        return encode_to_vector(sink_encode, source_image.size().width * source_image.size().height * 4 + 128);
     }
 
     // write image in png format
-    void write_image_png(const std::string& full_target_path, const ImageCpu& source_image)
+    void write_image_png(const std::string& full_target_path, const ConstImageView& source_image, const EncodeOptions& options)
     {
-        stbi_write_png(full_target_path.c_str(), 
-                       source_image.meta_data().size.width, 
-                       source_image.meta_data().size.height,
-                       source_image.meta_data().format.pixel_layout.channels,
-                       source_image.buffer().data(), 
-                       source_image.meta_data().step);
-    } 
+        write_file(full_target_path, [&](const EncodeSink  &sink) { encode_png(source_image, sink, options); });
+    }
 
     // write image in jpg format
-    void write_image_jpg(const std::string& full_target_path, const ImageCpu& source_image)
+    void write_image_jpg(const std::string& full_target_path, const ConstImageView& source_image, const EncodeOptions& options)
     {
-        stbi_write_jpg(full_target_path.c_str(), 
-                       source_image.meta_data().size.width, 
-                       source_image.meta_data().size.height,
-                       source_image.meta_data().format.pixel_layout.channels,
-                       source_image.buffer().data(), 
-                       100);
+        write_file(full_target_path, [&](const EncodeSink  &sink) { encode_jpg(source_image, sink, options); });
     }
 
     // write image in bmp format
-    void write_image_bmp(const std::string& full_target_path, const ImageCpu& source_image)
+    void write_image_bmp(const std::string& full_target_path, const ConstImageView& source_image)
+    {
+        write_file(full_target_path, [&](const EncodeSink  &sink) { encode_bmp(source_image, sink); });
+    }
+
+    namespace
+    {
+        auto source_of(const std::string  &path) -> FileSource { return FileSource{path}; }
+        auto source_of(const gsl::span<std::uint8_t>  &data) -> MemorySource { return MemorySource{data}; }
+
+        auto rgb_order(const pixel::Format  &format) -> pixel::Format
+        {
+            if(format == pixel::BGR8::value)    return pixel::RGB8::value;
+            if(format == pixel::BGR16::value)   return pixel::RGB16::value;
+            if(format == pixel::BGRA8::value)   return pixel::RGBA8::value;
+            if(format == pixel::BGRA16::value)  return pixel::RGBA16::value;
+            return format;
+        }
+
+        //QOI and Netpbm are decoded by this library, BGR targets of what the decoder writes are swapped in place like stb output
+        auto decode_own(gsl::span<const std::uint8_t>  data, FileFormat  file_format, const DecodeOptions  &options) -> ImageCpu
+        {
+            auto [size, written] = [&]() -> std::pair<ImgSize, pixel::Format> {
+                if(file_format == FileFormat::qoi) {
+                    if(gsl::narrow_cast<std::size_t>(data.size_bytes()) < detail::qoi_header_bytes) {
+                        throw std::runtime_error("Not a QOI image");
+                    }
+                    //The QOI decoder writes RGB or RGBA whatever the file stores
+                    auto header = detail::parse_qoi_header(data.data());
+                    auto requested = options.format ? rgb_order(*options.format) : pixel::RGB8::value;
+                    if(options.format && (requested == pixel::RGB8::value || requested == pixel::RGBA8::value)) {
+                        return {header.size, requested};
+                    }
+                    return {header.size, header.channels == 4 ? pixel::RGBA8::value : pixel::RGB8::value};
+                }
+                auto header = detail::parse_pnm_header(data);
+                if(!header) {
+                    throw std::runtime_error("Netpbm header is truncated");
+                }
+                return {header->size, header->format};
+            }();
+
+            auto format = options.format && rgb_order(*options.format) == written ? *options.format : written;
+            auto plan = plan_for(size, format, options);
+            auto image = create_cpu(size, format);
+            auto meta_data = image.meta_data();
+            meta_data.format = written;
+            auto target = ImageView{meta_data, view(image).planes()};
+            file_format == FileFormat::qoi ? decode_qoi(data, target) : decode_pnm(data, target);
+            reorder_decoded(view(image));
+
+            if(plan.scale != 1) {
+                image = reduce(view(std::as_const(image)), plan);
+            }
+            return convert(std::move(image), plan, options);
+        }
+
+        auto decode_own(const std::string  &path, FileFormat  file_format, const DecodeOptions  &options) -> ImageCpu
+        {
+            auto file = MappedBuffer(path, MapMode::read_only);
+            return decode_own(gsl::span<const std::uint8_t>{file.data(), file.size()}, file_format, options);
+        }
+
+        /**
+         * stb has no QOI or PAM reader and reads Netpbm at 8 bits only, like StreamDecoder batches hand those
+         * to the decoders of this library. Everything else is decoded by stb with its memory from scratch
+         * */
+        template <typename input_type_>
+        auto decode_item(const input_type_  &input, const DecodeOptions  &options, detail::ScratchBlocks  *scratch) -> ImageCpu
+        {
+            auto source = source_of(input);
+            auto file_format = source.file_format();
+            if(file_format == FileFormat::qoi || file_format == FileFormat::pnm) {
+                return decode_own(input, file_format, options);
+            }
+            return decode(source, options, scratch);
+        }
+
+        //Retained like the default DecodeScratch
+        constexpr auto batch_scratch_bytes = std::size_t{64 * 1024 * 1024};
+
+        //Scratch of a batch, a task takes one while it decodes, so there are as many as tasks ran at once
+        class ScratchShelf
+        {
+            public:
+            auto take() -> std::unique_ptr<detail::ScratchBlocks>
+            {
+                auto lock = std::lock_guard{_mutex};
+                if(_free.empty()) {
+                    return std::make_unique<detail::ScratchBlocks>(batch_scratch_bytes);
+                }
+                auto scratch = std::move(_free.back());
+                _free.pop_back();
+                return scratch;
+            }
+
+            void put(std::unique_ptr<detail::ScratchBlocks>  scratch)
+            {
+                auto lock = std::lock_guard{_mutex};
+                _free.push_back(std::move(scratch));
+            }
+
+            private:
+            std::mutex  _mutex;
+            std::vector<std::unique_ptr<detail::ScratchBlocks>>  _free;
+        };
+
+        //Inputs are copied into state shared by the tasks, sources referencing them are made on the worker
+        template <typename input_type_>
+        struct DecodeBatch
+        {
+            std::vector<input_type_>  inputs;
+            ScratchShelf              scratch;
+        };
+
+        template <typename input_type_>
+        auto make_batch(std::vector<input_type_>  &&inputs) -> std::shared_ptr<DecodeBatch<input_type_>>
+        {
+            auto batch = std::make_shared<DecodeBatch<input_type_>>();
+            batch->inputs = std::move(inputs);
+            return batch;
+        }
+
+        template <typename input_type_>
+        auto decode_batch(std::vector<input_type_>  &&inputs, nitros::image::ThreadPool  &pool,
+                          const DecodeOptions  &options, std::size_t  max_parallel) -> std::vector<std::future<ImageCpu>>
+        {
+            auto batch = make_batch(std::move(inputs));
+            return pool.map(batch->inputs.size(), [batch, options](std::size_t  index) {
+                auto scratch = batch->scratch.take();
+                auto image = decode_item(batch->inputs[index], options, scratch.get());
+                batch->scratch.put(std::move(scratch));
+                return image;
+            }, max_parallel);
+        }
+
+        template <typename input_type_>
+        auto decode_batch(std::vector<input_type_>  &&inputs, nitros::image::ThreadPool  &pool, const DecodeCallback  &callback,
+                          const DecodeOptions  &options, std::size_t  max_parallel) -> std::future<void>
+        {
+            auto batch = make_batch(std::move(inputs));
+            return pool.for_each(batch->inputs.size(), [batch, callback, options](std::size_t  index) {
+                auto scratch = batch->scratch.take();
+                auto image = std::optional<ImageCpu>{};
+                auto error = std::exception_ptr{};
+                try {
+                    image.emplace(decode_item(batch->inputs[index], options, scratch.get()));
+                }
+                catch(...) {
+                    error = std::current_exception();
+                }
+
+                //Back on the shelf before the callback, which may take long and keep the image
+                batch->scratch.put(std::move(scratch));
+                if(error) {
+                    callback(index, nullptr, error);
+                    return;
+                }
+                callback(index, &*image, nullptr);
+            }, max_parallel);
+        }
+
+        auto encoder_for(FileFormat  file_format, const EncodeOptions  &options) -> std::function<void(const ConstImageView&, const EncodeSink&)>
+        {
+            switch(file_format) {
+                case FileFormat::png: return [options](const ConstImageView  &image, const EncodeSink  &sink) { encode_png(image, sink, options); };
+                case FileFormat::jpg: return [options](const ConstImageView  &image, const EncodeSink  &sink) { encode_jpg(image, sink, options); };
+                case FileFormat::bmp: return [](const ConstImageView  &image, const EncodeSink  &sink) { encode_bmp(image, sink); };
+                case FileFormat::qoi: return [](const ConstImageView  &image, const EncodeSink  &sink) { encode_qoi(image, sink); };
+                case FileFormat::pnm: return [](const ConstImageView  &image, const EncodeSink  &sink) { encode_pnm(image, sink); };
+                default: throw std::invalid_argument("Batch encoding supports png, jpg, bmp, qoi and pnm");
+            }
+        }
+
+        auto encode_item(const ConstImageView  &source_image, const std::function<void(const ConstImageView&, const EncodeSink&)>  &encoder) -> std::vector<std::uint8_t>
+        {
+            return encode_to_vector([&](const EncodeSink  &sink) { encoder(source_image, sink); },
+                                    plane_row_bytes(source_image.meta_data(), 0) * source_image.size().height / 4);
+        }
+    } // namespace
+
+    auto decode_images(const gsl::span<const gsl::span<std::uint8_t>>& data, nitros::image::ThreadPool& pool,
+                       const DecodeOptions& options, std::size_t max_parallel) -> std::vector<std::future<ImageCpu>>
+    {
+        return decode_batch(std::vector<gsl::span<std::uint8_t>>(data.begin(), data.end()), pool, options, max_parallel);
+    }
+
+    auto read_images(const gsl::span<const std::string>& full_source_paths, nitros::image::ThreadPool& pool,
+                     const DecodeOptions& options, std::size_t max_parallel) -> std::vector<std::future<ImageCpu>>
+    {
+        return decode_batch(std::vector<std::string>(full_source_paths.begin(), full_source_paths.end()), pool, options, max_parallel);
+    }
+
+    auto decode_images(const gsl::span<const gsl::span<std::uint8_t>>& data, nitros::image::ThreadPool& pool, const DecodeCallback& callback,
+                       const DecodeOptions& options, std::size_t max_parallel) -> std::future<void>
     {
-        stbi_write_bmp(full_target_path.c_str(), 
-                       source_image.meta_data().size.width, 
-                       source_image.meta_data().size.height,
-                       source_image.meta_data().format.pixel_layout.channels,
-                       source_image.buffer().data());
+        return decode_batch(std::vector<gsl::span<std::uint8_t>>(data.begin(), data.end()), pool, callback, options, max_parallel);
     }
 
+    auto read_images(const gsl::span<const std::string>& full_source_paths, nitros::image::ThreadPool& pool, const DecodeCallback& callback,
+                     const DecodeOptions& options, std::size_t max_parallel) -> std::future<void>
+    {
+        return decode_batch(std::vector<std::string>(full_source_paths.begin(), full_source_paths.end()), pool, callback, options, max_parallel);
+    }
+
+    auto encode_images(const gsl::span<const ConstImageView>& source_images, FileFormat file_format, nitros::image::ThreadPool& pool,
+                       const EncodeOptions& options, std::size_t max_parallel) -> std::vector<std::future<std::vector<std::uint8_t>>>
+    {
+        auto images = std::make_shared<std::vector<ConstImageView>>(source_images.begin(), source_images.end());
+        return pool.map(images->size(), [images, encoder = encoder_for(file_format, options)](std::size_t  index) {
+            return encode_item((*images)[index], encoder);
+        }, max_parallel);
+    }
+
+    auto encode_images(const gsl::span<const ConstImageView>& source_images, FileFormat file_format, nitros::image::ThreadPool& pool,
+                       const EncodeCallback& callback, const EncodeOptions& options, std::size_t max_parallel) -> std::future<void>
+    {
+        auto images = std::make_shared<std::vector<ConstImageView>>(source_images.begin(), source_images.end());
+        return pool.for_each(images->size(), [images, callback, encoder = encoder_for(file_format, options)](std::size_t  index) {
+            auto encoded = std::vector<std::uint8_t>{};
+            try {
+                encoded = encode_item((*images)[index], encoder);
+            }
+            catch(...) {
+                callback(index, nullptr, std::current_exception());
+                return;
+            }
+            callback(index, &encoded, nullptr);
+        }, max_parallel);
+    }
+
+    auto write_images(const gsl::span<const ConstImageView>& source_images, const gsl::span<const std::string>& full_target_paths,
+                      FileFormat file_format, nitros::image::ThreadPool& pool,
+                      const EncodeOptions& options, std::size_t max_parallel) -> std::vector<std::future<void>>
+    {
+        if(source_images.size() != full_target_paths.size()) {
+            throw std::invalid_argument("Batch write needs one target path per image");
+        }
+        auto images = std::make_shared<std::vector<ConstImageView>>(source_images.begin(), source_images.end());
+        auto paths = std::make_shared<std::vector<std::string>>(full_target_paths.begin(), full_target_paths.end());
+        return pool.map(images->size(), [images, paths, encoder = encoder_for(file_format, options)](std::size_t  index) {
+            write_file((*paths)[index], [&](const EncodeSink  &sink) { encoder((*images)[index], sink); });
+        }, max_parallel);
+    }
 }
@@ -0,0 +1,261 @@
+#include "image/image_cache.hpp"
+#include "image/utils.hpp"
+#include <cstring>
+#include <filesystem>
+#include <future>
+#include <list>
+#include <mutex>
+#include <stdexcept>
+#include <system_error>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace nitros::utils::image
+{
+    namespace
+    {
+        enum class KeySource : std::uint8_t
+        {
+            file,
+            content,
+            user
+        };
+
+        //name is the path or user key, a and b are modification time and size of files, hash and size of content
+        struct Key
+        {
+            KeySource      source;
+            std::string    name;
+            std::uint64_t  a;
+            std::uint64_t  b;
+        };
+
+        inline auto operator==(const Key  &lhs, const Key  &rhs) -> bool
+        {
+            return lhs.source == rhs.source && lhs.a == rhs.a && lhs.b == rhs.b && lhs.name == rhs.name;
+        }
+
+        struct KeyHash
+        {
+            auto operator()(const Key  &key) const noexcept -> std::size_t
+            {
+                auto seed = std::hash<std::string>{}(key.name);
+                pixel::hash_combine(seed, static_cast<std::size_t>(key.source));
+                pixel::hash_combine(seed, static_cast<std::size_t>(key.a));
+                pixel::hash_combine(seed, static_cast<std::size_t>(key.b));
+                return seed;
+            }
+        };
+
+        struct Entry
+        {
+            //Waited on by concurrent lookups while the decode is in flight
+            std::shared_future<ImageCache::Handle>  pending;
+            //Set once the decode succeeded, only ready entries are in the LRU list and count against the budget
+            ImageCache::Handle  image;
+            std::list<const Key*>::iterator  lru;
+            std::size_t  bytes;
+        };
+
+        inline auto rotate_left(std::uint64_t  value, int  bits) noexcept -> std::uint64_t
+        {
+            return (value << bits) | (value >> (64 - bits));
+        }
+    } // namespace
+
+    auto content_hash(const gsl::span<const std::uint8_t>  &data) noexcept -> std::uint64_t
+    {
+        constexpr auto k1 = std::uint64_t{0x9e3779b97f4a7c15};
+        constexpr auto k2 = std::uint64_t{0xc2b2ae3d27d4eb4f};
+
+        auto size = gsl::narrow_cast<std::size_t>(data.size_bytes());
+        auto hash = k1 ^ size;
+        auto fold = [&](std::uint64_t  word) {
+            hash = rotate_left(hash ^ (word * k2), 29) * k1;
+        };
+
+        auto i = std::size_t{0};
+        for(; i + 8 <= size; i += 8)
+        {
+            auto word = std::uint64_t{};
+            std::memcpy(&word, data.data() + i, 8);
+            fold(word);
+        }
+        if(i < size)
+        {
+            auto word = std::uint64_t{};
+            std::memcpy(&word, data.data() + i, size - i);
+            fold(word);
+        }
+
+        //Final avalanche of MurmurHash3
+        hash ^= hash >> 33;
+        hash *= 0xff51afd7ed558ccd;
+        hash ^= hash >> 33;
+        hash *= 0xc4ceb9fe1a85ec53;
+        hash ^= hash >> 33;
+        return hash;
+    }
+
+    struct ImageCache::State
+    {
+        //Evicts least recently used images until resident_bytes <= bytes, the caller drops them outside the lock
+        auto trim(std::size_t  bytes) -> std::vector<Handle>
+        {
+            auto evicted = std::vector<Handle>{};
+            while(resident_bytes > bytes && !lru.empty())
+            {
+                auto it = entries.find(*lru.back());
+                evicted.push_back(std::move(it->second.image));
+                resident_bytes -= it->second.bytes;
+                lru.pop_back();
+                entries.erase(it);
+                evictions++;
+            }
+            return evicted;
+        }
+
+        auto lookup(Key  &&key, const std::function<ImageCpu()>  &load) -> Handle
+        {
+            auto promise = std::promise<Handle>{};
+            {
+                auto lock = std::unique_lock{mutex};
+                if(auto it = entries.find(key); it != entries.end())
+                {
+                    hits++;
+                    auto &entry = it->second;
+                    if(entry.image) {
+                        lru.splice(lru.begin(), lru, entry.lru);
+                        return entry.image;
+                    }
+                    waits++;
+                    auto pending = entry.pending;
+                    lock.unlock();
+                    return pending.get();
+                }
+
+                misses++;
+                entries.emplace(key, Entry{promise.get_future().share(), nullptr, {}, 0});
+            }
+
+            //Pending entries are never evicted or cleared, so the entry is still there when the decode is done
+            try
+            {
+                auto image = Handle{std::make_shared<const ImageCpu>(load())};
+                auto evicted = std::vector<Handle>{};
+                {
+                    auto lock = std::lock_guard{mutex};
+                    auto it = entries.find(key);
+                    auto bytes = image->buffer().size();
+                    if(bytes > max_bytes) {
+                        //Not kept, caching it would evict every other image and then itself
+                        entries.erase(it);
+                    }
+                    else {
+                        auto &entry = it->second;
+                        entry.image = image;
+                        entry.bytes = bytes;
+                        lru.push_front(&it->first);
+                        entry.lru = lru.begin();
+                        resident_bytes += entry.bytes;
+                        evicted = trim(max_bytes);
+                    }
+                }
+                promise.set_value(image);
+                return image;
+            }
+            catch(...)
+            {
+                {
+                    auto lock = std::lock_guard{mutex};
+                    entries.erase(key);
+                }
+                promise.set_exception(std::current_exception());
+                throw;
+            }
+        }
+
+        std::size_t    max_bytes;
+        DecodeOptions  options;
+
+        mutable std::mutex  mutex;
+        std::unordered_map<Key, Entry, KeyHash>  entries;
+        std::list<const Key*>  lru;    //Keys of ready entries, most recently used first
+        std::size_t  resident_bytes = 0;
+        std::size_t  hits = 0;
+        std::size_t  misses = 0;
+        std::size_t  waits = 0;
+        std::size_t  evictions = 0;
+    };
+
+    ImageCache::ImageCache(std::size_t  max_bytes, const DecodeOptions  &options)
+        :_state{std::make_unique<State>()}
+    {
+        _state->max_bytes = max_bytes;
+        _state->options = options;
+    }
+
+    ImageCache::ImageCache(ImageCache&&) noexcept = default;
+    ImageCache::~ImageCache() = default;
+    auto ImageCache::operator=(ImageCache&&) noexcept -> ImageCache& = default;
+
+    auto ImageCache::read(const std::string  &full_source_path) -> Handle
+    {
+        auto error = std::error_code{};
+        auto time = std::filesystem::last_write_time(full_source_path, error);
+        auto size = error ? std::uintmax_t{0} : std::filesystem::file_size(full_source_path, error);
+        if(error) {
+            throw std::runtime_error("Cannot read " + full_source_path + ": " + error.message());
+        }
+
+        auto key = Key{KeySource::file, full_source_path, static_cast<std::uint64_t>(time.time_since_epoch().count()), size};
+        return _state->lookup(std::move(key), [&] { return read_image(full_source_path, _state->options); });
+    }
+
+    auto ImageCache::decode(const gsl::span<std::uint8_t>  &data) -> Handle
+    {
+        auto key = Key{KeySource::content, {}, content_hash(data), static_cast<std::uint64_t>(data.size_bytes())};
+        return _state->lookup(std::move(key), [&] { return decode_image(data, _state->options); });
+    }
+
+    auto ImageCache::get(const std::string  &key, const std::function<ImageCpu()>  &load) -> Handle
+    {
+        return _state->lookup(Key{KeySource::user, key, 0, 0}, load);
+    }
+
+    auto ImageCache::stats() const -> ImageCacheStats
+    {
+        auto &state = *_state;
+        auto lock = std::lock_guard{state.mutex};
+        return ImageCacheStats{state.hits, state.misses, state.waits, state.evictions, state.lru.size(), state.resident_bytes};
+    }
+
+    auto ImageCache::max_bytes() const -> std::size_t
+    {
+        auto lock = std::lock_guard{_state->mutex};
+        return _state->max_bytes;
+    }
+
+    void ImageCache::set_max_bytes(std::size_t  bytes)
+    {
+        auto evicted = std::vector<Handle>{};
+        auto lock = std::lock_guard{_state->mutex};
+        _state->max_bytes = bytes;
+        evicted = _state->trim(bytes);
+    }
+
+    void ImageCache::clear()
+    {
+        auto &state = *_state;
+        auto dropped = std::vector<Handle>{};
+        auto lock = std::lock_guard{state.mutex};
+        for(auto *key : state.lru) {
+            auto it = state.entries.find(*key);
+            dropped.push_back(std::move(it->second.image));
+            state.entries.erase(it);
+        }
+        state.lru.clear();
+        state.resident_bytes = 0;
+    }
+}
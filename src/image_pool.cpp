@@ -0,0 +1,175 @@
+#include "image/image_pool.hpp"
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace nitros::utils
+{
+    namespace
+    {
+        struct Key
+        {
+            ImgSize        size;
+            pixel::Format  format;
+        };
+
+        inline auto operator==(const Key  &lhs, const Key  &rhs) -> bool { return lhs.size == rhs.size && lhs.format == rhs.format; }
+
+        struct KeyHash
+        {
+            auto operator()(const Key  &key) const noexcept -> std::size_t
+            {
+                auto seed = pixel::FormatHash{}(key.format);
+                pixel::hash_combine(seed, key.size.width);
+                pixel::hash_combine(seed, key.size.height);
+                return seed;
+            }
+        };
+
+        using FreeList = std::vector<std::unique_ptr<ImageCpu>>;
+    } // namespace
+
+    struct ImagePool::State
+    {
+        //Frees retained images until retained_bytes <= bytes, the caller destroys them outside the lock
+        auto trim(std::size_t  bytes) -> FreeList
+        {
+            auto freed = FreeList{};
+            for(auto it = free.begin(); it != free.end() && retained_bytes > bytes; )
+            {
+                auto &images = it->second;
+                while(!images.empty() && retained_bytes > bytes)
+                {
+                    retained_bytes -= images.back()->buffer().size();
+                    retained_images--;
+                    freed.push_back(std::move(images.back()));
+                    images.pop_back();
+                }
+                it = images.empty() ? free.erase(it) : std::next(it);
+            }
+            return freed;
+        }
+
+        mutable std::mutex  mutex;
+        std::unordered_map<Key, FreeList, KeyHash>  free;
+        std::size_t    max_retained_bytes;
+        BufferOptions  options;
+
+        std::size_t  hits = 0;
+        std::size_t  misses = 0;
+        std::size_t  dropped = 0;
+        std::size_t  retained_images = 0;
+        std::size_t  retained_bytes = 0;
+    };
+
+    void ImagePool::Recycler::operator()(ImageCpu  *ptr) const noexcept
+    {
+        auto owned = std::unique_ptr<ImageCpu>{ptr};
+        auto shared = state.lock();
+        if(!owned || !shared) {
+            return;
+        }
+
+        auto bytes = owned->buffer().size();
+        auto lock = std::lock_guard{shared->mutex};
+        //Images resized by the user no longer match their key
+        if(bytes != image::buffer_size(owned->meta_data()) || shared->retained_bytes + bytes > shared->max_retained_bytes) {
+            shared->dropped++;
+            return;
+        }
+
+        try
+        {
+            auto key = Key{owned->meta_data().size, owned->meta_data().format};
+            shared->free[key].push_back(std::move(owned));
+            shared->retained_images++;
+            shared->retained_bytes += bytes;
+        }
+        catch(...)
+        {
+            shared->dropped++;
+        }
+    }
+
+    ImagePool::ImagePool(std::size_t  max_retained_bytes, const BufferOptions  &options)
+        :_state{std::make_shared<State>()}
+    {
+        _state->max_retained_bytes = max_retained_bytes;
+        _state->options = options;
+    }
+
+    ImagePool::~ImagePool() = default;
+
+    auto ImagePool::acquire(ImgSize  size, const pixel::Format  &format) -> Handle
+    {
+        {
+            auto lock = std::lock_guard{_state->mutex};
+            auto it = _state->free.find(Key{size, format});
+            if(it != _state->free.end() && !it->second.empty())
+            {
+                auto image = std::move(it->second.back());
+                it->second.pop_back();
+                _state->hits++;
+                _state->retained_images--;
+                _state->retained_bytes -= image->buffer().size();
+                //Steps may have been changed by the previous user
+                image->meta_data() = ImageMetaData{size, format};
+                return Handle{image.release(), Recycler{_state}};
+            }
+            _state->misses++;
+        }
+
+        auto image = std::make_unique<ImageCpu>(image::create_cpu(size, format, _state->options));
+        return Handle{image.release(), Recycler{_state}};
+    }
+
+    void ImagePool::reserve(ImgSize  size, const pixel::Format  &format, std::size_t  count)
+    {
+        auto meta_data = ImageMetaData{size, format};
+        auto bytes = image::buffer_size(meta_data);
+
+        auto lock = std::lock_guard{_state->mutex};
+        auto &images = _state->free[Key{size, format}];
+        auto available = images.size();
+        while(available < count && _state->retained_bytes + bytes <= _state->max_retained_bytes)
+        {
+            images.push_back(std::make_unique<ImageCpu>(image::create_cpu(size, format, _state->options)));
+            _state->retained_images++;
+            _state->retained_bytes += bytes;
+            available++;
+        }
+    }
+
+    auto ImagePool::stats() const -> ImagePoolStats
+    {
+        auto lock = std::lock_guard{_state->mutex};
+        return { .hits = _state->hits, .misses = _state->misses, .dropped = _state->dropped,
+                 .retained_images = _state->retained_images, .retained_bytes = _state->retained_bytes };
+    }
+
+    auto ImagePool::max_retained_bytes() const -> std::size_t
+    {
+        auto lock = std::lock_guard{_state->mutex};
+        return _state->max_retained_bytes;
+    }
+
+    void ImagePool::set_max_retained_bytes(std::size_t  bytes)
+    {
+        auto freed = FreeList{};
+        {
+            auto lock = std::lock_guard{_state->mutex};
+            _state->max_retained_bytes = bytes;
+            freed = _state->trim(bytes);
+        }
+    }
+
+    void ImagePool::clear()
+    {
+        auto freed = FreeList{};
+        {
+            auto lock = std::lock_guard{_state->mutex};
+            freed = _state->trim(0);
+        }
+    }
+} // namespace nitros::utils
@@ -0,0 +1,310 @@
+#include "image/mapped_buffer.hpp"
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+
+#if defined(PLATFORM_WINDOWS)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace nitros::utils
+{
+    namespace
+    {
+#if defined(PLATFORM_WINDOWS)
+        [[noreturn]] void throw_os_error(const std::string  &what)
+        {
+            throw std::system_error(static_cast<int>(GetLastError()), std::system_category(), what);
+        }
+
+        struct Handle
+        {
+            ~Handle() { if(value && value != INVALID_HANDLE_VALUE) CloseHandle(value); }
+            HANDLE  value;
+        };
+
+        auto map_granularity() -> std::size_t
+        {
+            auto info = SYSTEM_INFO{};
+            GetSystemInfo(&info);
+            return info.dwAllocationGranularity;
+        }
+#else
+        [[noreturn]] void throw_os_error(const std::string  &what)
+        {
+            throw std::system_error(errno, std::generic_category(), what);
+        }
+
+        struct FileDescriptor
+        {
+            ~FileDescriptor() { if(value >= 0) ::close(value); }
+            int  value;
+        };
+
+        auto map_granularity() -> std::size_t
+        {
+            return static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+        }
+#endif
+    } // namespace
+
+    MappedBuffer::MappedBuffer() noexcept
+        :_data{nullptr}
+        ,_size{0}
+        ,_map{nullptr}
+        ,_map_size{0}
+        ,_mode{MapMode::read_only}
+    {}
+
+    MappedBuffer::MappedBuffer(const std::string  &path, MapMode  mode, size_type  offset, size_type  size)
+        :MappedBuffer()
+    {
+        _mode = mode;
+
+#if defined(PLATFORM_WINDOWS)
+        auto access = mode == MapMode::read_write ? GENERIC_READ | GENERIC_WRITE : GENERIC_READ;
+        auto file = Handle{ CreateFileA(path.c_str(), access, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr) };
+        if(file.value == INVALID_HANDLE_VALUE) {
+            throw_os_error("Cannot open " + path);
+        }
+
+        auto file_size = LARGE_INTEGER{};
+        if(!GetFileSizeEx(file.value, &file_size)) {
+            throw_os_error("Cannot stat " + path);
+        }
+        auto total = static_cast<size_type>(file_size.QuadPart);
+#else
+        auto flags = mode == MapMode::read_write ? O_RDWR : O_RDONLY;
+        auto file = FileDescriptor{ ::open(path.c_str(), flags | O_CLOEXEC) };
+        if(file.value < 0) {
+            throw_os_error("Cannot open " + path);
+        }
+
+        struct stat st{};
+        if(::fstat(file.value, &st) != 0) {
+            throw_os_error("Cannot stat " + path);
+        }
+        auto total = static_cast<size_type>(st.st_size);
+#endif
+
+        if(offset > total || (size != 0 && size > total - offset)) {
+            throw std::invalid_argument("Mapped range past the end of " + path);
+        }
+        if(size == 0) {
+            size = total - offset;
+        }
+        if(size == 0) {
+            return;
+        }
+
+        //Mappings start on a granularity boundary, the data pointer is moved forward to offset
+        auto granularity = map_granularity();
+        auto map_offset = offset / granularity * granularity;
+        auto map_size   = size + (offset - map_offset);
+
+#if defined(PLATFORM_WINDOWS)
+        auto protect = mode == MapMode::read_write ? PAGE_READWRITE : mode == MapMode::copy_on_write ? PAGE_WRITECOPY : PAGE_READONLY;
+        auto mapping = Handle{ CreateFileMappingA(file.value, nullptr, protect, 0, 0, nullptr) };
+        if(!mapping.value) {
+            throw_os_error("Cannot map " + path);
+        }
+
+        auto view_access = mode == MapMode::read_write ? FILE_MAP_WRITE : mode == MapMode::copy_on_write ? FILE_MAP_COPY : FILE_MAP_READ;
+        auto map = MapViewOfFile(mapping.value, view_access, static_cast<DWORD>(std::uint64_t{map_offset} >> 32), static_cast<DWORD>(map_offset & 0xffffffffu), map_size);
+        if(!map) {
+            throw_os_error("Cannot map " + path);
+        }
+#else
+        auto protect = mode == MapMode::read_only ? PROT_READ : PROT_READ | PROT_WRITE;
+        auto share   = mode == MapMode::copy_on_write ? MAP_PRIVATE : MAP_SHARED;
+        auto map = ::mmap(nullptr, map_size, protect, share, file.value, static_cast<off_t>(map_offset));
+        if(map == MAP_FAILED) {
+            throw_os_error("Cannot map " + path);
+        }
+#endif
+
+        _map      = map;
+        _map_size = map_size;
+        _data     = static_cast<pointer>(map) + (offset - map_offset);
+        _size     = size;
+    }
+
+    MappedBuffer::MappedBuffer(MappedBuffer  &&other) noexcept
+        :_data{std::exchange(other._data, nullptr)}
+        ,_size{std::exchange(other._size, 0)}
+        ,_map{std::exchange(other._map, nullptr)}
+        ,_map_size{std::exchange(other._map_size, 0)}
+        ,_mode{other._mode}
+    {}
+
+    MappedBuffer::~MappedBuffer()
+    {
+        unmap();
+    }
+
+    auto MappedBuffer::operator=(MappedBuffer  &&other) noexcept -> MappedBuffer&
+    {
+        if(this != &other) {
+            unmap();
+            _data     = std::exchange(other._data, nullptr);
+            _size     = std::exchange(other._size, 0);
+            _map      = std::exchange(other._map, nullptr);
+            _map_size = std::exchange(other._map_size, 0);
+            _mode     = other._mode;
+        }
+        return *this;
+    }
+
+    auto MappedBuffer::create(const std::string  &path, size_type  size) -> MappedBuffer
+    {
+#if defined(PLATFORM_WINDOWS)
+        {
+            auto file = Handle{ CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr) };
+            if(file.value == INVALID_HANDLE_VALUE) {
+                throw_os_error("Cannot create " + path);
+            }
+
+            auto end = LARGE_INTEGER{};
+            end.QuadPart = static_cast<LONGLONG>(size);
+            if(!SetFilePointerEx(file.value, end, nullptr, FILE_BEGIN) || !SetEndOfFile(file.value)) {
+                throw_os_error("Cannot resize " + path);
+            }
+        }
+#else
+        {
+            auto file = FileDescriptor{ ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644) };
+            if(file.value < 0) {
+                throw_os_error("Cannot create " + path);
+            }
+            //Sparse file, blocks are allocated when pages are first written
+            if(::ftruncate(file.value, static_cast<off_t>(size)) != 0) {
+                throw_os_error("Cannot resize " + path);
+            }
+        }
+#endif
+        return MappedBuffer(path, MapMode::read_write, 0, size);
+    }
+
+    auto MappedBuffer::data() noexcept -> pointer
+    {
+        return _data;
+    }
+
+    auto MappedBuffer::data() const noexcept -> const_pointer
+    {
+        return _data;
+    }
+
+    auto MappedBuffer::size() const noexcept -> size_type
+    {
+        return _size;
+    }
+
+    auto MappedBuffer::empty() const noexcept -> bool
+    {
+        return _size == 0;
+    }
+
+    auto MappedBuffer::mode() const noexcept -> MapMode
+    {
+        return _mode;
+    }
+
+    auto MappedBuffer::begin() noexcept -> iterator
+    {
+        return _data;
+    }
+
+    auto MappedBuffer::end() noexcept -> iterator
+    {
+        return _data + _size;
+    }
+
+    auto MappedBuffer::begin() const noexcept -> const_iterator
+    {
+        return _data;
+    }
+
+    auto MappedBuffer::end() const noexcept -> const_iterator
+    {
+        return _data + _size;
+    }
+
+    auto MappedBuffer::operator[](size_type  index) noexcept -> reference
+    {
+        return _data[index];
+    }
+
+    auto MappedBuffer::operator[](size_type  index) const noexcept -> const_reference
+    {
+        return _data[index];
+    }
+
+    void MappedBuffer::flush()
+    {
+        if(!_map || _mode != MapMode::read_write) {
+            return;
+        }
+#if defined(PLATFORM_WINDOWS)
+        if(!FlushViewOfFile(_map, _map_size)) {
+            throw_os_error("Cannot flush mapping");
+        }
+#else
+        if(::msync(_map, _map_size, MS_SYNC) != 0) {
+            throw_os_error("Cannot flush mapping");
+        }
+#endif
+    }
+
+    void MappedBuffer::swap(MappedBuffer  &other) noexcept
+    {
+        std::swap(_data, other._data);
+        std::swap(_size, other._size);
+        std::swap(_map, other._map);
+        std::swap(_map_size, other._map_size);
+        std::swap(_mode, other._mode);
+    }
+
+    void MappedBuffer::unmap() noexcept
+    {
+        if(_map) {
+#if defined(PLATFORM_WINDOWS)
+            UnmapViewOfFile(_map);
+#else
+            ::munmap(_map, _map_size);
+#endif
+        }
+        _data = nullptr;
+        _size = 0;
+        _map = nullptr;
+        _map_size = 0;
+    }
+
+    namespace image
+    {
+        auto create_mapped(const std::string  &path, ImgSize  size, pixel::Format  format) -> ImageMapped
+        {
+            auto meta_data = ImageMetaData{size, format};
+            auto buffer = MappedBuffer::create(path, buffer_size(meta_data));
+            return ImageMapped{std::move(meta_data), std::move(buffer)};
+        }
+
+        auto open_mapped(const std::string  &path, const ImageMetaData  &meta_data, MapMode  mode, std::size_t  offset) -> ImageMapped
+        {
+            auto bytes = buffer_size(meta_data);
+            if(bytes == 0) {
+                return ImageMapped{ImageMetaData{meta_data}, MappedBuffer{}};
+            }
+            auto buffer = MappedBuffer(path, mode, offset, bytes);
+            return ImageMapped{ImageMetaData{meta_data}, std::move(buffer)};
+        }
+    }
+} // namespace nitros::utils
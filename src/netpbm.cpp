@@ -0,0 +1,323 @@
+#include "image/fileio.hpp"
+#include "image/mapped_buffer.hpp"
+#include "image/utils.hpp"
+#include "codec_internal.hpp"
+#include "process/kernels.hpp"
+#include <gsl/gsl>
+#include <bit>
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <string>
+
+namespace nitros::utils::image
+{
+    namespace
+    {
+        //Binary PGM (P5), PPM (P6) and PAM (P7), samples above 8 bits are stored big endian
+        using detail::PnmHeader;
+
+        //Comments may be long, a stream without the end of a header by then is not Netpbm
+        constexpr auto pnm_max_header_bytes = std::size_t{65536};
+
+        auto pnm_format(std::size_t  channels, std::size_t  max_value) -> pixel::Format
+        {
+            if(max_value == 0 || max_value > 65535) {
+                throw std::runtime_error("Netpbm maxval out of range");
+            }
+            auto wide = max_value > 255;
+            switch(channels) {
+                case 1: return wide ? pixel::GREY16::value : pixel::GREY8::value;
+                case 3: return wide ? pixel::RGB16::value  : pixel::RGB8::value;
+                case 4: return wide ? pixel::RGBA16::value : pixel::RGBA8::value;
+                default: throw std::runtime_error("Netpbm depth " + std::to_string(channels) + " is not supported");
+            }
+        }
+
+        auto is_pnm_format(const pixel::Format  &format) -> bool
+        {
+            return format == pixel::GREY8::value || format == pixel::GREY16::value
+                || format == pixel::RGB8::value  || format == pixel::RGB16::value
+                || format == pixel::RGBA8::value || format == pixel::RGBA16::value;
+        }
+
+        auto is_wide(const pixel::Format  &format) -> bool
+        {
+            return format.pixel_layout.bytes == format.pixel_layout.channels * 2;
+        }
+
+        //A maxval below 255 or 65535 (e.g. 1023 of 10 bit sensors) is stretched, so the image uses the normalized range
+        template <typename sample_type_>
+        void rescale_samples(sample_type_  *samples, std::size_t  count, std::size_t  max_value)
+        {
+            auto full = std::uint32_t{std::numeric_limits<sample_type_>::max()};
+            auto max = gsl::narrow_cast<std::uint32_t>(max_value);
+            for(auto i = std::size_t{0}; i < count; i++) {
+                auto sample = std::min<std::uint32_t>(samples[i], max);
+                samples[i] = static_cast<sample_type_>((sample * full + max / 2) / max);
+            }
+        }
+
+        //Tokens cut off by the end of data mark the header incomplete instead of failing, more data may follow
+        class HeaderParser
+        {
+            public:
+            explicit HeaderParser(gsl::span<const std::uint8_t>  data) noexcept
+                :_data{data}, _size{gsl::narrow_cast<std::size_t>(data.size_bytes())}, _pos{0}, _incomplete{false} {}
+
+            //Whitespace and # comments up to the end of their line
+            void skip_space()
+            {
+                while(_pos < _size)
+                {
+                    if(_data[_pos] == '#') {
+                        while(_pos < _size && _data[_pos] != '\n') {
+                            _pos++;
+                        }
+                    }
+                    else if(std::isspace(_data[_pos])) {
+                        _pos++;
+                    }
+                    else {
+                        return;
+                    }
+                }
+            }
+
+            auto token() -> std::string
+            {
+                skip_space();
+                auto start = _pos;
+                while(_pos < _size && !std::isspace(_data[_pos])) {
+                    _pos++;
+                }
+                if(_pos == _size) {
+                    _incomplete = true;
+                    return {};
+                }
+                return std::string(reinterpret_cast<const char*>(_data.data() + start), _pos - start);
+            }
+
+            auto number() -> std::size_t
+            {
+                auto text = token();
+                if(_incomplete) {
+                    return 0;
+                }
+                if(text.size() > 9 || text.find_first_not_of("0123456789") != std::string::npos) {
+                    throw std::runtime_error("Netpbm header has an invalid number: " + text);
+                }
+                return std::stoul(text);
+            }
+
+            void skip_line()
+            {
+                while(_pos < _size && _data[_pos] != '\n') {
+                    _pos++;
+                }
+                if(_pos == _size) {
+                    _incomplete = true;
+                }
+                _pos++;
+            }
+
+            auto incomplete() const noexcept -> bool
+            {
+                return _incomplete;
+            }
+
+            //The header ends with a single whitespace character, binary samples start right after it
+            auto end_of_header() -> std::size_t
+            {
+                return _pos + 1;
+            }
+
+            private:
+            gsl::span<const std::uint8_t>  _data;
+            std::size_t  _size;
+            std::size_t  _pos;
+            bool         _incomplete;
+        };
+
+        auto read_header(gsl::span<const std::uint8_t>  data) -> PnmHeader
+        {
+            auto header = detail::parse_pnm_header(data);
+            if(!header) {
+                throw std::runtime_error("Netpbm header is truncated");
+            }
+
+            auto row_bytes = plane_row_bytes(ImageMetaData{header->size, header->format}, 0);
+            if((gsl::narrow_cast<std::size_t>(data.size_bytes()) - header->data_offset) / row_bytes < header->size.height) {
+                throw std::runtime_error("Netpbm image is truncated");
+            }
+            return *header;
+        }
+    } // namespace
+
+    namespace detail
+    {
+        auto parse_pnm_header(gsl::span<const std::uint8_t>  data) -> std::optional<PnmHeader>
+        {
+            auto size = gsl::narrow_cast<std::size_t>(data.size_bytes());
+            auto parser = HeaderParser{data.first(gsl::narrow_cast<std::ptrdiff_t>(std::min(size, pnm_max_header_bytes)))};
+            auto magic = parser.token();
+            if(parser.incomplete()) {
+                if(size >= pnm_max_header_bytes) {
+                    throw std::runtime_error("Netpbm header is too long");
+                }
+                return std::nullopt;
+            }
+
+            auto header = PnmHeader{{0, 0}, pixel::GREY8::value, 0, 0};
+            auto channels = std::size_t{0};
+            auto max_value = std::size_t{0};
+            if(magic == "P5" || magic == "P6")
+            {
+                header.size.width  = parser.number();
+                header.size.height = parser.number();
+                max_value = parser.number();
+                channels = magic == "P5" ? 1 : 3;
+            }
+            else if(magic == "P7")
+            {
+                for(auto key = parser.token(); !parser.incomplete() && key != "ENDHDR"; key = parser.token())
+                {
+                    if(key == "WIDTH")          header.size.width  = parser.number();
+                    else if(key == "HEIGHT")    header.size.height = parser.number();
+                    else if(key == "DEPTH")     channels = parser.number();
+                    else if(key == "MAXVAL")    max_value = parser.number();
+                    else                        parser.skip_line();     //TUPLTYPE, the layout follows from DEPTH
+                }
+            }
+            else {
+                throw std::runtime_error("Not a binary Netpbm image");
+            }
+
+            if(parser.incomplete()) {
+                if(size >= pnm_max_header_bytes) {
+                    throw std::runtime_error("Netpbm header is too long");
+                }
+                return std::nullopt;
+            }
+            header.max_value = max_value;
+            header.format = pnm_format(channels, max_value);
+            header.data_offset = parser.end_of_header();
+            if(header.size.width == 0 || header.size.height == 0) {
+                throw std::runtime_error("Netpbm image is empty");
+            }
+            return header;
+        }
+
+        //Rows go from file to image in one pass, 16 bit rows are byte swapped and partial range rows rescaled on the way
+        void pnm_rows_in(const std::uint8_t  *in, const PnmHeader  &header, const ImageView  &target, std::size_t  first_row, std::size_t  rows)
+        {
+            auto row_bytes = plane_row_bytes(target.meta_data(), 0);
+            auto wide = is_wide(header.format);
+            auto swap = wide && std::endian::native == std::endian::little;
+            auto rescale = header.max_value != (wide ? 65535u : 255u);
+            auto byteswap16 = nitros::image::kernels::conversion_kernels().byteswap16;
+
+            for(auto y = first_row; y < first_row + rows; y++, in += row_bytes)
+            {
+                if(swap) {
+                    byteswap16(in, target.row(y), row_bytes / 2);
+                }
+                else {
+                    std::memcpy(target.row(y), in, row_bytes);
+                }
+
+                if(rescale && wide) {
+                    rescale_samples(reinterpret_cast<std::uint16_t*>(target.row(y)), row_bytes / 2, header.max_value);
+                }
+                else if(rescale) {
+                    rescale_samples(target.row(y), row_bytes, header.max_value);
+                }
+            }
+        }
+    } // namespace detail
+
+    void encode_pnm(const ConstImageView& source_image, const EncodeSink& sink)
+    {
+        auto &meta = source_image.meta_data();
+        if(!is_pnm_format(meta.format)) {
+            throw std::invalid_argument("Netpbm images are GREY, RGB or RGBA of 8 or 16 bits");
+        }
+
+        auto channels = meta.format.pixel_layout.channels;
+        auto max_value = is_wide(meta.format) ? 65535 : 255;
+        auto size = std::to_string(meta.size.width) + " " + std::to_string(meta.size.height);
+        auto header = channels == 4
+            ? "P7\nWIDTH " + std::to_string(meta.size.width) + "\nHEIGHT " + std::to_string(meta.size.height)
+              + "\nDEPTH 4\nMAXVAL " + std::to_string(max_value) + "\nTUPLTYPE RGB_ALPHA\nENDHDR\n"
+            : (channels == 1 ? "P5\n" : "P6\n") + size + "\n" + std::to_string(max_value) + "\n";
+        sink(reinterpret_cast<const std::uint8_t*>(header.data()), header.size());
+
+        //8 bit rows are handed to the sink straight from the image, padding and regions need no packing copy
+        auto row_bytes = plane_row_bytes(meta, 0);
+        if(!is_wide(meta.format) || std::endian::native == std::endian::big) {
+            for(auto y = std::size_t{0}; y < meta.size.height; y++) {
+                sink(source_image.row(y), row_bytes);
+            }
+            return;
+        }
+
+        auto byteswap16 = nitros::image::kernels::conversion_kernels().byteswap16;
+        auto swapped = std::vector<std::uint8_t>(row_bytes);
+        for(auto y = std::size_t{0}; y < meta.size.height; y++) {
+            byteswap16(source_image.row(y), swapped.data(), row_bytes / 2);
+            sink(swapped.data(), row_bytes);
+        }
+    }
+
+    auto encode_pnm(const ConstImageView& source_image) -> std::vector<std::uint8_t>
+    {
+        auto encoded = std::vector<std::uint8_t>{};
+        encoded.reserve(plane_row_bytes(source_image.meta_data(), 0) * source_image.size().height + 64);
+        encode_pnm(source_image, [&encoded](const std::uint8_t  *data, std::size_t  size) {
+            encoded.insert(encoded.end(), data, data + size);
+        });
+        return encoded;
+    }
+
+    void write_image_pnm(const std::string& full_target_path, const ConstImageView& source_image)
+    {
+        auto file = std::ofstream(full_target_path, std::ios::binary);
+        if(!file) {
+            throw std::runtime_error("Cannot open " + full_target_path);
+        }
+        encode_pnm(source_image, [&file](const std::uint8_t  *data, std::size_t  size) {
+            file.write(reinterpret_cast<const char*>(data), gsl::narrow_cast<std::streamsize>(size));
+        });
+        file.flush();
+        if(!file) {
+            throw std::runtime_error("Cannot write " + full_target_path);
+        }
+    }
+
+    auto decode_pnm(const gsl::span<const std::uint8_t>& data) -> ImageCpu
+    {
+        auto header = read_header(data);
+        auto image = create_cpu(header.size, header.format);
+        detail::pnm_rows_in(data.data() + header.data_offset, header, view(image), 0, header.size.height);
+        return image;
+    }
+
+    void decode_pnm(const gsl::span<const std::uint8_t>& data, const ImageView& target_image)
+    {
+        auto header = read_header(data);
+        if(header.size != target_image.size() || !(header.format == target_image.meta_data().format)) {
+            throw std::invalid_argument("Netpbm image does not match the size and format of the target image");
+        }
+        detail::pnm_rows_in(data.data() + header.data_offset, header, target_image, 0, header.size.height);
+    }
+
+    auto read_image_pnm(const std::string& full_source_path) -> ImageCpu
+    {
+        auto file = MappedBuffer(full_source_path, MapMode::read_only);
+        return decode_pnm({file.data(), file.size()});
+    }
+}
@@ -1,93 +1,83 @@
-
 #include "image/image.hpp"
-#include "image/pixel/read_write.hpp"
 #include "image/process/conversion.hpp"
-#include "conversion_internal.hpp"
+#include "image/process/converter.hpp"
+#include "image/utils.hpp"
 #include <gsl/gsl>
 #include <stdexcept>
 #include <assert.h>
 #include <utility>
 #include <algorithm>
+#include <cstring>
 
 namespace nitros::image
 {
-    auto color_convert(const utils::ImageCpu  &src_image, utils::ImageCpu  &dest_image) -> bool
+    namespace
     {
-        assert( src_image.meta_data().size == dest_image.meta_data().size );
-
-        if(src_image.meta_data().format == utils::pixel::RGBA8::value &&
-           dest_image.meta_data().format == utils::pixel::YUV444p::value)
-        {
-            rgb_to_yuv444<std::uint8_t, 4>(src_image.meta_data(), dest_image.meta_data(), src_image.buffer().data(), dest_image.buffer().data());
-            return true;
-        }
-        else if(src_image.meta_data().format == utils::pixel::RGB8::value &&
-           dest_image.meta_data().format == utils::pixel::YUV444p::value)
-        {
-            rgb_to_yuv444<std::uint8_t, 3>(src_image.meta_data(), dest_image.meta_data(), src_image.buffer().data(), dest_image.buffer().data());
-            return true;
-        }
-        else if(src_image.meta_data().format == utils::pixel::YUV444p::value &&
-                dest_image.meta_data().format == utils::pixel::RGBA8::value)
+        //Rows of one band must not share a subsampled plane row with another band
+        auto row_alignment(const utils::ImageMetaData  &meta) -> std::size_t
         {
-            yuv444_to_rgb<std::uint8_t, 4>(src_image.meta_data(), dest_image.meta_data(), src_image.buffer().data(), dest_image.buffer().data());
-            return true;
-        }
-        else if(src_image.meta_data().format == utils::pixel::YUV444p::value &&
-                dest_image.meta_data().format == utils::pixel::RGB8::value)
-        {
-            yuv444_to_rgb<std::uint8_t, 3>(src_image.meta_data(), dest_image.meta_data(), src_image.buffer().data(), dest_image.buffer().data());
-            return true;
+            auto alignment = std::size_t{1};
+            if(meta.format.planar_info.is_planar) {
+                for(auto &plane : meta.format.planes) {
+                    alignment = std::max<std::size_t>(alignment, plane.height_factor.den);
+                }
+            }
+            return alignment;
         }
 
-        if((src_image.meta_data().format.pixel_type == utils::pixel::type::rgba || src_image.meta_data().format.pixel_type == utils::pixel::type::rgb)
-            && dest_image.meta_data().format.pixel_type == utils::pixel::type::yuv)
+        void flip_rows(const utils::ConstImageView  &src_image, const utils::ImageView  &dest_image, std::size_t  first, std::size_t  last)
         {
-            auto reader = utils::pixel::ReaderRGBA<std::uint8_t>{src_image};
-            auto writer = utils::pixel::WriterYUV<std::uint8_t>{dest_image};
+            auto &meta = src_image.meta_data();
+            auto planes = meta.format.planar_info.is_planar ? meta.format.planes.size() : std::size_t{1};
 
-            while (auto px = reader.next())
+            for(auto p = std::size_t{0}; p < planes; p++)
             {
-                auto yuv_px = utils::pixel::PixelYUV<std::uint8_t>{};
-                rbg_yuv(px->r, px->g, px->b, &yuv_px.y, &yuv_px.cb, &yuv_px.cr);
-                yuv_px.a = px->a;
-                writer.next(yuv_px);
-            }
+                auto &plane = meta.format.planes[p];
+                auto plane_height = utils::interpreted_plane_img_size(meta, p).height;
+                //Views of a region must not copy the row padding, it belongs to the pixels right of the region
+                auto row_bytes = utils::plane_row_bytes(meta, p);
 
-            return true;
+                auto plane_first = first * plane.height_factor.num / plane.height_factor.den;
+                auto plane_last  = std::min<std::size_t>(last * plane.height_factor.num / plane.height_factor.den, plane_height);
+                for(auto y = plane_first; y < plane_last; y++)
+                {
+                    std::memcpy( dest_image.row((plane_height - 1) - y, p), src_image.row(y, p), row_bytes );
+                }
+            }
         }
-        else if(src_image.meta_data().format.pixel_type == utils::pixel::type::yuv
-            && (dest_image.meta_data().format.pixel_type == utils::pixel::type::rgba || dest_image.meta_data().format.pixel_type == utils::pixel::type::rgb))
-        {
-            auto reader = utils::pixel::ReaderYUV<std::uint8_t>{src_image};
-            auto writer = utils::pixel::WriterRGBA<std::uint8_t>{dest_image};
+    } // namespace
 
-            while (auto px = reader.next())
-            {
-                auto rgba_px = utils::pixel::PixelRGBA<std::uint8_t>{};
-                yuv_to_rgb(px->y, px->cb, px->cr, &rgba_px.r, &rgba_px.g, &rgba_px.b);
-                rgba_px.a = px->a;
-                auto result = writer.next(rgba_px);
-            }
+    auto color_convert(const utils::ConstImageView  &src_image, const utils::ImageView  &dest_image) -> bool
+    {
+        assert( src_image.size() == dest_image.size() );
 
-            return true;
-        }        
+        auto plan = plan_conversion(src_image.meta_data().format, dest_image.meta_data().format);
+        return plan(src_image, dest_image);
+    }
+
+    auto color_convert(const utils::ConstImageView  &src_image, const utils::ImageView  &dest_image, ThreadPool  &pool) -> bool
+    {
+        assert( src_image.size() == dest_image.size() );
 
-        return false;
+        auto plan = plan_conversion(src_image.meta_data().format, dest_image.meta_data().format);
+        return plan(src_image, dest_image, pool);
     }
 
-    auto flip_y(const utils::ImageCpu  &src_image, utils::ImageCpu  &dest_image) -> bool 
+    auto flip_y(const utils::ConstImageView  &src_image, const utils::ImageView  &dest_image) -> bool 
     {
-        Expects( src_image.meta_data() == dest_image.meta_data() );
+        Expects( src_image.size() == dest_image.size() && src_image.meta_data().format == dest_image.meta_data().format );
 
-        auto img_size = src_image.meta_data().size;
-        for(auto y = 0; y < src_image.meta_data().size.height; y++ )
-        {
-            auto dst_ptr = dest_image.buffer().data() + dest_image.meta_data().steps[0] * ( (dest_image.meta_data().size.height-1) - y  );
-            auto src_ptr = src_image.buffer().data()  + src_image.meta_data().steps[0] * y ;
+        flip_rows(src_image, dest_image, 0, src_image.size().height);
+        return true;
+    }
 
-            memcpy( dst_ptr, src_ptr, src_image.meta_data().steps[0] );
-        }
+    auto flip_y(const utils::ConstImageView  &src_image, const utils::ImageView  &dest_image, ThreadPool  &pool) -> bool
+    {
+        Expects( src_image.size() == dest_image.size() && src_image.meta_data().format == dest_image.meta_data().format );
+
+        pool.parallel_for(0, src_image.size().height, row_alignment(src_image.meta_data()), [&src_image, &dest_image](std::size_t first, std::size_t last) {
+            flip_rows(src_image, dest_image, first, last);
+        });
         return true;
     }
 } // namespace nitros::image
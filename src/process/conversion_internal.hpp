@@ -2,8 +2,14 @@
 #ifndef CONVERSION_INTERNAL_PIXEL_HPP
 #define CONVERSION_INTERNAL_PIXEL_HPP
 
+#include "image/image.hpp"
+#include "image/image_view.hpp"
+#include "image/utils.hpp"
 #include <type_traits>
 #include <cstdint>
+#include <algorithm>
+#include <limits>
+#include <vector>
 
 namespace nitros::image
 {
@@ -33,15 +39,24 @@ namespace nitros::image
         *cr = Vt + 128;
     }
 
+    //Q9 coefficient applied with the rounding of _mm_mulhrs_epi16 on (d << 6), so SIMD kernels match exactly
+    inline constexpr auto yuv_coef_mul(int d, int coef) -> int
+    {
+        return (d * 64 * coef + (1 << 14)) >> 15;
+    }
+
     template <typename Num_Type, typename = std::enable_if_t<std::is_integral_v<Num_Type>>>
     void yuv_to_rgb(uint8_t yValue, uint8_t uValue, uint8_t vValue, Num_Type *r, Num_Type *g, Num_Type *b)
     {
-        auto r_ = yValue + (1.370705 * (vValue - 128));
-        auto g_ = yValue - (0.698001 * (vValue - 128)) - (0.337633 * (uValue - 128));
-        auto b_ = yValue + (1.732446 * (uValue - 128));
-        *r = std::clamp<Num_Type>(r_, 0, std::numeric_limits<Num_Type>::max());
-        *g = std::clamp<Num_Type>(g_, 0, std::numeric_limits<Num_Type>::max());
-        *b = std::clamp<Num_Type>(b_, 0, std::numeric_limits<Num_Type>::max());
+        //1.370705, 0.698001, 0.337633, 1.732446 in Q9
+        auto u = uValue - 128;
+        auto v = vValue - 128;
+        auto r_ = yValue + yuv_coef_mul(v, 702);
+        auto g_ = yValue - yuv_coef_mul(v, 357) - yuv_coef_mul(u, 173);
+        auto b_ = yValue + yuv_coef_mul(u, 887);
+        *r = static_cast<Num_Type>( std::clamp(r_, 0, 255) );
+        *g = static_cast<Num_Type>( std::clamp(g_, 0, 255) );
+        *b = static_cast<Num_Type>( std::clamp(b_, 0, 255) );
 
         if constexpr(!std::is_same_v<Num_Type, std::uint8_t>) {
             *r = *r << sizeof(Num_Type)*8 - 8;
@@ -50,47 +65,152 @@ namespace nitros::image
         }
     }
 
-
-    //Assertion should be ensured that src_meta size and dst_meta size are equal
     template<typename NumType, std::size_t  N>
-    inline void rgb_to_yuv444(const utils::ImageMetaData  &src_meta, const utils::ImageMetaData  &dst_meta, const std::uint8_t  *src_st, std::uint8_t  *dst_st)
+    inline void rgb_to_yuv_row(const std::uint8_t  *src, std::uint8_t  *y, std::uint8_t  *cb, std::uint8_t  *cr, std::size_t  width)
     {
         static_assert( std::is_unsigned_v<NumType> );
-        auto dst_plane_0 = dst_st;
-        auto dst_plane_1 = dst_plane_0 + dst_meta.steps[0] * dst_meta.size.height ;
-        auto dst_plane_2 = dst_plane_1 + dst_meta.steps[1] * dst_meta.size.height ;
+        auto px = reinterpret_cast<const NumType*>(src);
+        for(auto x = std::size_t{0}; x < width; x++, px += N)
+        {
+            rbg_yuv<NumType>(px[0], px[1], px[2], y + x, cb + x, cr + x);
+        }
+    }
+
+    //Box average of full resolution chroma rows into one subsampled row, 4:2:2 passes the same row twice
+    inline void chroma_downsample_row(const std::uint8_t  *row_0, const std::uint8_t  *row_1, std::uint8_t  *dst, std::size_t  dst_width)
+    {
+        for(auto x = std::size_t{0}; x < dst_width; x++)
+        {
+            dst[x] = static_cast<std::uint8_t>( (row_0[2 * x] + row_0[2 * x + 1] + row_1[2 * x] + row_1[2 * x + 1] + 2) >> 2 );
+        }
+    }
+
+    //Triangle filter upsampling of the dst pixels [x_begin, x_end), chroma samples sit between two luma pixels
+    //near is the closest chroma row and far the next closest one (near again for 4:2:2), edges are replicated
+    inline void chroma_upsample_span(const std::uint8_t  *near, const std::uint8_t  *far, std::uint8_t  *dst, std::size_t  src_width, std::size_t  x_begin, std::size_t  x_end)
+    {
+        auto col_sum = [near, far](std::size_t  i) { return 3 * near[i] + far[i]; };
 
-        for(auto y = 0; y < src_meta.size.height  ; y++)
+        for(auto x = x_begin; x < x_end; x++)
         {
-            for(auto x = 0; x < src_meta.size.width  ; x++)
-            {
-                auto px = src_st +  y*src_meta.steps[0] + x*N ;
-                auto px_y  = dst_plane_0 + y*dst_meta.steps[0] + x;
-                auto px_cb = dst_plane_1 + y*dst_meta.steps[1] + x;
-                auto px_cr = dst_plane_2 + y*dst_meta.steps[2] + x;
-                rbg_yuv<NumType>(px[0], px[1], px[2], px_y, px_cb, px_cr);
+            auto i = std::min(x / 2, src_width - 1);
+            auto n = i;
+            if(x / 2 < src_width) {
+                n = x % 2 == 0 ? (i == 0 ? 0 : i - 1) : std::min(i + 1, src_width - 1);
             }
+            dst[x] = static_cast<std::uint8_t>( (3 * col_sum(i) + col_sum(n) + 8) >> 4 );
         }
     }
 
-    template<typename NumType, std::size_t  N>
-    inline void yuv444_to_rgb(const utils::ImageMetaData  &src_meta, const utils::ImageMetaData  &dst_meta, const std::uint8_t  *src_st, std::uint8_t  *dst_st)
+    inline void chroma_upsample_row(const std::uint8_t  *near, const std::uint8_t  *far, std::uint8_t  *dst, std::size_t  src_width, std::size_t  dst_width)
     {
-        static_assert( std::is_unsigned_v<NumType> );
-        auto st_plane_0 = src_st;
-        auto st_plane_1 = st_plane_0 + src_meta.steps[0] * src_meta.size.height ;
-        auto st_plane_2 = st_plane_1 + src_meta.steps[1] * src_meta.size.height ;
+        chroma_upsample_span(near, far, dst, src_width, 0, dst_width);
+    }
+
+    inline void byteswap16_row(const std::uint8_t  *src, std::uint8_t  *dst, std::size_t  count)
+    {
+        for(auto i = std::size_t{0}; i < count; i++) {
+            auto low = src[2 * i];
+            dst[2 * i]     = src[2 * i + 1];
+            dst[2 * i + 1] = low;
+        }
+    }
+
+    //Assertion should be ensured that src and dst size are equal
+    //The converters below handle the rows [first_row, last_row), bands must start on a chroma row
+    template<typename RowFn>
+    inline void rgb_to_yuv444(const utils::ConstImageView  &src, const utils::ImageView  &dst, RowFn  &&row_fn, std::size_t  first_row, std::size_t  last_row)
+    {
+        for(auto y = first_row; y < last_row; y++)
+        {
+            row_fn(src.row(y), dst.row(y, 0), dst.row(y, 1), dst.row(y, 2), src.size().width);
+        }
+    }
+
+    //4:2:0 and 4:2:2 destinations, rows are converted at full resolution and the chroma is box averaged
+    //Odd trailing luma rows and columns have no chroma sample of their own and only contribute luma
+    template<typename RowFn, typename DownFn>
+    inline void rgb_to_yuv_subsampled(const utils::ConstImageView  &src, const utils::ImageView  &dst, RowFn  &&row_fn, DownFn  &&down_fn, std::size_t  first_row, std::size_t  last_row)
+    {
+        auto width               = src.size().width;
+        auto [c_width, c_height] = utils::interpreted_plane_img_size(dst.meta_data(), 1);
+        auto v_sub = std::size_t{dst.meta_data().format.planes[1].height_factor.den};
 
-        for(auto y = 0; y < src_meta.size.height  ; y++)
+        auto scratch = std::vector<std::uint8_t>(width * 4);
+        auto cb_0 = scratch.data();
+        auto cr_0 = cb_0 + width;
+        auto cb_1 = cr_0 + width;
+        auto cr_1 = cb_1 + width;
+
+        for(auto cy = first_row / v_sub; cy < std::min(last_row / v_sub, c_height); cy++)
+        {
+            auto y = cy * v_sub;
+            row_fn(src.row(y), dst.row(y), cb_0, cr_0, width);
+            if(v_sub == 2) {
+                row_fn(src.row(y + 1), dst.row(y + 1), cb_1, cr_1, width);
+            }
+
+            down_fn(cb_0, v_sub == 2 ? cb_1 : cb_0, dst.row(cy, 1), c_width);
+            down_fn(cr_0, v_sub == 2 ? cr_1 : cr_0, dst.row(cy, 2), c_width);
+        }
+
+        for(auto y = std::max(first_row, c_height * v_sub); y < last_row; y++)
+        {
+            row_fn(src.row(y), dst.row(y), cb_0, cr_0, width);
+        }
+    }
+
+    //bgr swaps the r and b channel, 4 channel destinations get an opaque alpha
+    template<std::size_t  N, bool  bgr>
+    inline void yuv_to_rgb_row(const std::uint8_t  *y, const std::uint8_t  *cb, const std::uint8_t  *cr, std::uint8_t  *dst, std::size_t  width)
+    {
+        for(auto x = std::size_t{0}; x < width; x++, dst += N)
+        {
+            if constexpr (bgr) {
+                yuv_to_rgb<std::uint8_t>(y[x], cb[x], cr[x], dst + 2, dst + 1, dst);
+            }
+            else {
+                yuv_to_rgb<std::uint8_t>(y[x], cb[x], cr[x], dst, dst + 1, dst + 2);
+            }
+
+            if constexpr (N == 4) {
+                dst[3] = std::numeric_limits<std::uint8_t>::max();
+            }
+        }
+    }
+
+    template<typename RowFn>
+    inline void yuv444_to_rgb(const utils::ConstImageView  &src, const utils::ImageView  &dst, RowFn  &&row_fn, std::size_t  first_row, std::size_t  last_row)
+    {
+        for(auto y = first_row; y < last_row; y++)
+        {
+            row_fn(src.row(y, 0), src.row(y, 1), src.row(y, 2), dst.row(y), src.size().width);
+        }
+    }
+
+    //4:2:0 and 4:2:2 sources, chroma is interpolated to full resolution rows before the 444 row conversion
+    template<typename RowFn, typename UpFn>
+    inline void yuv_subsampled_to_rgb(const utils::ConstImageView  &src, const utils::ImageView  &dst, RowFn  &&row_fn, UpFn  &&up_fn, std::size_t  first_row, std::size_t  last_row)
+    {
+        auto width               = src.size().width;
+        auto [c_width, c_height] = utils::interpreted_plane_img_size(src.meta_data(), 1);
+        auto v_sub = std::size_t{src.meta_data().format.planes[1].height_factor.den};
+
+        auto scratch = std::vector<std::uint8_t>(width * 2);
+        auto cb = scratch.data();
+        auto cr = cb + width;
+
+        for(auto y = first_row; y < last_row; y++)
         {
-            for(auto x = 0; x < src_meta.size.width  ; x++)
-            {
-                auto px = dst_st +  y*dst_meta.steps[0] + x*N ;
-                auto px_y  = st_plane_0 + y * src_meta.steps[0] + x;
-                auto px_cb = st_plane_1 + y * src_meta.steps[1] + x;
-                auto px_cr = st_plane_2 + y * src_meta.steps[2] + x;
-                yuv_to_rgb<NumType>( *px_y, *px_cb, *px_cr, px, px + 1, px + 2 );
+            auto near = std::min(y / v_sub, c_height - 1);
+            auto far  = near;
+            if(v_sub == 2 && y / 2 < c_height) {
+                far = y % 2 == 0 ? (near == 0 ? 0 : near - 1) : std::min(near + 1, c_height - 1);
             }
+
+            up_fn(src.row(near, 1), src.row(far, 1), cb, c_width, width);
+            up_fn(src.row(near, 2), src.row(far, 2), cr, c_width, width);
+            row_fn(src.row(y), cb, cr, dst.row(y), width);
         }
     }
 }
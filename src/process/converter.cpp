@@ -0,0 +1,292 @@
+#include "image/process/converter.hpp"
+#include "image/pixel/read_write.hpp"
+#include "image/utils.hpp"
+#include "conversion_internal.hpp"
+#include "kernels.hpp"
+#include <gsl/gsl>
+#include <assert.h>
+#include <algorithm>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+
+namespace nitros::image
+{
+    struct ConversionPlan::Entry
+    {
+        utils::pixel::Format  src;
+        utils::pixel::Format  dest;
+        ConvertRowsFn         convert;
+        std::size_t           row_alignment;
+        bool                  fast;
+    };
+
+    namespace
+    {
+        using Format = utils::pixel::Format;
+        using FormatPair = std::pair<Format, Format>;
+
+        struct FormatPairHash
+        {
+            auto operator()(const FormatPair  &pair) const noexcept -> std::size_t
+            {
+                auto seed = utils::pixel::FormatHash{}(pair.first);
+                utils::pixel::hash_combine(seed, utils::pixel::FormatHash{}(pair.second));
+                return seed;
+            }
+        };
+
+        auto row_alignment(const Format  &format) -> std::size_t
+        {
+            auto alignment = std::size_t{1};
+            if(format.planar_info.is_planar) {
+                for(auto &plane : format.planes) {
+                    alignment = std::max<std::size_t>(alignment, plane.height_factor.den);
+                }
+            }
+            return alignment;
+        }
+
+        auto is_rgb(const Format  &format) -> bool
+        {
+            return format.pixel_type == utils::pixel::type::rgba || format.pixel_type == utils::pixel::type::rgb;
+        }
+
+        void rgb_to_yuv_generic(const utils::ConstImageView  &src_image, const utils::ImageView  &dest_image, std::size_t  first, std::size_t  last)
+        {
+            auto reader = utils::pixel::ReaderRGBA<std::uint8_t>{src_image};
+            auto writer = utils::pixel::WriterYUV<std::uint8_t>{dest_image};
+            auto width = src_image.meta_data().size.width;
+            auto rgba_row = std::vector<utils::pixel::PixelRGBA<std::uint8_t>>(width);
+            auto yuv_row  = std::vector<utils::pixel::PixelYUV<std::uint8_t>>(width);
+
+            for(auto y = first; y < last; y++)
+            {
+                reader.read_row(y, rgba_row);
+                for(auto x = std::size_t{0}; x < width; x++)
+                {
+                    auto &px = rgba_row[x];
+                    rbg_yuv(px.r, px.g, px.b, &yuv_row[x].y, &yuv_row[x].cb, &yuv_row[x].cr);
+                    yuv_row[x].a = px.a;
+                }
+                writer.write_row(y, yuv_row);
+            }
+        }
+
+        void yuv_to_rgb_generic(const utils::ConstImageView  &src_image, const utils::ImageView  &dest_image, std::size_t  first, std::size_t  last)
+        {
+            auto reader = utils::pixel::ReaderYUV<std::uint8_t>{src_image};
+            auto writer = utils::pixel::WriterRGBA<std::uint8_t>{dest_image};
+            auto width = src_image.meta_data().size.width;
+            auto yuv_row  = std::vector<utils::pixel::PixelYUV<std::uint8_t>>(width);
+            auto rgba_row = std::vector<utils::pixel::PixelRGBA<std::uint8_t>>(width);
+
+            for(auto y = first; y < last; y++)
+            {
+                reader.read_row(y, yuv_row);
+                for(auto x = std::size_t{0}; x < width; x++)
+                {
+                    auto &px = yuv_row[x];
+                    yuv_to_rgb(px.y, px.cb, px.cr, &rgba_row[x].r, &rgba_row[x].g, &rgba_row[x].b);
+                    rgba_row[x].a = px.a;
+                }
+                writer.write_row(y, rgba_row);
+            }
+        }
+
+        //Subsampled kernels need at least one chroma sample, smaller images take the generic path
+        auto has_chroma(const utils::ImageMetaData  &meta) -> bool
+        {
+            auto [c_width, c_height] = utils::interpreted_plane_img_size(meta, 1);
+            return c_width > 0 && c_height > 0;
+        }
+
+        auto rgb_to_yuv444_fn(kernels::RgbToYuvRow  row_fn) -> ConvertRowsFn
+        {
+            return [row_fn](const utils::ConstImageView  &src, const utils::ImageView  &dest, std::size_t  first, std::size_t  last) {
+                rgb_to_yuv444(src, dest, row_fn, first, last);
+            };
+        }
+
+        auto rgb_to_yuv_subsampled_fn(kernels::RgbToYuvRow  row_fn, kernels::ChromaDownRow  down_fn) -> ConvertRowsFn
+        {
+            return [row_fn, down_fn](const utils::ConstImageView  &src, const utils::ImageView  &dest, std::size_t  first, std::size_t  last) {
+                if(!has_chroma(dest.meta_data())) {
+                    rgb_to_yuv_generic(src, dest, first, last);
+                    return;
+                }
+                rgb_to_yuv_subsampled(src, dest, row_fn, down_fn, first, last);
+            };
+        }
+
+        auto yuv444_to_rgb_fn(kernels::YuvToRgbRow  row_fn) -> ConvertRowsFn
+        {
+            return [row_fn](const utils::ConstImageView  &src, const utils::ImageView  &dest, std::size_t  first, std::size_t  last) {
+                yuv444_to_rgb(src, dest, row_fn, first, last);
+            };
+        }
+
+        auto yuv_subsampled_to_rgb_fn(kernels::YuvToRgbRow  row_fn, kernels::ChromaUpRow  up_fn) -> ConvertRowsFn
+        {
+            return [row_fn, up_fn](const utils::ConstImageView  &src, const utils::ImageView  &dest, std::size_t  first, std::size_t  last) {
+                if(!has_chroma(src.meta_data())) {
+                    yuv_to_rgb_generic(src, dest, first, last);
+                    return;
+                }
+                yuv_subsampled_to_rgb(src, dest, row_fn, up_fn, first, last);
+            };
+        }
+
+        class Registry
+        {
+            public:
+            Registry()
+            {
+                auto &k = kernels::conversion_kernels();
+
+                auto rgb_sources = { std::pair{utils::pixel::RGBA8::value, k.rgba8_to_yuv},
+                                     std::pair{utils::pixel::RGB8::value,  k.rgb8_to_yuv} };
+                for(auto [format, row_fn] : rgb_sources)
+                {
+                    add(format, utils::pixel::YUV444p::value, rgb_to_yuv444_fn(row_fn), 1, true);
+                    add(format, utils::pixel::YUV422p::value, rgb_to_yuv_subsampled_fn(row_fn, k.chroma_downsample), 1, true);
+                    add(format, utils::pixel::YUV420p::value, rgb_to_yuv_subsampled_fn(row_fn, k.chroma_downsample), 1, true);
+                }
+
+                auto rgb_destinations = { std::pair{utils::pixel::RGBA8::value, k.yuv_to_rgba8},
+                                          std::pair{utils::pixel::BGRA8::value, k.yuv_to_bgra8},
+                                          std::pair{utils::pixel::RGB8::value,  k.yuv_to_rgb8},
+                                          std::pair{utils::pixel::BGR8::value,  k.yuv_to_bgr8} };
+                for(auto [format, row_fn] : rgb_destinations)
+                {
+                    add(utils::pixel::YUV444p::value, format, yuv444_to_rgb_fn(row_fn), 1, true);
+                    add(utils::pixel::YUV422p::value, format, yuv_subsampled_to_rgb_fn(row_fn, k.chroma_upsample), 1, true);
+                    add(utils::pixel::YUV420p::value, format, yuv_subsampled_to_rgb_fn(row_fn, k.chroma_upsample), 1, true);
+                }
+            }
+
+            auto find(const Format  &src, const Format  &dest) const -> std::shared_ptr<const ConversionPlan::Entry>
+            {
+                auto lock = std::shared_lock{_mutex};
+                auto it = _entries.find({src, dest});
+                return it != _entries.end() ? it->second : nullptr;
+            }
+
+            auto add(const Format  &src, const Format  &dest, ConvertRowsFn  convert, std::size_t  alignment, bool  fast) -> std::shared_ptr<const ConversionPlan::Entry>
+            {
+                alignment = std::max({alignment, row_alignment(src), row_alignment(dest)});
+                auto entry = std::make_shared<const ConversionPlan::Entry>(ConversionPlan::Entry{src, dest, std::move(convert), alignment, fast});
+
+                auto lock = std::unique_lock{_mutex};
+                //A registered converter is never replaced by a generic one resolved concurrently
+                auto [it, inserted] = _entries.try_emplace({src, dest}, entry);
+                if(!inserted && (fast || !it->second->fast)) {
+                    it->second = entry;
+                }
+                return it->second;
+            }
+
+            auto fast_pairs() const -> std::vector<FormatPair>
+            {
+                auto lock = std::shared_lock{_mutex};
+                auto pairs = std::vector<FormatPair>{};
+                for(auto &[key, entry] : _entries) {
+                    if(entry->fast) {
+                        pairs.push_back(key);
+                    }
+                }
+                return pairs;
+            }
+
+            private:
+            mutable std::shared_mutex  _mutex;
+            std::unordered_map<FormatPair, std::shared_ptr<const ConversionPlan::Entry>, FormatPairHash>  _entries;
+        };
+
+        auto registry() -> Registry&
+        {
+            static auto instance = Registry{};
+            return instance;
+        }
+    } // namespace
+
+    ConversionPlan::ConversionPlan(std::shared_ptr<const Entry>  entry) noexcept
+        :_entry{std::move(entry)}
+    {}
+
+    ConversionPlan::operator bool() const noexcept
+    {
+        return _entry != nullptr;
+    }
+
+    auto ConversionPlan::is_fast() const noexcept -> bool
+    {
+        return _entry && _entry->fast;
+    }
+
+    auto ConversionPlan::row_alignment() const noexcept -> std::size_t
+    {
+        return _entry ? _entry->row_alignment : 1;
+    }
+
+    auto ConversionPlan::operator()(const utils::ConstImageView  &src, const utils::ImageView  &dest) const -> bool
+    {
+        if(!_entry) {
+            return false;
+        }
+        Expects( src.meta_data().format == _entry->src && dest.meta_data().format == _entry->dest );
+        assert( src.size() == dest.size() );
+
+        _entry->convert(src, dest, 0, src.size().height);
+        return true;
+    }
+
+    auto ConversionPlan::operator()(const utils::ConstImageView  &src, const utils::ImageView  &dest, ThreadPool  &pool) const -> bool
+    {
+        if(!_entry) {
+            return false;
+        }
+        Expects( src.meta_data().format == _entry->src && dest.meta_data().format == _entry->dest );
+        assert( src.size() == dest.size() );
+
+        auto &convert = _entry->convert;
+        pool.parallel_for(0, src.size().height, _entry->row_alignment, [&convert, &src, &dest](std::size_t first, std::size_t last) {
+            convert(src, dest, first, last);
+        });
+        return true;
+    }
+
+    auto plan_conversion(const utils::pixel::Format  &src, const utils::pixel::Format  &dest) -> ConversionPlan
+    {
+        auto &reg = registry();
+        if(auto entry = reg.find(src, dest)) {
+            return ConversionPlan{std::move(entry)};
+        }
+
+        //Generic converters are resolved once and cached like the dedicated ones
+        if(is_rgb(src) && dest.pixel_type == utils::pixel::type::yuv) {
+            return ConversionPlan{reg.add(src, dest, rgb_to_yuv_generic, 1, false)};
+        }
+        if(src.pixel_type == utils::pixel::type::yuv && is_rgb(dest)) {
+            return ConversionPlan{reg.add(src, dest, yuv_to_rgb_generic, 1, false)};
+        }
+        return {};
+    }
+
+    auto has_fast_path(const utils::pixel::Format  &src, const utils::pixel::Format  &dest) -> bool
+    {
+        auto entry = registry().find(src, dest);
+        return entry && entry->fast;
+    }
+
+    auto fast_conversions() -> std::vector<std::pair<utils::pixel::Format, utils::pixel::Format>>
+    {
+        return registry().fast_pairs();
+    }
+
+    void register_converter(const utils::pixel::Format  &src, const utils::pixel::Format  &dest, ConvertRowsFn  convert, std::size_t  row_alignment)
+    {
+        Expects( convert != nullptr );
+        registry().add(src, dest, std::move(convert), row_alignment, true);
+    }
+} // namespace nitros::image
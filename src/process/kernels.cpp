@@ -0,0 +1,145 @@
+#include "kernels.hpp"
+#include "conversion_internal.hpp"
+
+#if defined(NIMAGE_X86) && defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace nitros::image::kernels
+{
+    namespace
+    {
+        auto detect_isa() noexcept -> Isa
+        {
+#if defined(NIMAGE_X86) && (defined(__GNUC__) || defined(__clang__))
+            __builtin_cpu_init();
+            if(__builtin_cpu_supports("avx512bw") && __builtin_cpu_supports("avx512vl")) {
+                return Isa::avx512;
+            }
+            if(__builtin_cpu_supports("avx2")) {
+                return Isa::avx2;
+            }
+            if(__builtin_cpu_supports("sse4.1")) {
+                return Isa::sse41;
+            }
+#elif defined(NIMAGE_X86) && defined(_MSC_VER)
+            int info[4];
+            __cpuid(info, 1);
+            auto sse41   = (info[2] & (1 << 19)) != 0;
+            auto osxsave = (info[2] & (1 << 27)) != 0;
+            auto xcr0    = osxsave ? _xgetbv(0) : 0;
+
+            __cpuidex(info, 7, 0);
+            auto avx2     = (info[1] & (1 << 5)) != 0 && (xcr0 & 0x06) == 0x06;
+            auto avx512bw = (info[1] & (1 << 16)) != 0 && (info[1] & (1 << 30)) != 0 && (info[1] & (1u << 31)) != 0 && (xcr0 & 0xe6) == 0xe6;
+
+            if(avx512bw) {
+                return Isa::avx512;
+            }
+            if(avx2) {
+                return Isa::avx2;
+            }
+            if(sse41) {
+                return Isa::sse41;
+            }
+#endif
+            return Isa::scalar;
+        }
+    } // namespace
+
+    void rgb8_to_yuv_row_scalar(const std::uint8_t *src, std::uint8_t *y, std::uint8_t *cb, std::uint8_t *cr, std::size_t width)
+    {
+        rgb_to_yuv_row<std::uint8_t, 3>(src, y, cb, cr, width);
+    }
+
+    void rgba8_to_yuv_row_scalar(const std::uint8_t *src, std::uint8_t *y, std::uint8_t *cb, std::uint8_t *cr, std::size_t width)
+    {
+        rgb_to_yuv_row<std::uint8_t, 4>(src, y, cb, cr, width);
+    }
+
+    void yuv_to_rgb8_row_scalar(const std::uint8_t *y, const std::uint8_t *cb, const std::uint8_t *cr, std::uint8_t *dst, std::size_t width)
+    {
+        yuv_to_rgb_row<3, false>(y, cb, cr, dst, width);
+    }
+
+    void yuv_to_bgr8_row_scalar(const std::uint8_t *y, const std::uint8_t *cb, const std::uint8_t *cr, std::uint8_t *dst, std::size_t width)
+    {
+        yuv_to_rgb_row<3, true>(y, cb, cr, dst, width);
+    }
+
+    void yuv_to_rgba8_row_scalar(const std::uint8_t *y, const std::uint8_t *cb, const std::uint8_t *cr, std::uint8_t *dst, std::size_t width)
+    {
+        yuv_to_rgb_row<4, false>(y, cb, cr, dst, width);
+    }
+
+    void yuv_to_bgra8_row_scalar(const std::uint8_t *y, const std::uint8_t *cb, const std::uint8_t *cr, std::uint8_t *dst, std::size_t width)
+    {
+        yuv_to_rgb_row<4, true>(y, cb, cr, dst, width);
+    }
+
+    void chroma_downsample_row_scalar(const std::uint8_t *row_0, const std::uint8_t *row_1, std::uint8_t *dst, std::size_t dst_width)
+    {
+        chroma_downsample_row(row_0, row_1, dst, dst_width);
+    }
+
+    void chroma_upsample_row_scalar(const std::uint8_t *near, const std::uint8_t *far, std::uint8_t *dst, std::size_t src_width, std::size_t dst_width)
+    {
+        chroma_upsample_row(near, far, dst, src_width, dst_width);
+    }
+
+    void byteswap16_row_scalar(const std::uint8_t *src, std::uint8_t *dst, std::size_t count)
+    {
+        byteswap16_row(src, dst, count);
+    }
+
+    auto cpu_isa() noexcept -> Isa
+    {
+        static const auto isa = detect_isa();
+        return isa;
+    }
+
+    auto conversion_kernels(Isa isa) noexcept -> ConversionKernels
+    {
+        isa = std::min(isa, cpu_isa());
+        switch (isa)
+        {
+#if defined(NIMAGE_X86)
+        case Isa::avx512:
+            //Chroma resampling and byte swaps are bandwidth bound, the AVX2 kernels are used
+            return { .isa = isa,
+                     .rgb8_to_yuv  = rgb8_to_yuv_row_avx512,  .rgba8_to_yuv = rgba8_to_yuv_row_avx512,
+                     .yuv_to_rgb8  = yuv_to_rgb8_row_avx512,  .yuv_to_bgr8  = yuv_to_bgr8_row_avx512,
+                     .yuv_to_rgba8 = yuv_to_rgba8_row_avx512, .yuv_to_bgra8 = yuv_to_bgra8_row_avx512,
+                     .chroma_downsample = chroma_downsample_row_avx2, .chroma_upsample = chroma_upsample_row_avx2,
+                     .byteswap16 = byteswap16_row_avx2 };
+        case Isa::avx2:
+            return { .isa = isa,
+                     .rgb8_to_yuv  = rgb8_to_yuv_row_avx2,  .rgba8_to_yuv = rgba8_to_yuv_row_avx2,
+                     .yuv_to_rgb8  = yuv_to_rgb8_row_avx2,  .yuv_to_bgr8  = yuv_to_bgr8_row_avx2,
+                     .yuv_to_rgba8 = yuv_to_rgba8_row_avx2, .yuv_to_bgra8 = yuv_to_bgra8_row_avx2,
+                     .chroma_downsample = chroma_downsample_row_avx2, .chroma_upsample = chroma_upsample_row_avx2,
+                     .byteswap16 = byteswap16_row_avx2 };
+        case Isa::sse41:
+            return { .isa = isa,
+                     .rgb8_to_yuv  = rgb8_to_yuv_row_sse41,  .rgba8_to_yuv = rgba8_to_yuv_row_sse41,
+                     .yuv_to_rgb8  = yuv_to_rgb8_row_sse41,  .yuv_to_bgr8  = yuv_to_bgr8_row_sse41,
+                     .yuv_to_rgba8 = yuv_to_rgba8_row_sse41, .yuv_to_bgra8 = yuv_to_bgra8_row_sse41,
+                     .chroma_downsample = chroma_downsample_row_sse41, .chroma_upsample = chroma_upsample_row_sse41,
+                     .byteswap16 = byteswap16_row_sse41 };
+#endif
+        default:
+            return { .isa = Isa::scalar,
+                     .rgb8_to_yuv  = rgb8_to_yuv_row_scalar,  .rgba8_to_yuv = rgba8_to_yuv_row_scalar,
+                     .yuv_to_rgb8  = yuv_to_rgb8_row_scalar,  .yuv_to_bgr8  = yuv_to_bgr8_row_scalar,
+                     .yuv_to_rgba8 = yuv_to_rgba8_row_scalar, .yuv_to_bgra8 = yuv_to_bgra8_row_scalar,
+                     .chroma_downsample = chroma_downsample_row_scalar, .chroma_upsample = chroma_upsample_row_scalar,
+                     .byteswap16 = byteswap16_row_scalar };
+        }
+    }
+
+    auto conversion_kernels() noexcept -> const ConversionKernels&
+    {
+        static const auto kernels = conversion_kernels(cpu_isa());
+        return kernels;
+    }
+} // namespace nitros::image::kernels
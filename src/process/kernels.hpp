@@ -0,0 +1,95 @@
+
+#ifndef NITROS_IMAGE_KERNELS_HPP
+#define NITROS_IMAGE_KERNELS_HPP
+
+#include "simd.hpp"
+#include <cstdint>
+#include <cstddef>
+
+namespace nitros::image::kernels
+{
+    enum class Isa {
+        scalar, sse41, avx2, avx512
+    };
+
+    //Converts one row of interleaved 8 bit RGB(A) to the three YUV444 planes
+    using RgbToYuvRow = void (*)(const std::uint8_t *src, std::uint8_t *y, std::uint8_t *cb, std::uint8_t *cr, std::size_t width);
+
+    //Converts one row of the three YUV444 planes to interleaved 8 bit RGB(A), alpha is written opaque
+    using YuvToRgbRow = void (*)(const std::uint8_t *y, const std::uint8_t *cb, const std::uint8_t *cr, std::uint8_t *dst, std::size_t width);
+
+    //Averages two full resolution chroma rows into dst_width subsampled samples
+    using ChromaDownRow = void (*)(const std::uint8_t *row_0, const std::uint8_t *row_1, std::uint8_t *dst, std::size_t dst_width);
+
+    //Interpolates a subsampled chroma row (weighted 3:1 with far) to dst_width samples
+    using ChromaUpRow = void (*)(const std::uint8_t *near, const std::uint8_t *far, std::uint8_t *dst, std::size_t src_width, std::size_t dst_width);
+
+    //Swaps the bytes of count 16 bit samples between big and little endian, src may equal dst
+    using ByteSwap16Row = void (*)(const std::uint8_t *src, std::uint8_t *dst, std::size_t count);
+
+    struct ConversionKernels
+    {
+        Isa          isa;
+        RgbToYuvRow  rgb8_to_yuv;
+        RgbToYuvRow  rgba8_to_yuv;
+
+        YuvToRgbRow  yuv_to_rgb8;
+        YuvToRgbRow  yuv_to_bgr8;
+        YuvToRgbRow  yuv_to_rgba8;
+        YuvToRgbRow  yuv_to_bgra8;
+
+        ChromaDownRow  chroma_downsample;
+        ChromaUpRow    chroma_upsample;
+
+        ByteSwap16Row  byteswap16;
+    };
+
+    //Best ISA of the running CPU, detected once
+    auto cpu_isa() noexcept -> Isa;
+
+    //Kernels for the given ISA, ISAs not supported by the CPU fall back to the best supported one
+    auto conversion_kernels(Isa isa) noexcept -> ConversionKernels;
+    //Kernels for cpu_isa()
+    auto conversion_kernels() noexcept -> const ConversionKernels&;
+
+    void rgb8_to_yuv_row_scalar(const std::uint8_t *src, std::uint8_t *y, std::uint8_t *cb, std::uint8_t *cr, std::size_t width);
+    void rgba8_to_yuv_row_scalar(const std::uint8_t *src, std::uint8_t *y, std::uint8_t *cb, std::uint8_t *cr, std::size_t width);
+    void yuv_to_rgb8_row_scalar(const std::uint8_t *y, const std::uint8_t *cb, const std::uint8_t *cr, std::uint8_t *dst, std::size_t width);
+    void yuv_to_bgr8_row_scalar(const std::uint8_t *y, const std::uint8_t *cb, const std::uint8_t *cr, std::uint8_t *dst, std::size_t width);
+    void yuv_to_rgba8_row_scalar(const std::uint8_t *y, const std::uint8_t *cb, const std::uint8_t *cr, std::uint8_t *dst, std::size_t width);
+    void yuv_to_bgra8_row_scalar(const std::uint8_t *y, const std::uint8_t *cb, const std::uint8_t *cr, std::uint8_t *dst, std::size_t width);
+    void chroma_downsample_row_scalar(const std::uint8_t *row_0, const std::uint8_t *row_1, std::uint8_t *dst, std::size_t dst_width);
+    void chroma_upsample_row_scalar(const std::uint8_t *near, const std::uint8_t *far, std::uint8_t *dst, std::size_t src_width, std::size_t dst_width);
+    void byteswap16_row_scalar(const std::uint8_t *src, std::uint8_t *dst, std::size_t count);
+
+#if defined(NIMAGE_X86)
+    void rgb8_to_yuv_row_sse41(const std::uint8_t *src, std::uint8_t *y, std::uint8_t *cb, std::uint8_t *cr, std::size_t width);
+    void rgba8_to_yuv_row_sse41(const std::uint8_t *src, std::uint8_t *y, std::uint8_t *cb, std::uint8_t *cr, std::size_t width);
+    void yuv_to_rgb8_row_sse41(const std::uint8_t *y, const std::uint8_t *cb, const std::uint8_t *cr, std::uint8_t *dst, std::size_t width);
+    void yuv_to_bgr8_row_sse41(const std::uint8_t *y, const std::uint8_t *cb, const std::uint8_t *cr, std::uint8_t *dst, std::size_t width);
+    void yuv_to_rgba8_row_sse41(const std::uint8_t *y, const std::uint8_t *cb, const std::uint8_t *cr, std::uint8_t *dst, std::size_t width);
+    void yuv_to_bgra8_row_sse41(const std::uint8_t *y, const std::uint8_t *cb, const std::uint8_t *cr, std::uint8_t *dst, std::size_t width);
+    void chroma_downsample_row_sse41(const std::uint8_t *row_0, const std::uint8_t *row_1, std::uint8_t *dst, std::size_t dst_width);
+    void chroma_upsample_row_sse41(const std::uint8_t *near, const std::uint8_t *far, std::uint8_t *dst, std::size_t src_width, std::size_t dst_width);
+    void byteswap16_row_sse41(const std::uint8_t *src, std::uint8_t *dst, std::size_t count);
+
+    void rgb8_to_yuv_row_avx2(const std::uint8_t *src, std::uint8_t *y, std::uint8_t *cb, std::uint8_t *cr, std::size_t width);
+    void rgba8_to_yuv_row_avx2(const std::uint8_t *src, std::uint8_t *y, std::uint8_t *cb, std::uint8_t *cr, std::size_t width);
+    void yuv_to_rgb8_row_avx2(const std::uint8_t *y, const std::uint8_t *cb, const std::uint8_t *cr, std::uint8_t *dst, std::size_t width);
+    void yuv_to_bgr8_row_avx2(const std::uint8_t *y, const std::uint8_t *cb, const std::uint8_t *cr, std::uint8_t *dst, std::size_t width);
+    void yuv_to_rgba8_row_avx2(const std::uint8_t *y, const std::uint8_t *cb, const std::uint8_t *cr, std::uint8_t *dst, std::size_t width);
+    void yuv_to_bgra8_row_avx2(const std::uint8_t *y, const std::uint8_t *cb, const std::uint8_t *cr, std::uint8_t *dst, std::size_t width);
+    void chroma_downsample_row_avx2(const std::uint8_t *row_0, const std::uint8_t *row_1, std::uint8_t *dst, std::size_t dst_width);
+    void chroma_upsample_row_avx2(const std::uint8_t *near, const std::uint8_t *far, std::uint8_t *dst, std::size_t src_width, std::size_t dst_width);
+    void byteswap16_row_avx2(const std::uint8_t *src, std::uint8_t *dst, std::size_t count);
+
+    void rgb8_to_yuv_row_avx512(const std::uint8_t *src, std::uint8_t *y, std::uint8_t *cb, std::uint8_t *cr, std::size_t width);
+    void rgba8_to_yuv_row_avx512(const std::uint8_t *src, std::uint8_t *y, std::uint8_t *cb, std::uint8_t *cr, std::size_t width);
+    void yuv_to_rgb8_row_avx512(const std::uint8_t *y, const std::uint8_t *cb, const std::uint8_t *cr, std::uint8_t *dst, std::size_t width);
+    void yuv_to_bgr8_row_avx512(const std::uint8_t *y, const std::uint8_t *cb, const std::uint8_t *cr, std::uint8_t *dst, std::size_t width);
+    void yuv_to_rgba8_row_avx512(const std::uint8_t *y, const std::uint8_t *cb, const std::uint8_t *cr, std::uint8_t *dst, std::size_t width);
+    void yuv_to_bgra8_row_avx512(const std::uint8_t *y, const std::uint8_t *cb, const std::uint8_t *cr, std::uint8_t *dst, std::size_t width);
+#endif
+} // namespace nitros::image::kernels
+
+#endif
@@ -0,0 +1,218 @@
+#include "kernels.hpp"
+#include "kernels_x86.hpp"
+#include "conversion_internal.hpp"
+
+#if defined(NIMAGE_X86)
+
+namespace nitros::image::kernels
+{
+    namespace
+    {
+        //Same fixed point matrix as rbg_yuv, every intermediate fits the 16 bit lanes
+        NIMAGE_TARGET_AVX2 inline void rgb_to_yuv_epi16(__m256i  r, __m256i  g, __m256i  b, __m256i  &y, __m256i  &cb, __m256i  &cr)
+        {
+            const auto bias = _mm256_set1_epi16(128);
+
+            auto y_ = _mm256_add_epi16( _mm256_add_epi16(_mm256_mullo_epi16(r, _mm256_set1_epi16(77)), _mm256_mullo_epi16(g, _mm256_set1_epi16(150))),
+                                        _mm256_add_epi16(_mm256_mullo_epi16(b, _mm256_set1_epi16(29)), bias) );
+            auto u_ = _mm256_add_epi16( _mm256_add_epi16(_mm256_mullo_epi16(r, _mm256_set1_epi16(-43)), _mm256_mullo_epi16(g, _mm256_set1_epi16(-84))),
+                                        _mm256_add_epi16(_mm256_mullo_epi16(b, _mm256_set1_epi16(127)), bias) );
+            auto v_ = _mm256_add_epi16( _mm256_add_epi16(_mm256_mullo_epi16(r, _mm256_set1_epi16(127)), _mm256_mullo_epi16(g, _mm256_set1_epi16(-106))),
+                                        _mm256_add_epi16(_mm256_mullo_epi16(b, _mm256_set1_epi16(-21)), bias) );
+
+            y  = _mm256_srli_epi16(y_, 8);
+            cb = _mm256_add_epi16(_mm256_srai_epi16(u_, 8), bias);
+            cr = _mm256_add_epi16(_mm256_srai_epi16(v_, 8), bias);
+        }
+
+        NIMAGE_TARGET_AVX2 inline auto pack_epi16(__m256i  v) -> __m128i
+        {
+            return _mm_packus_epi16(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+        }
+
+        template <std::size_t N>
+        NIMAGE_TARGET_AVX2 inline void rgb_to_yuv_16(const std::uint8_t *src, std::uint8_t *y, std::uint8_t *cb, std::uint8_t *cr)
+        {
+            __m128i r, g, b;
+            x86::deinterleave<N>(src, r, g, b);
+
+            __m256i y_, cb_, cr_;
+            rgb_to_yuv_epi16(_mm256_cvtepu8_epi16(r), _mm256_cvtepu8_epi16(g), _mm256_cvtepu8_epi16(b), y_, cb_, cr_);
+
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(y),  pack_epi16(y_));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(cb), pack_epi16(cb_));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(cr), pack_epi16(cr_));
+        }
+
+        template <std::size_t N>
+        NIMAGE_TARGET_AVX2 void rgb_to_yuv_row_impl(const std::uint8_t *src, std::uint8_t *y, std::uint8_t *cb, std::uint8_t *cr, std::size_t width)
+        {
+            auto x = std::size_t{0};
+            for( ; x + 32 <= width; x += 32)
+            {
+                rgb_to_yuv_16<N>(src + x * N, y + x, cb + x, cr + x);
+                rgb_to_yuv_16<N>(src + (x + 16) * N, y + x + 16, cb + x + 16, cr + x + 16);
+            }
+            for( ; x + 16 <= width; x += 16)
+            {
+                rgb_to_yuv_16<N>(src + x * N, y + x, cb + x, cr + x);
+            }
+
+            rgb_to_yuv_row<std::uint8_t, N>(src + x * N, y + x, cb + x, cr + x, width - x);
+        }
+
+        //Chroma is (c - 128) << 6 so _mm256_mulhrs_epi16 with a Q9 coefficient rounds like yuv_coef_mul
+        NIMAGE_TARGET_AVX2 inline void yuv_to_rgb_epi16(__m256i  y, __m256i  u, __m256i  v, __m256i  &r, __m256i  &g, __m256i  &b)
+        {
+            r = _mm256_add_epi16(y, _mm256_mulhrs_epi16(v, _mm256_set1_epi16(702)));
+            g = _mm256_sub_epi16(_mm256_sub_epi16(y, _mm256_mulhrs_epi16(v, _mm256_set1_epi16(357))), _mm256_mulhrs_epi16(u, _mm256_set1_epi16(173)));
+            b = _mm256_add_epi16(y, _mm256_mulhrs_epi16(u, _mm256_set1_epi16(887)));
+        }
+
+        NIMAGE_TARGET_AVX2 inline auto load_chroma(const std::uint8_t  *c) -> __m256i
+        {
+            auto c_ = _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(c)));
+            return _mm256_slli_epi16(_mm256_sub_epi16(c_, _mm256_set1_epi16(128)), 6);
+        }
+
+        template <std::size_t N, bool bgr>
+        NIMAGE_TARGET_AVX2 inline void yuv_to_rgb_16(const std::uint8_t *y, const std::uint8_t *cb, const std::uint8_t *cr, std::uint8_t *dst)
+        {
+            __m256i r, g, b;
+            yuv_to_rgb_epi16(_mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(y))), load_chroma(cb), load_chroma(cr), r, g, b);
+            x86::interleave<N, bgr>(dst, pack_epi16(r), pack_epi16(g), pack_epi16(b));
+        }
+
+        template <std::size_t N, bool bgr>
+        NIMAGE_TARGET_AVX2 void yuv_to_rgb_row_impl(const std::uint8_t *y, const std::uint8_t *cb, const std::uint8_t *cr, std::uint8_t *dst, std::size_t width)
+        {
+            auto x = std::size_t{0};
+            for( ; x + 32 <= width; x += 32)
+            {
+                yuv_to_rgb_16<N, bgr>(y + x, cb + x, cr + x, dst + x * N);
+                yuv_to_rgb_16<N, bgr>(y + x + 16, cb + x + 16, cr + x + 16, dst + (x + 16) * N);
+            }
+            for( ; x + 16 <= width; x += 16)
+            {
+                yuv_to_rgb_16<N, bgr>(y + x, cb + x, cr + x, dst + x * N);
+            }
+
+            yuv_to_rgb_row<N, bgr>(y + x, cb + x, cr + x, dst + x * N, width - x);
+        }
+
+        //Sums of horizontal pixel pairs of both rows, rounded to the 2x2 average
+        NIMAGE_TARGET_AVX2 inline auto box_average_16(const std::uint8_t  *row_0, const std::uint8_t  *row_1) -> __m256i
+        {
+            const auto ones = _mm256_set1_epi8(1);
+            auto a = _mm256_maddubs_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(row_0)), ones);
+            auto b = _mm256_maddubs_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(row_1)), ones);
+            return _mm256_srli_epi16(_mm256_add_epi16(_mm256_add_epi16(a, b), _mm256_set1_epi16(2)), 2);
+        }
+
+        NIMAGE_TARGET_AVX2 inline auto column_sum_16(const std::uint8_t  *near, const std::uint8_t  *far) -> __m256i
+        {
+            auto n = _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(near)));
+            auto f = _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(far)));
+            return _mm256_add_epi16(_mm256_add_epi16(n, _mm256_add_epi16(n, n)), f);
+        }
+
+        NIMAGE_TARGET_AVX2 void chroma_downsample_row_impl(const std::uint8_t *row_0, const std::uint8_t *row_1, std::uint8_t *dst, std::size_t dst_width)
+        {
+            auto x = std::size_t{0};
+            for( ; x + 32 <= dst_width; x += 32)
+            {
+                auto lo = box_average_16(row_0 + 2 * x, row_1 + 2 * x);
+                auto hi = box_average_16(row_0 + 2 * x + 32, row_1 + 2 * x + 32);
+                //packus works per 128 bit lane, restore the sample order
+                auto packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(lo, hi), 0xd8);
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + x), packed);
+            }
+
+            chroma_downsample_row(row_0 + 2 * x, row_1 + 2 * x, dst + x, dst_width - x);
+        }
+
+        NIMAGE_TARGET_AVX2 void chroma_upsample_row_impl(const std::uint8_t *near, const std::uint8_t *far, std::uint8_t *dst, std::size_t src_width, std::size_t dst_width)
+        {
+            chroma_upsample_span(near, far, dst, src_width, 0, std::min<std::size_t>(2, dst_width));
+
+            const auto bias = _mm256_set1_epi16(8);
+            const auto zip  = _mm256_setr_epi8(0, 8, 1, 9, 2, 10, 3, 11, 4, 12, 5, 13, 6, 14, 7, 15,
+                                               0, 8, 1, 9, 2, 10, 3, 11, 4, 12, 5, 13, 6, 14, 7, 15);
+            auto i = std::size_t{1};
+            for( ; i + 17 <= src_width; i += 16)
+            {
+                auto c = column_sum_16(near + i, far + i);
+                auto c3 = _mm256_add_epi16(_mm256_add_epi16(c, _mm256_add_epi16(c, c)), bias);
+
+                auto even = _mm256_srli_epi16(_mm256_add_epi16(c3, column_sum_16(near + i - 1, far + i - 1)), 4);
+                auto odd  = _mm256_srli_epi16(_mm256_add_epi16(c3, column_sum_16(near + i + 1, far + i + 1)), 4);
+                //Each lane holds 8 even then 8 odd samples of consecutive pixels
+                auto packed = _mm256_shuffle_epi8(_mm256_packus_epi16(even, odd), zip);
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + 2 * i), packed);
+            }
+
+            chroma_upsample_span(near, far, dst, src_width, 2 * i, dst_width);
+        }
+
+        //In place safe, each block is loaded before it is stored
+        NIMAGE_TARGET_AVX2 void byteswap16_row_impl(const std::uint8_t *src, std::uint8_t *dst, std::size_t count)
+        {
+            const auto swap = _mm256_setr_epi8(1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14,
+                                               1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14);
+            auto i = std::size_t{0};
+            for( ; i + 16 <= count; i += 16)
+            {
+                auto v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + 2 * i));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + 2 * i), _mm256_shuffle_epi8(v, swap));
+            }
+            byteswap16_row(src + 2 * i, dst + 2 * i, count - i);
+        }
+    } // namespace
+
+    void rgb8_to_yuv_row_avx2(const std::uint8_t *src, std::uint8_t *y, std::uint8_t *cb, std::uint8_t *cr, std::size_t width)
+    {
+        rgb_to_yuv_row_impl<3>(src, y, cb, cr, width);
+    }
+
+    void rgba8_to_yuv_row_avx2(const std::uint8_t *src, std::uint8_t *y, std::uint8_t *cb, std::uint8_t *cr, std::size_t width)
+    {
+        rgb_to_yuv_row_impl<4>(src, y, cb, cr, width);
+    }
+
+    void yuv_to_rgb8_row_avx2(const std::uint8_t *y, const std::uint8_t *cb, const std::uint8_t *cr, std::uint8_t *dst, std::size_t width)
+    {
+        yuv_to_rgb_row_impl<3, false>(y, cb, cr, dst, width);
+    }
+
+    void yuv_to_bgr8_row_avx2(const std::uint8_t *y, const std::uint8_t *cb, const std::uint8_t *cr, std::uint8_t *dst, std::size_t width)
+    {
+        yuv_to_rgb_row_impl<3, true>(y, cb, cr, dst, width);
+    }
+
+    void yuv_to_rgba8_row_avx2(const std::uint8_t *y, const std::uint8_t *cb, const std::uint8_t *cr, std::uint8_t *dst, std::size_t width)
+    {
+        yuv_to_rgb_row_impl<4, false>(y, cb, cr, dst, width);
+    }
+
+    void yuv_to_bgra8_row_avx2(const std::uint8_t *y, const std::uint8_t *cb, const std::uint8_t *cr, std::uint8_t *dst, std::size_t width)
+    {
+        yuv_to_rgb_row_impl<4, true>(y, cb, cr, dst, width);
+    }
+
+    void chroma_downsample_row_avx2(const std::uint8_t *row_0, const std::uint8_t *row_1, std::uint8_t *dst, std::size_t dst_width)
+    {
+        chroma_downsample_row_impl(row_0, row_1, dst, dst_width);
+    }
+
+    void chroma_upsample_row_avx2(const std::uint8_t *near, const std::uint8_t *far, std::uint8_t *dst, std::size_t src_width, std::size_t dst_width)
+    {
+        chroma_upsample_row_impl(near, far, dst, src_width, dst_width);
+    }
+
+    void byteswap16_row_avx2(const std::uint8_t *src, std::uint8_t *dst, std::size_t count)
+    {
+        byteswap16_row_impl(src, dst, count);
+    }
+} // namespace nitros::image::kernels
+
+#endif
@@ -0,0 +1,141 @@
+#include "kernels.hpp"
+#include "kernels_x86.hpp"
+#include "conversion_internal.hpp"
+
+#if defined(NIMAGE_X86)
+
+namespace nitros::image::kernels
+{
+    namespace
+    {
+        //Same fixed point matrix as rbg_yuv, every intermediate fits the 16 bit lanes
+        NIMAGE_TARGET_AVX512 inline void rgb_to_yuv_epi16(__m512i  r, __m512i  g, __m512i  b, __m512i  &y, __m512i  &cb, __m512i  &cr)
+        {
+            const auto bias = _mm512_set1_epi16(128);
+
+            auto y_ = _mm512_add_epi16( _mm512_add_epi16(_mm512_mullo_epi16(r, _mm512_set1_epi16(77)), _mm512_mullo_epi16(g, _mm512_set1_epi16(150))),
+                                        _mm512_add_epi16(_mm512_mullo_epi16(b, _mm512_set1_epi16(29)), bias) );
+            auto u_ = _mm512_add_epi16( _mm512_add_epi16(_mm512_mullo_epi16(r, _mm512_set1_epi16(-43)), _mm512_mullo_epi16(g, _mm512_set1_epi16(-84))),
+                                        _mm512_add_epi16(_mm512_mullo_epi16(b, _mm512_set1_epi16(127)), bias) );
+            auto v_ = _mm512_add_epi16( _mm512_add_epi16(_mm512_mullo_epi16(r, _mm512_set1_epi16(127)), _mm512_mullo_epi16(g, _mm512_set1_epi16(-106))),
+                                        _mm512_add_epi16(_mm512_mullo_epi16(b, _mm512_set1_epi16(-21)), bias) );
+
+            y  = _mm512_srli_epi16(y_, 8);
+            cb = _mm512_add_epi16(_mm512_srai_epi16(u_, 8), bias);
+            cr = _mm512_add_epi16(_mm512_srai_epi16(v_, 8), bias);
+        }
+
+        template <std::size_t N>
+        NIMAGE_TARGET_AVX512 inline void load_channels(const std::uint8_t *src, __m512i  &r, __m512i  &g, __m512i  &b)
+        {
+            __m128i r0, g0, b0, r1, g1, b1;
+            x86::deinterleave<N>(src, r0, g0, b0);
+            x86::deinterleave<N>(src + 16 * N, r1, g1, b1);
+
+            r = _mm512_cvtepu8_epi16(_mm256_set_m128i(r1, r0));
+            g = _mm512_cvtepu8_epi16(_mm256_set_m128i(g1, g0));
+            b = _mm512_cvtepu8_epi16(_mm256_set_m128i(b1, b0));
+        }
+
+        template <std::size_t N>
+        NIMAGE_TARGET_AVX512 void rgb_to_yuv_row_impl(const std::uint8_t *src, std::uint8_t *y, std::uint8_t *cb, std::uint8_t *cr, std::size_t width)
+        {
+            auto x = std::size_t{0};
+            for( ; x + 32 <= width; x += 32)
+            {
+                __m512i r, g, b;
+                load_channels<N>(src + x * N, r, g, b);
+
+                __m512i y_, cb_, cr_;
+                rgb_to_yuv_epi16(r, g, b, y_, cb_, cr_);
+
+                //All lanes are already in 0..255
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(y + x),  _mm512_cvtepi16_epi8(y_));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(cb + x), _mm512_cvtepi16_epi8(cb_));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(cr + x), _mm512_cvtepi16_epi8(cr_));
+            }
+
+            //Remaining 16 pixel block and scalar tail
+            if constexpr (N == 4) {
+                rgba8_to_yuv_row_avx2(src + x * N, y + x, cb + x, cr + x, width - x);
+            }
+            else {
+                rgb8_to_yuv_row_avx2(src + x * N, y + x, cb + x, cr + x, width - x);
+            }
+        }
+
+        //Chroma is (c - 128) << 6 so _mm512_mulhrs_epi16 with a Q9 coefficient rounds like yuv_coef_mul
+        NIMAGE_TARGET_AVX512 inline void yuv_to_rgb_epi16(__m512i  y, __m512i  u, __m512i  v, __m512i  &r, __m512i  &g, __m512i  &b)
+        {
+            r = _mm512_add_epi16(y, _mm512_mulhrs_epi16(v, _mm512_set1_epi16(702)));
+            g = _mm512_sub_epi16(_mm512_sub_epi16(y, _mm512_mulhrs_epi16(v, _mm512_set1_epi16(357))), _mm512_mulhrs_epi16(u, _mm512_set1_epi16(173)));
+            b = _mm512_add_epi16(y, _mm512_mulhrs_epi16(u, _mm512_set1_epi16(887)));
+        }
+
+        NIMAGE_TARGET_AVX512 inline auto load_chroma(const std::uint8_t  *c) -> __m512i
+        {
+            auto c_ = _mm512_cvtepu8_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(c)));
+            return _mm512_slli_epi16(_mm512_sub_epi16(c_, _mm512_set1_epi16(128)), 6);
+        }
+
+        //Saturates signed 16 bit lanes to 0..255
+        NIMAGE_TARGET_AVX512 inline auto pack_epi16(__m512i  v) -> __m256i
+        {
+            return _mm512_cvtusepi16_epi8(_mm512_max_epi16(v, _mm512_setzero_si512()));
+        }
+
+        template <std::size_t N, bool bgr>
+        NIMAGE_TARGET_AVX512 void yuv_to_rgb_row_impl(const std::uint8_t *y, const std::uint8_t *cb, const std::uint8_t *cr, std::uint8_t *dst, std::size_t width)
+        {
+            auto x = std::size_t{0};
+            for( ; x + 32 <= width; x += 32)
+            {
+                __m512i r, g, b;
+                yuv_to_rgb_epi16(_mm512_cvtepu8_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(y + x))), load_chroma(cb + x), load_chroma(cr + x), r, g, b);
+
+                auto r_ = pack_epi16(r);
+                auto g_ = pack_epi16(g);
+                auto b_ = pack_epi16(b);
+                x86::interleave<N, bgr>(dst + x * N, _mm256_castsi256_si128(r_), _mm256_castsi256_si128(g_), _mm256_castsi256_si128(b_));
+                x86::interleave<N, bgr>(dst + (x + 16) * N, _mm256_extracti128_si256(r_, 1), _mm256_extracti128_si256(g_, 1), _mm256_extracti128_si256(b_, 1));
+            }
+
+            //Remaining 16 pixel block and scalar tail
+            constexpr auto tail = N == 4 ? (bgr ? yuv_to_bgra8_row_avx2 : yuv_to_rgba8_row_avx2)
+                                         : (bgr ? yuv_to_bgr8_row_avx2  : yuv_to_rgb8_row_avx2);
+            tail(y + x, cb + x, cr + x, dst + x * N, width - x);
+        }
+    } // namespace
+
+    void rgb8_to_yuv_row_avx512(const std::uint8_t *src, std::uint8_t *y, std::uint8_t *cb, std::uint8_t *cr, std::size_t width)
+    {
+        rgb_to_yuv_row_impl<3>(src, y, cb, cr, width);
+    }
+
+    void rgba8_to_yuv_row_avx512(const std::uint8_t *src, std::uint8_t *y, std::uint8_t *cb, std::uint8_t *cr, std::size_t width)
+    {
+        rgb_to_yuv_row_impl<4>(src, y, cb, cr, width);
+    }
+
+    void yuv_to_rgb8_row_avx512(const std::uint8_t *y, const std::uint8_t *cb, const std::uint8_t *cr, std::uint8_t *dst, std::size_t width)
+    {
+        yuv_to_rgb_row_impl<3, false>(y, cb, cr, dst, width);
+    }
+
+    void yuv_to_bgr8_row_avx512(const std::uint8_t *y, const std::uint8_t *cb, const std::uint8_t *cr, std::uint8_t *dst, std::size_t width)
+    {
+        yuv_to_rgb_row_impl<3, true>(y, cb, cr, dst, width);
+    }
+
+    void yuv_to_rgba8_row_avx512(const std::uint8_t *y, const std::uint8_t *cb, const std::uint8_t *cr, std::uint8_t *dst, std::size_t width)
+    {
+        yuv_to_rgb_row_impl<4, false>(y, cb, cr, dst, width);
+    }
+
+    void yuv_to_bgra8_row_avx512(const std::uint8_t *y, const std::uint8_t *cb, const std::uint8_t *cr, std::uint8_t *dst, std::size_t width)
+    {
+        yuv_to_rgb_row_impl<4, true>(y, cb, cr, dst, width);
+    }
+} // namespace nitros::image::kernels
+
+#endif
@@ -0,0 +1,196 @@
+#include "kernels.hpp"
+#include "kernels_x86.hpp"
+#include "conversion_internal.hpp"
+
+#if defined(NIMAGE_X86)
+
+namespace nitros::image::kernels
+{
+    namespace
+    {
+        //Same fixed point matrix as rbg_yuv, every intermediate fits the 16 bit lanes
+        NIMAGE_TARGET_SSE41 inline void rgb_to_yuv_epi16(__m128i  r, __m128i  g, __m128i  b, __m128i  &y, __m128i  &cb, __m128i  &cr)
+        {
+            const auto bias = _mm_set1_epi16(128);
+
+            auto y_ = _mm_add_epi16( _mm_add_epi16(_mm_mullo_epi16(r, _mm_set1_epi16(77)), _mm_mullo_epi16(g, _mm_set1_epi16(150))),
+                                     _mm_add_epi16(_mm_mullo_epi16(b, _mm_set1_epi16(29)), bias) );
+            auto u_ = _mm_add_epi16( _mm_add_epi16(_mm_mullo_epi16(r, _mm_set1_epi16(-43)), _mm_mullo_epi16(g, _mm_set1_epi16(-84))),
+                                     _mm_add_epi16(_mm_mullo_epi16(b, _mm_set1_epi16(127)), bias) );
+            auto v_ = _mm_add_epi16( _mm_add_epi16(_mm_mullo_epi16(r, _mm_set1_epi16(127)), _mm_mullo_epi16(g, _mm_set1_epi16(-106))),
+                                     _mm_add_epi16(_mm_mullo_epi16(b, _mm_set1_epi16(-21)), bias) );
+
+            y  = _mm_srli_epi16(y_, 8);
+            cb = _mm_add_epi16(_mm_srai_epi16(u_, 8), bias);
+            cr = _mm_add_epi16(_mm_srai_epi16(v_, 8), bias);
+        }
+
+        template <std::size_t N>
+        NIMAGE_TARGET_SSE41 void rgb_to_yuv_row_impl(const std::uint8_t *src, std::uint8_t *y, std::uint8_t *cb, std::uint8_t *cr, std::size_t width)
+        {
+            const auto zero = _mm_setzero_si128();
+
+            auto x = std::size_t{0};
+            for( ; x + 16 <= width; x += 16)
+            {
+                __m128i r, g, b;
+                x86::deinterleave<N>(src + x * N, r, g, b);
+
+                __m128i y_lo, cb_lo, cr_lo, y_hi, cb_hi, cr_hi;
+                rgb_to_yuv_epi16(_mm_unpacklo_epi8(r, zero), _mm_unpacklo_epi8(g, zero), _mm_unpacklo_epi8(b, zero), y_lo, cb_lo, cr_lo);
+                rgb_to_yuv_epi16(_mm_unpackhi_epi8(r, zero), _mm_unpackhi_epi8(g, zero), _mm_unpackhi_epi8(b, zero), y_hi, cb_hi, cr_hi);
+
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(y + x),  _mm_packus_epi16(y_lo, y_hi));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(cb + x), _mm_packus_epi16(cb_lo, cb_hi));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(cr + x), _mm_packus_epi16(cr_lo, cr_hi));
+            }
+
+            rgb_to_yuv_row<std::uint8_t, N>(src + x * N, y + x, cb + x, cr + x, width - x);
+        }
+
+        //Chroma is (c - 128) << 6 so _mm_mulhrs_epi16 with a Q9 coefficient rounds like yuv_coef_mul
+        NIMAGE_TARGET_SSE41 inline void yuv_to_rgb_epi16(__m128i  y, __m128i  u, __m128i  v, __m128i  &r, __m128i  &g, __m128i  &b)
+        {
+            r = _mm_add_epi16(y, _mm_mulhrs_epi16(v, _mm_set1_epi16(702)));
+            g = _mm_sub_epi16(_mm_sub_epi16(y, _mm_mulhrs_epi16(v, _mm_set1_epi16(357))), _mm_mulhrs_epi16(u, _mm_set1_epi16(173)));
+            b = _mm_add_epi16(y, _mm_mulhrs_epi16(u, _mm_set1_epi16(887)));
+        }
+
+        NIMAGE_TARGET_SSE41 inline auto center_chroma(__m128i  c) -> __m128i
+        {
+            return _mm_slli_epi16(_mm_sub_epi16(c, _mm_set1_epi16(128)), 6);
+        }
+
+        template <std::size_t N, bool bgr>
+        NIMAGE_TARGET_SSE41 void yuv_to_rgb_row_impl(const std::uint8_t *y, const std::uint8_t *cb, const std::uint8_t *cr, std::uint8_t *dst, std::size_t width)
+        {
+            const auto zero = _mm_setzero_si128();
+
+            auto x = std::size_t{0};
+            for( ; x + 16 <= width; x += 16)
+            {
+                auto y_ = _mm_loadu_si128(reinterpret_cast<const __m128i*>(y + x));
+                auto u_ = _mm_loadu_si128(reinterpret_cast<const __m128i*>(cb + x));
+                auto v_ = _mm_loadu_si128(reinterpret_cast<const __m128i*>(cr + x));
+
+                __m128i r_lo, g_lo, b_lo, r_hi, g_hi, b_hi;
+                yuv_to_rgb_epi16(_mm_unpacklo_epi8(y_, zero), center_chroma(_mm_unpacklo_epi8(u_, zero)), center_chroma(_mm_unpacklo_epi8(v_, zero)), r_lo, g_lo, b_lo);
+                yuv_to_rgb_epi16(_mm_unpackhi_epi8(y_, zero), center_chroma(_mm_unpackhi_epi8(u_, zero)), center_chroma(_mm_unpackhi_epi8(v_, zero)), r_hi, g_hi, b_hi);
+
+                x86::interleave<N, bgr>(dst + x * N, _mm_packus_epi16(r_lo, r_hi), _mm_packus_epi16(g_lo, g_hi), _mm_packus_epi16(b_lo, b_hi));
+            }
+
+            yuv_to_rgb_row<N, bgr>(y + x, cb + x, cr + x, dst + x * N, width - x);
+        }
+
+        //Sums of horizontal pixel pairs of both rows, rounded to the 2x2 average
+        NIMAGE_TARGET_SSE41 inline auto box_average_8(const std::uint8_t  *row_0, const std::uint8_t  *row_1) -> __m128i
+        {
+            const auto ones = _mm_set1_epi8(1);
+            auto a = _mm_maddubs_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(row_0)), ones);
+            auto b = _mm_maddubs_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(row_1)), ones);
+            return _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(a, b), _mm_set1_epi16(2)), 2);
+        }
+
+        //3 * near + far of 8 chroma samples
+        NIMAGE_TARGET_SSE41 inline auto column_sum_8(const std::uint8_t  *near, const std::uint8_t  *far) -> __m128i
+        {
+            auto n = _mm_cvtepu8_epi16(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(near)));
+            auto f = _mm_cvtepu8_epi16(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(far)));
+            return _mm_add_epi16(_mm_add_epi16(n, _mm_add_epi16(n, n)), f);
+        }
+
+        NIMAGE_TARGET_SSE41 void chroma_downsample_row_impl(const std::uint8_t *row_0, const std::uint8_t *row_1, std::uint8_t *dst, std::size_t dst_width)
+        {
+            auto x = std::size_t{0};
+            for( ; x + 16 <= dst_width; x += 16)
+            {
+                auto lo = box_average_8(row_0 + 2 * x, row_1 + 2 * x);
+                auto hi = box_average_8(row_0 + 2 * x + 16, row_1 + 2 * x + 16);
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x), _mm_packus_epi16(lo, hi));
+            }
+
+            chroma_downsample_row(row_0 + 2 * x, row_1 + 2 * x, dst + x, dst_width - x);
+        }
+
+        NIMAGE_TARGET_SSE41 void chroma_upsample_row_impl(const std::uint8_t *near, const std::uint8_t *far, std::uint8_t *dst, std::size_t src_width, std::size_t dst_width)
+        {
+            //The first sample has no left neighbour, the vector loop starts after it
+            chroma_upsample_span(near, far, dst, src_width, 0, std::min<std::size_t>(2, dst_width));
+
+            const auto bias = _mm_set1_epi16(8);
+            auto i = std::size_t{1};
+            for( ; i + 9 <= src_width; i += 8)
+            {
+                auto c = column_sum_8(near + i, far + i);
+                auto c3 = _mm_add_epi16(_mm_add_epi16(c, _mm_add_epi16(c, c)), bias);
+
+                auto even = _mm_srli_epi16(_mm_add_epi16(c3, column_sum_8(near + i - 1, far + i - 1)), 4);
+                auto odd  = _mm_srli_epi16(_mm_add_epi16(c3, column_sum_8(near + i + 1, far + i + 1)), 4);
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 2 * i), _mm_unpacklo_epi8(_mm_packus_epi16(even, even), _mm_packus_epi16(odd, odd)));
+            }
+
+            chroma_upsample_span(near, far, dst, src_width, 2 * i, dst_width);
+        }
+
+        //In place safe, each block is loaded before it is stored
+        NIMAGE_TARGET_SSE41 void byteswap16_row_impl(const std::uint8_t *src, std::uint8_t *dst, std::size_t count)
+        {
+            const auto swap = _mm_setr_epi8(1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14);
+            auto i = std::size_t{0};
+            for( ; i + 8 <= count; i += 8)
+            {
+                auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 2 * i));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 2 * i), _mm_shuffle_epi8(v, swap));
+            }
+            byteswap16_row(src + 2 * i, dst + 2 * i, count - i);
+        }
+    } // namespace
+
+    void rgb8_to_yuv_row_sse41(const std::uint8_t *src, std::uint8_t *y, std::uint8_t *cb, std::uint8_t *cr, std::size_t width)
+    {
+        rgb_to_yuv_row_impl<3>(src, y, cb, cr, width);
+    }
+
+    void rgba8_to_yuv_row_sse41(const std::uint8_t *src, std::uint8_t *y, std::uint8_t *cb, std::uint8_t *cr, std::size_t width)
+    {
+        rgb_to_yuv_row_impl<4>(src, y, cb, cr, width);
+    }
+
+    void yuv_to_rgb8_row_sse41(const std::uint8_t *y, const std::uint8_t *cb, const std::uint8_t *cr, std::uint8_t *dst, std::size_t width)
+    {
+        yuv_to_rgb_row_impl<3, false>(y, cb, cr, dst, width);
+    }
+
+    void yuv_to_bgr8_row_sse41(const std::uint8_t *y, const std::uint8_t *cb, const std::uint8_t *cr, std::uint8_t *dst, std::size_t width)
+    {
+        yuv_to_rgb_row_impl<3, true>(y, cb, cr, dst, width);
+    }
+
+    void yuv_to_rgba8_row_sse41(const std::uint8_t *y, const std::uint8_t *cb, const std::uint8_t *cr, std::uint8_t *dst, std::size_t width)
+    {
+        yuv_to_rgb_row_impl<4, false>(y, cb, cr, dst, width);
+    }
+
+    void yuv_to_bgra8_row_sse41(const std::uint8_t *y, const std::uint8_t *cb, const std::uint8_t *cr, std::uint8_t *dst, std::size_t width)
+    {
+        yuv_to_rgb_row_impl<4, true>(y, cb, cr, dst, width);
+    }
+
+    void chroma_downsample_row_sse41(const std::uint8_t *row_0, const std::uint8_t *row_1, std::uint8_t *dst, std::size_t dst_width)
+    {
+        chroma_downsample_row_impl(row_0, row_1, dst, dst_width);
+    }
+
+    void chroma_upsample_row_sse41(const std::uint8_t *near, const std::uint8_t *far, std::uint8_t *dst, std::size_t src_width, std::size_t dst_width)
+    {
+        chroma_upsample_row_impl(near, far, dst, src_width, dst_width);
+    }
+
+    void byteswap16_row_sse41(const std::uint8_t *src, std::uint8_t *dst, std::size_t count)
+    {
+        byteswap16_row_impl(src, dst, count);
+    }
+} // namespace nitros::image::kernels
+
+#endif
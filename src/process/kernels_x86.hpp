@@ -0,0 +1,122 @@
+
+#ifndef NITROS_IMAGE_KERNELS_X86_HPP
+#define NITROS_IMAGE_KERNELS_X86_HPP
+
+#include "simd.hpp"
+
+#if defined(NIMAGE_X86)
+#include <immintrin.h>
+#include <cstdint>
+#include <utility>
+
+//128 bit helpers shared by all x86 kernels, callers compiled for wider ISAs inline them
+namespace nitros::image::kernels::x86
+{
+    //Splits 16 RGBA8 pixels (64 bytes) into channel registers
+    NIMAGE_TARGET_SSE41 inline void deinterleave_rgba(const std::uint8_t  *src, __m128i  &r, __m128i  &g, __m128i  &b, __m128i  &a)
+    {
+        const auto mask = _mm_setr_epi8(0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, 3, 7, 11, 15);
+        auto s0 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src)), mask);
+        auto s1 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 16)), mask);
+        auto s2 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 32)), mask);
+        auto s3 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 48)), mask);
+
+        auto t0 = _mm_unpacklo_epi32(s0, s1);
+        auto t1 = _mm_unpacklo_epi32(s2, s3);
+        auto t2 = _mm_unpackhi_epi32(s0, s1);
+        auto t3 = _mm_unpackhi_epi32(s2, s3);
+
+        r = _mm_unpacklo_epi64(t0, t1);
+        g = _mm_unpackhi_epi64(t0, t1);
+        b = _mm_unpacklo_epi64(t2, t3);
+        a = _mm_unpackhi_epi64(t2, t3);
+    }
+
+    //Splits 16 RGB8 pixels (48 bytes) into channel registers
+    NIMAGE_TARGET_SSE41 inline void deinterleave_rgb(const std::uint8_t  *src, __m128i  &r, __m128i  &g, __m128i  &b)
+    {
+        auto s0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+        auto s1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 16));
+        auto s2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 32));
+
+        r = _mm_or_si128(_mm_or_si128(
+                _mm_shuffle_epi8(s0, _mm_setr_epi8( 0,  3,  6,  9, 12, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1)),
+                _mm_shuffle_epi8(s1, _mm_setr_epi8(-1, -1, -1, -1, -1, -1,  2,  5,  8, 11, 14, -1, -1, -1, -1, -1))),
+                _mm_shuffle_epi8(s2, _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,  1,  4,  7, 10, 13)));
+        g = _mm_or_si128(_mm_or_si128(
+                _mm_shuffle_epi8(s0, _mm_setr_epi8( 1,  4,  7, 10, 13, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1)),
+                _mm_shuffle_epi8(s1, _mm_setr_epi8(-1, -1, -1, -1, -1,  0,  3,  6,  9, 12, 15, -1, -1, -1, -1, -1))),
+                _mm_shuffle_epi8(s2, _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,  2,  5,  8, 11, 14)));
+        b = _mm_or_si128(_mm_or_si128(
+                _mm_shuffle_epi8(s0, _mm_setr_epi8( 2,  5,  8, 11, 14, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1)),
+                _mm_shuffle_epi8(s1, _mm_setr_epi8(-1, -1, -1, -1, -1,  1,  4,  7, 10, 13, -1, -1, -1, -1, -1, -1))),
+                _mm_shuffle_epi8(s2, _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1,  0,  3,  6,  9, 12, 15)));
+    }
+
+    template <std::size_t N>
+    NIMAGE_TARGET_SSE41 inline void deinterleave(const std::uint8_t  *src, __m128i  &r, __m128i  &g, __m128i  &b)
+    {
+        if constexpr (N == 4) {
+            auto a = __m128i{};
+            deinterleave_rgba(src, r, g, b, a);
+        }
+        else {
+            deinterleave_rgb(src, r, g, b);
+        }
+    }
+
+    //Writes 16 pixels as 4 byte pixels c0 c1 c2 c3 (64 bytes)
+    NIMAGE_TARGET_SSE41 inline void interleave_4(std::uint8_t  *dst, __m128i  c0, __m128i  c1, __m128i  c2, __m128i  c3)
+    {
+        auto c01_lo = _mm_unpacklo_epi8(c0, c1);
+        auto c01_hi = _mm_unpackhi_epi8(c0, c1);
+        auto c23_lo = _mm_unpacklo_epi8(c2, c3);
+        auto c23_hi = _mm_unpackhi_epi8(c2, c3);
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst),      _mm_unpacklo_epi16(c01_lo, c23_lo));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 16), _mm_unpackhi_epi16(c01_lo, c23_lo));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 32), _mm_unpacklo_epi16(c01_hi, c23_hi));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 48), _mm_unpackhi_epi16(c01_hi, c23_hi));
+    }
+
+    //Writes 16 pixels as 3 byte pixels c0 c1 c2 (48 bytes)
+    NIMAGE_TARGET_SSE41 inline void interleave_3(std::uint8_t  *dst, __m128i  c0, __m128i  c1, __m128i  c2)
+    {
+        auto d0 = _mm_or_si128(_mm_or_si128(
+                _mm_shuffle_epi8(c0, _mm_setr_epi8( 0, -1, -1,  1, -1, -1,  2, -1, -1,  3, -1, -1,  4, -1, -1,  5)),
+                _mm_shuffle_epi8(c1, _mm_setr_epi8(-1,  0, -1, -1,  1, -1, -1,  2, -1, -1,  3, -1, -1,  4, -1, -1))),
+                _mm_shuffle_epi8(c2, _mm_setr_epi8(-1, -1,  0, -1, -1,  1, -1, -1,  2, -1, -1,  3, -1, -1,  4, -1)));
+        auto d1 = _mm_or_si128(_mm_or_si128(
+                _mm_shuffle_epi8(c0, _mm_setr_epi8(-1, -1,  6, -1, -1,  7, -1, -1,  8, -1, -1,  9, -1, -1, 10, -1)),
+                _mm_shuffle_epi8(c1, _mm_setr_epi8( 5, -1, -1,  6, -1, -1,  7, -1, -1,  8, -1, -1,  9, -1, -1, 10))),
+                _mm_shuffle_epi8(c2, _mm_setr_epi8(-1,  5, -1, -1,  6, -1, -1,  7, -1, -1,  8, -1, -1,  9, -1, -1)));
+        auto d2 = _mm_or_si128(_mm_or_si128(
+                _mm_shuffle_epi8(c0, _mm_setr_epi8(-1, 11, -1, -1, 12, -1, -1, 13, -1, -1, 14, -1, -1, 15, -1, -1)),
+                _mm_shuffle_epi8(c1, _mm_setr_epi8(-1, -1, 11, -1, -1, 12, -1, -1, 13, -1, -1, 14, -1, -1, 15, -1))),
+                _mm_shuffle_epi8(c2, _mm_setr_epi8(10, -1, -1, 11, -1, -1, 12, -1, -1, 13, -1, -1, 14, -1, -1, 15)));
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst),      d0);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 16), d1);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 32), d2);
+    }
+
+    //Writes 16 RGB pixels in the channel order of the destination format, alpha is filled with 0xff
+    template <std::size_t N, bool bgr>
+    NIMAGE_TARGET_SSE41 inline void interleave(std::uint8_t  *dst, __m128i  r, __m128i  g, __m128i  b)
+    {
+        if constexpr (bgr) {
+            std::swap(r, b);
+        }
+
+        if constexpr (N == 4) {
+            interleave_4(dst, r, g, b, _mm_set1_epi8(-1));
+        }
+        else {
+            interleave_3(dst, r, g, b);
+        }
+    }
+} // namespace nitros::image::kernels::x86
+
+#endif
+
+#endif
@@ -0,0 +1,20 @@
+
+#ifndef NITROS_IMAGE_SIMD_HPP
+#define NITROS_IMAGE_SIMD_HPP
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+  #define NIMAGE_X86
+#endif
+
+//Kernels are compiled for their ISA per function, so no global arch flags are needed
+#if defined(__GNUC__) || defined(__clang__)
+  #define NIMAGE_TARGET(isa) __attribute__((target(isa)))
+#else
+  #define NIMAGE_TARGET(isa)
+#endif
+
+#define NIMAGE_TARGET_SSE41  NIMAGE_TARGET("sse4.1")
+#define NIMAGE_TARGET_AVX2   NIMAGE_TARGET("avx2")
+#define NIMAGE_TARGET_AVX512 NIMAGE_TARGET("avx512f,avx512bw,avx512vl,avx2")
+
+#endif
@@ -0,0 +1,136 @@
+#include "image/process/thread_pool.hpp"
+#include <algorithm>
+#include <exception>
+
+namespace nitros::image
+{
+    ThreadPool::ThreadPool(std::size_t  threads)
+        :_workers{}
+        ,_tasks{}
+        ,_mutex{}
+        ,_cv{}
+        ,_stop{false}
+    {
+        _workers.reserve(threads);
+        for(auto i = std::size_t{0}; i < threads; i++) {
+            _workers.emplace_back([this]() { worker(); });
+        }
+    }
+
+    ThreadPool::~ThreadPool()
+    {
+        {
+            auto lock = std::lock_guard{_mutex};
+            _stop = true;
+        }
+        _cv.notify_all();
+
+        for(auto &thread : _workers) {
+            thread.join();
+        }
+    }
+
+    auto ThreadPool::size() const noexcept -> std::size_t
+    {
+        return _workers.size();
+    }
+
+    void ThreadPool::enqueue(std::function<void()>  &&task)
+    {
+        if(_workers.empty()) {
+            task();
+            return;
+        }
+
+        {
+            auto lock = std::lock_guard{_mutex};
+            _tasks.push_back(std::move(task));
+        }
+        _cv.notify_one();
+    }
+
+    auto ThreadPool::run_pending() -> bool
+    {
+        auto task = std::function<void()>{};
+        {
+            auto lock = std::lock_guard{_mutex};
+            if(_tasks.empty()) {
+                return false;
+            }
+            task = std::move(_tasks.front());
+            _tasks.pop_front();
+        }
+
+        task();
+        return true;
+    }
+
+    void ThreadPool::worker()
+    {
+        while(true)
+        {
+            auto task = std::function<void()>{};
+            {
+                auto lock = std::unique_lock{_mutex};
+                _cv.wait(lock, [this]() { return _stop || !_tasks.empty(); });
+                if(_tasks.empty()) {
+                    return;
+                }
+                task = std::move(_tasks.front());
+                _tasks.pop_front();
+            }
+
+            task();
+        }
+    }
+
+    void ThreadPool::parallel_for(std::size_t  begin, std::size_t  end, std::size_t  alignment, const BandFn  &fn)
+    {
+        if(begin >= end) {
+            return;
+        }
+
+        alignment = std::max<std::size_t>(alignment, 1);
+        auto units = (end - begin + alignment - 1) / alignment;
+        auto bands = std::min(units, _workers.size() + 1);
+        auto band_size = (units + bands - 1) / bands * alignment;
+
+        auto futures = std::vector<std::future<void>>{};
+        futures.reserve(bands);
+        for(auto first = begin + band_size; first < end; first += band_size) {
+            auto last = std::min(first + band_size, end);
+            futures.push_back( submit([&fn, first, last]() { fn(first, last); }) );
+        }
+
+        auto error = std::exception_ptr{};
+        try {
+            fn(begin, std::min(begin + band_size, end));
+        }
+        catch(...) {
+            error = std::current_exception();
+        }
+
+        //Help with queued work while waiting, so nested calls from inside a worker cannot starve the pool
+        for(auto &future : futures)
+        {
+            while(future.wait_for(std::chrono::seconds{0}) != std::future_status::ready) {
+                if(!run_pending()) {
+                    future.wait();
+                }
+            }
+
+            try {
+                future.get();
+            }
+            catch(...) {
+                if(!error) {
+                    error = std::current_exception();
+                }
+            }
+        }
+
+        if(error) {
+            std::rethrow_exception(error);
+        }
+    }
+} // namespace nitros::image
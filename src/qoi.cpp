@@ -0,0 +1,325 @@
+#include "image/fileio.hpp"
+#include "image/mapped_buffer.hpp"
+#include "image/utils.hpp"
+#include "codec_internal.hpp"
+#include <gsl/gsl>
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+namespace nitros::utils::image
+{
+    namespace
+    {
+        //https://qoiformat.org/qoi-specification.pdf
+        using detail::qoi_header_bytes;
+        using detail::QoiHeader;
+        using detail::QoiPixel;
+
+        constexpr auto qoi_max_pixels   = std::size_t{400000000};
+        constexpr auto qoi_padding      = std::array<std::uint8_t, 8>{0, 0, 0, 0, 0, 0, 0, 1};
+
+        constexpr auto op_index = std::uint8_t{0x00};
+        constexpr auto op_diff  = std::uint8_t{0x40};
+        constexpr auto op_luma  = std::uint8_t{0x80};
+        constexpr auto op_run   = std::uint8_t{0xc0};
+        constexpr auto op_rgb   = std::uint8_t{0xfe};
+        constexpr auto op_rgba  = std::uint8_t{0xff};
+        constexpr auto op_mask  = std::uint8_t{0xc0};
+
+        inline auto operator==(const QoiPixel  &lhs, const QoiPixel  &rhs) noexcept -> bool
+        {
+            return lhs.r == rhs.r && lhs.g == rhs.g && lhs.b == rhs.b && lhs.a == rhs.a;
+        }
+
+        inline auto qoi_hash(const QoiPixel  &px) noexcept -> std::size_t
+        {
+            return (px.r * 3 + px.g * 5 + px.b * 7 + px.a * 11) % 64;
+        }
+
+        //QOI stores RGB or RGBA bytes, the image rows are read and written in place through their steps
+        auto qoi_channels(const pixel::Format  &format) -> std::uint8_t
+        {
+            if(format == pixel::RGB8::value) {
+                return 3;
+            }
+            if(format == pixel::RGBA8::value) {
+                return 4;
+            }
+            throw std::invalid_argument("QOI images are RGB8 or RGBA8");
+        }
+
+        void write_u32(std::uint8_t  *out, std::uint32_t  value) noexcept
+        {
+            out[0] = static_cast<std::uint8_t>(value >> 24);
+            out[1] = static_cast<std::uint8_t>(value >> 16);
+            out[2] = static_cast<std::uint8_t>(value >> 8);
+            out[3] = static_cast<std::uint8_t>(value);
+        }
+
+        auto read_u32(const std::uint8_t  *in) noexcept -> std::uint32_t
+        {
+            return std::uint32_t{in[0]} << 24 | std::uint32_t{in[1]} << 16 | std::uint32_t{in[2]} << 8 | std::uint32_t{in[3]};
+        }
+
+        auto read_header(gsl::span<const std::uint8_t>  data) -> QoiHeader
+        {
+            if(gsl::narrow_cast<std::size_t>(data.size_bytes()) < qoi_header_bytes + qoi_padding.size()) {
+                throw std::runtime_error("Not a QOI image");
+            }
+            return detail::parse_qoi_header(data.data());
+        }
+
+        /**
+         * Encodes one row per call into a row sized chunk, so the sink sees the file grow row by row.
+         * Runs continue across rows like the reference encoder
+         * */
+        class QoiEncoder
+        {
+            public:
+            QoiEncoder(ImgSize  size, std::uint8_t  channels)
+                :_channels{channels}
+                ,_pixels_left{size.width * size.height}
+                ,_chunk(size.width * (channels + 1) + qoi_header_bytes)
+            {}
+
+            auto header(ImgSize  size) -> gsl::span<const std::uint8_t>
+            {
+                std::memcpy(_chunk.data(), "qoif", 4);
+                write_u32(_chunk.data() + 4, gsl::narrow<std::uint32_t>(size.width));
+                write_u32(_chunk.data() + 8, gsl::narrow<std::uint32_t>(size.height));
+                _chunk[12] = _channels;
+                _chunk[13] = 0;     //sRGB with linear alpha
+                return {_chunk.data(), qoi_header_bytes};
+            }
+
+            auto row(const std::uint8_t  *row, std::size_t  width) -> gsl::span<const std::uint8_t>
+            {
+                auto *out = _chunk.data();
+                for(auto x = std::size_t{0}; x < width; x++, row += _channels)
+                {
+                    auto px = QoiPixel{row[0], row[1], row[2], _channels == 4 ? row[3] : _prev.a};
+                    _pixels_left--;
+
+                    if(px == _prev) {
+                        _run++;
+                        if(_run == 62 || _pixels_left == 0) {
+                            *out++ = static_cast<std::uint8_t>(op_run | (_run - 1));
+                            _run = 0;
+                        }
+                        continue;
+                    }
+
+                    if(_run > 0) {
+                        *out++ = static_cast<std::uint8_t>(op_run | (_run - 1));
+                        _run = 0;
+                    }
+
+                    auto hash = qoi_hash(px);
+                    if(_index[hash] == px) {
+                        *out++ = static_cast<std::uint8_t>(op_index | hash);
+                    }
+                    else if(px.a == _prev.a)
+                    {
+                        _index[hash] = px;
+                        auto vr = static_cast<std::int8_t>(px.r - _prev.r);
+                        auto vg = static_cast<std::int8_t>(px.g - _prev.g);
+                        auto vb = static_cast<std::int8_t>(px.b - _prev.b);
+                        auto vg_r = vr - vg;
+                        auto vg_b = vb - vg;
+
+                        if(vr > -3 && vr < 2 && vg > -3 && vg < 2 && vb > -3 && vb < 2) {
+                            *out++ = static_cast<std::uint8_t>(op_diff | (vr + 2) << 4 | (vg + 2) << 2 | (vb + 2));
+                        }
+                        else if(vg_r > -9 && vg_r < 8 && vg > -33 && vg < 32 && vg_b > -9 && vg_b < 8) {
+                            *out++ = static_cast<std::uint8_t>(op_luma | (vg + 32));
+                            *out++ = static_cast<std::uint8_t>((vg_r + 8) << 4 | (vg_b + 8));
+                        }
+                        else {
+                            *out++ = op_rgb;
+                            *out++ = px.r;
+                            *out++ = px.g;
+                            *out++ = px.b;
+                        }
+                    }
+                    else
+                    {
+                        _index[hash] = px;
+                        *out++ = op_rgba;
+                        *out++ = px.r;
+                        *out++ = px.g;
+                        *out++ = px.b;
+                        *out++ = px.a;
+                    }
+                    _prev = px;
+                }
+                return {_chunk.data(), gsl::narrow_cast<std::size_t>(out - _chunk.data())};
+            }
+
+            private:
+            std::uint8_t  _channels;
+            std::size_t   _pixels_left;
+            std::size_t   _run = 0;
+            QoiPixel      _prev{0, 0, 0, 255};
+            std::array<QoiPixel, 64>  _index{};
+            std::vector<std::uint8_t> _chunk;
+        };
+
+        void decode_rows(gsl::span<const std::uint8_t>  data, const QoiHeader  &header, const ImageView  &target)
+        {
+            auto decoder = detail::QoiDecoder{qoi_channels(target.meta_data().format)};
+            const auto *in  = data.data() + qoi_header_bytes;
+            const auto *end = data.data() + data.size() - qoi_padding.size();
+
+            for(auto y = std::size_t{0}; y < header.size.height; y++)
+            {
+                if(decoder.decode(in, end, target.row(y), header.size.width) != header.size.width) {
+                    throw std::runtime_error("QOI data is truncated");
+                }
+            }
+        }
+    } // namespace
+
+    namespace detail
+    {
+        auto parse_qoi_header(const std::uint8_t  *data) -> QoiHeader
+        {
+            if(std::memcmp(data, "qoif", 4) != 0) {
+                throw std::runtime_error("Not a QOI image");
+            }
+            auto header = QoiHeader{{read_u32(data + 4), read_u32(data + 8)}, data[12]};
+            if(header.channels != 3 && header.channels != 4) {
+                throw std::runtime_error("QOI header has an invalid channel count");
+            }
+            if(header.size.width == 0 || header.size.height == 0 || header.size.width * header.size.height > qoi_max_pixels) {
+                throw std::runtime_error("QOI header has an invalid size");
+            }
+            return header;
+        }
+
+        auto QoiDecoder::decode(const std::uint8_t  *&in, const std::uint8_t  *end, std::uint8_t  *out, std::size_t  count) noexcept -> std::size_t
+        {
+            auto written = std::size_t{0};
+            for(; written < count; written++, out += _channels)
+            {
+                if(_run > 0) {
+                    _run--;
+                }
+                else
+                {
+                    if(in >= end) {
+                        break;
+                    }
+                    auto op = in[0];
+                    auto op_bytes = op == op_rgba ? 5 : op == op_rgb ? 4 : (op & op_mask) == op_luma ? 2 : 1;
+                    if(end - in < op_bytes) {
+                        break;
+                    }
+
+                    if(op == op_rgb) {
+                        _prev.r = in[1]; _prev.g = in[2]; _prev.b = in[3];
+                    }
+                    else if(op == op_rgba) {
+                        _prev = QoiPixel{in[1], in[2], in[3], in[4]};
+                    }
+                    else if((op & op_mask) == op_index) {
+                        _prev = _index[op];
+                    }
+                    else if((op & op_mask) == op_diff) {
+                        _prev.r = static_cast<std::uint8_t>(_prev.r + ((op >> 4) & 0x03) - 2);
+                        _prev.g = static_cast<std::uint8_t>(_prev.g + ((op >> 2) & 0x03) - 2);
+                        _prev.b = static_cast<std::uint8_t>(_prev.b + ( op       & 0x03) - 2);
+                    }
+                    else if((op & op_mask) == op_luma) {
+                        auto vg = (op & 0x3f) - 32;
+                        _prev.r = static_cast<std::uint8_t>(_prev.r + vg - 8 + ((in[1] >> 4) & 0x0f));
+                        _prev.g = static_cast<std::uint8_t>(_prev.g + vg);
+                        _prev.b = static_cast<std::uint8_t>(_prev.b + vg - 8 + (in[1] & 0x0f));
+                    }
+                    else {
+                        _run = op & 0x3f;
+                    }
+                    _index[qoi_hash(_prev)] = _prev;
+                    in += op_bytes;
+                }
+
+                out[0] = _prev.r;
+                out[1] = _prev.g;
+                out[2] = _prev.b;
+                if(_channels == 4) {
+                    out[3] = _prev.a;
+                }
+            }
+            return written;
+        }
+    } // namespace detail
+
+    void encode_qoi(const ConstImageView& source_image, const EncodeSink& sink)
+    {
+        auto channels = qoi_channels(source_image.meta_data().format);
+        auto size = source_image.size();
+        if(size.width == 0 || size.height == 0 || size.width * size.height > qoi_max_pixels) {
+            throw std::invalid_argument("QOI images have 1 to 400 million pixels");
+        }
+
+        auto encoder = QoiEncoder(size, channels);
+        auto header = encoder.header(size);
+        sink(header.data(), header.size());
+        for(auto y = std::size_t{0}; y < size.height; y++) {
+            auto chunk = encoder.row(source_image.row(y), size.width);
+            sink(chunk.data(), chunk.size());
+        }
+        sink(qoi_padding.data(), qoi_padding.size());
+    }
+
+    auto encode_qoi(const ConstImageView& source_image) -> std::vector<std::uint8_t>
+    {
+        auto encoded = std::vector<std::uint8_t>{};
+        //Photographic content typically lands around a third of the raw size
+        encoded.reserve(plane_row_bytes(source_image.meta_data(), 0) * source_image.size().height / 3);
+        encode_qoi(source_image, [&encoded](const std::uint8_t  *data, std::size_t  size) {
+            encoded.insert(encoded.end(), data, data + size);
+        });
+        return encoded;
+    }
+
+    void write_image_qoi(const std::string& full_target_path, const ConstImageView& source_image)
+    {
+        auto file = std::ofstream(full_target_path, std::ios::binary);
+        if(!file) {
+            throw std::runtime_error("Cannot open " + full_target_path);
+        }
+        encode_qoi(source_image, [&file](const std::uint8_t  *data, std::size_t  size) {
+            file.write(reinterpret_cast<const char*>(data), gsl::narrow_cast<std::streamsize>(size));
+        });
+        file.flush();
+        if(!file) {
+            throw std::runtime_error("Cannot write " + full_target_path);
+        }
+    }
+
+    auto decode_qoi(const gsl::span<const std::uint8_t>& data) -> ImageCpu
+    {
+        auto header = read_header(data);
+        auto image = create_cpu(header.size, header.channels == 4 ? pixel::RGBA8::value : pixel::RGB8::value);
+        decode_rows(data, header, view(image));
+        return image;
+    }
+
+    void decode_qoi(const gsl::span<const std::uint8_t>& data, const ImageView& target_image)
+    {
+        auto header = read_header(data);
+        if(header.size != target_image.size()) {
+            throw std::invalid_argument("Decoded image size does not match the target image");
+        }
+        decode_rows(data, header, target_image);
+    }
+
+    auto read_image_qoi(const std::string& full_source_path) -> ImageCpu
+    {
+        //Decoded straight from the page cache, the file is never copied into memory
+        auto file = MappedBuffer(full_source_path, MapMode::read_only);
+        return decode_qoi({file.data(), file.size()});
+    }
+}
@@ -0,0 +1,310 @@
+#include "image/fileio.hpp"
+#include "image/mapped_buffer.hpp"
+#include "image/utils.hpp"
+#include "codec_internal.hpp"
+#include <gsl/gsl>
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+namespace nitros::utils::image
+{
+    namespace
+    {
+        /**
+         * Layout of the raw container, integers little endian:
+         *  magic "NIMGRAW\0", u32 version, u32 data offset, u64 width, u64 height, u64 data bytes,
+         *  Format: u32 type, u32 layout bytes, channels, group pixels, normalized, u32 is planar,
+         *          u32 bit count, 5 x u32 pixel bits, u32 plane count, 5 x 6 x u32 plane factors, alignment and channels
+         *  u32 step count, 5 x u64 steps
+         * Planes follow at the data offset laid out like the buffer of create_cpu, so the
+         * file maps as an image without touching the pixels
+         * */
+        constexpr auto raw_magic       = std::array<char, 8>{'N', 'I', 'M', 'G', 'R', 'A', 'W', '\0'};
+        constexpr auto raw_version     = std::uint32_t{1};
+        using detail::raw_header_size;
+        using detail::raw_data_offset;
+        constexpr auto raw_max_entries = std::size_t{5};
+        //Keeps row and plane byte counts far from overflowing whatever the format
+        constexpr auto raw_max_side    = std::size_t{1} << 31;
+
+        /**
+         * Formats a header may name. Layout and planes of a format are what row and plane sizes are computed from,
+         * so a header is only trusted with one of the predefined formats, not with a layout of its own
+         * */
+        const auto raw_formats = std::array<pixel::Format, 38>{
+            pixel::R8::value, pixel::R16::value, pixel::R32f::value, pixel::R64f::value,
+            pixel::RG8::value, pixel::RG16::value, pixel::RG32f::value, pixel::RG64f::value,
+            pixel::RGB8::value, pixel::RGBA8::value, pixel::BGR8::value, pixel::BGRA8::value,
+            pixel::RGB16::value, pixel::RGBA16::value, pixel::BGR16::value, pixel::BGRA16::value,
+            pixel::RGB32f::value, pixel::RGBA32f::value, pixel::BGR32f::value, pixel::BGRA32f::value,
+            pixel::RGB64f::value, pixel::RGBA64f::value, pixel::BGR64f::value, pixel::BGRA64f::value,
+            pixel::GREY8::value, pixel::GREY16::value, pixel::GREY32f::value, pixel::GREY64f::value,
+            pixel::STENCIL8::value,
+            pixel::GREY_STENCIL_16_8::value, pixel::GREY_STENCIL_24_8::value, pixel::GREY_STENCIL_32f_8::value,
+            pixel::YUV420p::value, pixel::YUVA420p::value, pixel::YUV422p::value, pixel::YUVA422p::value,
+            pixel::YUV444p::value, pixel::YUVA444p::value
+        };
+
+        class HeaderWriter
+        {
+            public:
+            explicit HeaderWriter(std::uint8_t  *out) noexcept : _out{out} {}
+
+            void bytes(const void  *data, std::size_t  size) noexcept
+            {
+                std::memcpy(_out, data, size);
+                _out += size;
+            }
+
+            void u32(std::uint32_t  value) noexcept
+            {
+                for(auto i = 0; i < 4; i++) {
+                    *_out++ = static_cast<std::uint8_t>(value >> (8 * i));
+                }
+            }
+
+            void u64(std::uint64_t  value) noexcept
+            {
+                u32(static_cast<std::uint32_t>(value));
+                u32(static_cast<std::uint32_t>(value >> 32));
+            }
+
+            private:
+            std::uint8_t  *_out;
+        };
+
+        class HeaderReader
+        {
+            public:
+            explicit HeaderReader(const std::uint8_t  *in) noexcept : _in{in} {}
+
+            auto bytes(std::size_t  size) noexcept -> const std::uint8_t*
+            {
+                auto start = _in;
+                _in += size;
+                return start;
+            }
+
+            auto u32() noexcept -> std::uint32_t
+            {
+                auto value = std::uint32_t{0};
+                for(auto i = 0; i < 4; i++) {
+                    value |= std::uint32_t{*_in++} << (8 * i);
+                }
+                return value;
+            }
+
+            auto u64() noexcept -> std::uint64_t
+            {
+                auto low = std::uint64_t{u32()};
+                return low | std::uint64_t{u32()} << 32;
+            }
+
+            //Entry counts and enums come from the file, out of range values mean a damaged header
+            auto bounded(std::uint32_t  max) -> std::uint32_t
+            {
+                auto value = u32();
+                if(value > max) {
+                    throw std::runtime_error("Damaged raw image header");
+                }
+                return value;
+            }
+
+            private:
+            const std::uint8_t  *_in;
+        };
+
+        auto read_header(const std::uint8_t  *in, std::size_t  file_size) -> detail::RawHeader
+        {
+            if(file_size < raw_header_size) {
+                throw std::runtime_error("Not a raw image");
+            }
+            auto header = detail::read_raw_header(in);
+            if(header.data_bytes != buffer_size(header.meta_data) || header.data_offset < raw_header_size
+               || file_size < header.data_offset || file_size - header.data_offset < header.data_bytes) {
+                throw std::runtime_error("Damaged or truncated raw image");
+            }
+            return header;
+        }
+
+        auto load_header(const std::string  &full_source_path) -> detail::RawHeader
+        {
+            auto file = std::ifstream(full_source_path, std::ios::binary | std::ios::ate);
+            if(!file) {
+                throw std::runtime_error("Cannot open " + full_source_path);
+            }
+            auto file_size = gsl::narrow_cast<std::size_t>(file.tellg());
+            auto header = std::array<std::uint8_t, raw_header_size>{};
+            file.seekg(0);
+            file.read(reinterpret_cast<char*>(header.data()), std::min(file_size, header.size()));
+            return read_header(header.data(), file_size);
+        }
+    } // namespace
+
+    namespace detail
+    {
+        void write_raw_header(std::uint8_t  *out, const ImageMetaData  &meta_data)
+        {
+            auto header = HeaderWriter{out};
+            auto &format = meta_data.format;
+
+            header.bytes(raw_magic.data(), raw_magic.size());
+            header.u32(raw_version);
+            header.u32(gsl::narrow<std::uint32_t>(raw_data_offset));
+            header.u64(meta_data.size.width);
+            header.u64(meta_data.size.height);
+            header.u64(buffer_size(meta_data));
+
+            header.u32(static_cast<std::uint32_t>(format.pixel_type));
+            header.u32(format.pixel_layout.bytes);
+            header.u32(format.pixel_layout.channels);
+            header.u32(format.pixel_layout.group_pixels);
+            header.u32(format.pixel_layout.normalized);
+            header.u32(format.planar_info.is_planar);
+
+            header.u32(gsl::narrow_cast<std::uint32_t>(format.planar_info.pixel_bits.size()));
+            for(auto i = std::size_t{0}; i < raw_max_entries; i++) {
+                header.u32(i < format.planar_info.pixel_bits.size() ? format.planar_info.pixel_bits[i] : 0);
+            }
+
+            header.u32(gsl::narrow_cast<std::uint32_t>(format.planes.size()));
+            for(auto i = std::size_t{0}; i < raw_max_entries; i++)
+            {
+                auto plane = i < format.planes.size() ? format.planes[i] : pixel::Plane{};
+                header.u32(plane.width_factor.num);
+                header.u32(plane.width_factor.den);
+                header.u32(plane.height_factor.num);
+                header.u32(plane.height_factor.den);
+                header.u32(plane.row_alignment);
+                header.u32(plane.channels);
+            }
+
+            header.u32(gsl::narrow_cast<std::uint32_t>(meta_data.steps.size()));
+            for(auto i = std::size_t{0}; i < raw_max_entries; i++) {
+                header.u64(i < meta_data.steps.size() ? meta_data.steps[i] : 0);
+            }
+        }
+
+        auto read_raw_header(const std::uint8_t  *in) -> RawHeader
+        {
+            if(std::memcmp(in, raw_magic.data(), raw_magic.size()) != 0) {
+                throw std::runtime_error("Not a raw image");
+            }
+
+            auto header = HeaderReader{in + raw_magic.size()};
+            if(header.u32() != raw_version) {
+                throw std::runtime_error("Unsupported raw image version");
+            }
+            auto data_offset = std::size_t{header.u32()};
+            auto size = ImgSize{gsl::narrow<std::size_t>(header.u64()), gsl::narrow<std::size_t>(header.u64())};
+            auto data_bytes = gsl::narrow<std::size_t>(header.u64());
+            if(size.width > raw_max_side || size.height > raw_max_side) {
+                throw std::runtime_error("Damaged raw image header");
+            }
+
+            auto type = static_cast<pixel::type>(header.bounded(static_cast<std::uint32_t>(pixel::type::yuva)));
+            auto bytes = header.u32();
+            auto channels = header.u32();
+            auto group_pixels = header.u32();
+            auto layout = pixel::Layout{bytes, channels, group_pixels, header.u32() != 0};
+            auto is_planar = header.u32() != 0;
+
+            auto bits = pixel::Array<std::uint8_t>{};
+            auto bit_count = header.bounded(raw_max_entries);
+            for(auto i = std::size_t{0}; i < raw_max_entries; i++) {
+                auto value = static_cast<std::uint8_t>(header.u32());
+                if(i < bit_count) {
+                    bits.push_back(value);
+                }
+            }
+
+            auto planes = pixel::Array<pixel::Plane>{};
+            auto plane_count = header.bounded(raw_max_entries);
+            for(auto i = std::size_t{0}; i < raw_max_entries; i++)
+            {
+                auto plane = pixel::Plane{};
+                plane.width_factor  = {header.u32(), header.u32()};
+                plane.height_factor = {header.u32(), header.u32()};
+                plane.row_alignment = header.u32();
+                plane.channels      = header.u32();
+                if(i < plane_count) {
+                    if(plane.width_factor.den == 0 || plane.height_factor.den == 0) {
+                        throw std::runtime_error("Damaged raw image header");
+                    }
+                    planes.push_back(plane);
+                }
+            }
+
+            auto format = pixel::Format{type, layout, pixel::Planar{bits, is_planar}, planes};
+            if(std::find(raw_formats.begin(), raw_formats.end(), format) == raw_formats.end()) {
+                throw std::runtime_error("Damaged raw image header or unsupported format");
+            }
+
+            auto meta_data = ImageMetaData{size, format};
+            auto step_count = header.bounded(raw_max_entries);
+            if(step_count != meta_data.steps.size()) {
+                throw std::runtime_error("Damaged raw image header");
+            }
+            //Steps of the writer are kept, they may differ from the ones this build computes.
+            //A step must hold its row and all rows of its plane must fit in the data
+            for(auto i = std::size_t{0}; i < raw_max_entries; i++)
+            {
+                auto step = gsl::narrow<std::size_t>(header.u64());
+                if(i >= step_count) {
+                    continue;
+                }
+                auto rows = interpreted_plane_img_size(meta_data, i).height;
+                if(step < plane_row_bytes(meta_data, i) || (rows != 0 && step > data_bytes / rows)) {
+                    throw std::runtime_error("Damaged raw image header");
+                }
+                meta_data.steps[i] = step;
+            }
+
+            return RawHeader{std::move(meta_data), data_offset, data_bytes};
+        }
+
+    } // namespace detail
+
+    void write_image_raw(const std::string& full_target_path, const ConstImageView& source_image)
+    {
+        //Written through a mapping, the planes are copied once from the view into the page cache
+        auto meta_data = ImageMetaData{source_image.size(), source_image.meta_data().format};
+        auto file = MappedBuffer::create(full_target_path, raw_data_offset + buffer_size(meta_data));
+        detail::write_raw_header(file.data(), meta_data);
+
+        auto *planes = file.data() + raw_data_offset;
+        for(auto i = std::size_t{0}; i < meta_data.steps.size(); i++)
+        {
+            auto row_bytes = plane_row_bytes(meta_data, i);
+            auto rows = interpreted_plane_img_size(meta_data, i).height;
+            auto *plane = planes + plane_offset(meta_data, i);
+            for(auto y = std::size_t{0}; y < rows; y++) {
+                std::memcpy(plane + y * meta_data.steps[i], source_image.row(y, i), row_bytes);
+            }
+        }
+        file.flush();
+    }
+
+    auto open_image_raw(const std::string& full_source_path, MapMode mode) -> ImageMapped
+    {
+        auto header = load_header(full_source_path);
+        return open_mapped(full_source_path, header.meta_data, mode, header.data_offset);
+    }
+
+    auto read_image_raw(const std::string& full_source_path) -> ImageCpu
+    {
+        auto header = load_header(full_source_path);
+        auto buffer = ImgBufferCpu(buffer_size(header.meta_data));
+
+        auto file = std::ifstream(full_source_path, std::ios::binary);
+        file.seekg(gsl::narrow<std::streamoff>(header.data_offset));
+        file.read(reinterpret_cast<char*>(buffer.data()), gsl::narrow<std::streamsize>(buffer.size()));
+        if(!file) {
+            throw std::runtime_error("Cannot read " + full_source_path);
+        }
+        return ImageCpu{std::move(header.meta_data), std::move(buffer)};
+    }
+}
@@ -0,0 +1,272 @@
+#include "image/stream_decoder.hpp"
+#include "image/utils.hpp"
+#include "codec_internal.hpp"
+#include <gsl/gsl>
+#include <algorithm>
+#include <cstring>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace nitros::utils::image
+{
+    namespace
+    {
+        enum class Codec {
+            unknown,    //Too few bytes to tell
+            qoi,
+            pnm,
+            collected   //Decoded by decode_image at the end
+        };
+
+        auto sniff_codec(const std::vector<std::uint8_t>  &head) -> Codec
+        {
+            if(head.size() >= 2 && head[0] == 'P' && (head[1] == '5' || head[1] == '6' || head[1] == '7')) {
+                return Codec::pnm;
+            }
+            if(head.size() < 4) {
+                return Codec::unknown;
+            }
+            return std::memcmp(head.data(), "qoif", 4) == 0 ? Codec::qoi : Codec::collected;
+        }
+
+        void check_options(const DecodeOptions  &options, const ImageMetaData  &meta_data)
+        {
+            if(options.scale_denominator != 1 || options.max_dimension != 0) {
+                throw std::invalid_argument("Streamed QOI and Netpbm images are decoded at full resolution");
+            }
+            if(options.max_pixels != 0 && meta_data.size.width * meta_data.size.height > options.max_pixels) {
+                throw std::length_error("Image exceeds the decode pixel limit");
+            }
+            if(options.max_bytes != 0 && buffer_size(meta_data) > options.max_bytes) {
+                throw std::length_error("Image exceeds the decode byte limit");
+            }
+        }
+    } // namespace
+
+    struct StreamDecoder::State
+    {
+        //Runs the bytes through the codec of the stream, pending holds what could not be used yet
+        void feed(const std::uint8_t  *data, std::size_t  size)
+        {
+            switch(codec) {
+                case Codec::unknown:
+                    pending.insert(pending.end(), data, data + size);
+                    codec = sniff_codec(pending);
+                    if(codec == Codec::qoi || codec == Codec::pnm) {
+                        auto head = std::exchange(pending, {});
+                        feed(head.data(), head.size());
+                    }
+                    break;
+                case Codec::qoi:        feed_qoi(data, size); break;
+                case Codec::pnm:        feed_pnm(data, size); break;
+                case Codec::collected:  pending.insert(pending.end(), data, data + size); break;
+            }
+        }
+
+        void start_image(ImgSize  size, const pixel::Format  &format)
+        {
+            auto meta_data = ImageMetaData{size, format};
+            check_options(options, meta_data);
+            image.emplace(create_cpu(size, format));
+        }
+
+        void feed_qoi(const std::uint8_t  *data, std::size_t  size)
+        {
+            if(!image)
+            {
+                auto used = std::min(size, detail::qoi_header_bytes - pending.size());
+                pending.insert(pending.end(), data, data + used);
+                if(pending.size() < detail::qoi_header_bytes) {
+                    return;
+                }
+                auto header = detail::parse_qoi_header(pending.data());
+                auto native = header.channels == 4 ? pixel::RGBA8::value : pixel::RGB8::value;
+                auto format = options.format.value_or(native);
+                if(!(format == pixel::RGB8::value) && !(format == pixel::RGBA8::value)) {
+                    throw std::invalid_argument("Streamed QOI images decode to RGB8 or RGBA8");
+                }
+                start_image(header.size, format);
+                qoi.emplace(gsl::narrow_cast<std::uint8_t>(format.pixel_layout.channels));
+                pending.clear();
+                data += used;
+                size -= used;
+            }
+
+            //An op cut by the end of the last chunk is completed from the front of this one
+            if(!pending.empty())
+            {
+                auto held = pending.size();
+                auto used = std::min(size, 5 - held);
+                pending.insert(pending.end(), data, data + used);
+                const auto *in = pending.data();
+                decode_qoi_rows(in, pending.data() + pending.size());
+                auto consumed = gsl::narrow_cast<std::size_t>(in - pending.data());
+                if(consumed < held) {
+                    return;     //Still not a whole op, everything new is in pending
+                }
+                pending.clear();
+                data += consumed - held;
+                size -= consumed - held;
+            }
+
+            const auto *in = data;
+            decode_qoi_rows(in, data + size);
+            if(rows_ready < image->meta_data().size.height) {
+                pending.assign(in, data + size);
+            }
+        }
+
+        void decode_qoi_rows(const std::uint8_t  *&in, const std::uint8_t  *end)
+        {
+            auto size = image->meta_data().size;
+            auto channels = image->meta_data().format.pixel_layout.channels;
+            auto target = view(*image);
+            while(rows_ready < size.height)
+            {
+                column += qoi->decode(in, end, target.row(rows_ready) + column * channels, size.width - column);
+                if(column < size.width) {
+                    return;
+                }
+                column = 0;
+                rows_ready++;
+            }
+        }
+
+        void feed_pnm(const std::uint8_t  *data, std::size_t  size)
+        {
+            if(!image)
+            {
+                pending.insert(pending.end(), data, data + size);
+                pnm = detail::parse_pnm_header(pending);
+                if(!pnm) {
+                    return;
+                }
+                if(options.format && !(*options.format == pnm->format)) {
+                    throw std::invalid_argument("Streamed Netpbm images decode to the format of the file");
+                }
+                start_image(pnm->size, pnm->format);
+
+                auto samples = std::vector<std::uint8_t>(pending.begin() + gsl::narrow_cast<std::ptrdiff_t>(pnm->data_offset), pending.end());
+                pending.clear();
+                feed_pnm_rows(samples.data(), samples.size());
+                return;
+            }
+            feed_pnm_rows(data, size);
+        }
+
+        //Whole rows are copied straight from the chunk, only a row cut by its end goes through pending
+        void feed_pnm_rows(const std::uint8_t  *data, std::size_t  size)
+        {
+            auto height = image->meta_data().size.height;
+            auto row_bytes = plane_row_bytes(image->meta_data(), 0);
+            if(!pending.empty() && rows_ready < height)
+            {
+                auto used = std::min(size, row_bytes - pending.size());
+                pending.insert(pending.end(), data, data + used);
+                data += used;
+                size -= used;
+                if(pending.size() < row_bytes) {
+                    return;
+                }
+                detail::pnm_rows_in(pending.data(), *pnm, view(*image), rows_ready++, 1);
+                pending.clear();
+            }
+
+            auto rows = std::min(size / row_bytes, height - rows_ready);
+            detail::pnm_rows_in(data, *pnm, view(*image), rows_ready, rows);
+            rows_ready += rows;
+            if(rows_ready < height) {
+                pending.assign(data + rows * row_bytes, data + size);
+            }
+        }
+
+        DecodeOptions  options;
+        RowsCallback   on_rows;
+
+        Codec  codec = Codec::unknown;
+        std::vector<std::uint8_t>  pending;
+        std::optional<ImageCpu>    image;
+        std::size_t  rows_ready = 0;
+        bool         finished = false;
+
+        std::optional<detail::QoiDecoder>  qoi;
+        std::size_t  column = 0;    //Pixels of the QOI row in progress
+        std::optional<detail::PnmHeader>   pnm;
+    };
+
+    StreamDecoder::StreamDecoder(const DecodeOptions  &options, RowsCallback  on_rows)
+        :_state{std::make_unique<State>()}
+    {
+        _state->options = options;
+        _state->on_rows = std::move(on_rows);
+    }
+
+    StreamDecoder::StreamDecoder(StreamDecoder&&) noexcept = default;
+    StreamDecoder::~StreamDecoder() = default;
+    auto StreamDecoder::operator=(StreamDecoder&&) noexcept -> StreamDecoder& = default;
+
+    void StreamDecoder::push(gsl::span<const std::uint8_t>  data)
+    {
+        auto &state = *_state;
+        if(state.finished) {
+            throw std::runtime_error("Data pushed to a finished stream decoder");
+        }
+
+        auto first_row = state.rows_ready;
+        state.feed(data.data(), data.size_bytes());
+        if(state.on_rows && state.rows_ready > first_row) {
+            state.on_rows(view(*state.image), first_row, state.rows_ready);
+        }
+    }
+
+    void StreamDecoder::finish()
+    {
+        auto &state = *_state;
+        if(state.finished) {
+            return;
+        }
+
+        if(state.codec == Codec::unknown || state.codec == Codec::collected)
+        {
+            auto encoded = std::exchange(state.pending, {});
+            state.image.emplace(decode_image(gsl::span<std::uint8_t>(encoded.data(), encoded.size()), state.options));
+            state.rows_ready = state.image->meta_data().size.height;
+            if(state.on_rows) {
+                state.on_rows(view(*state.image), 0, state.rows_ready);
+            }
+        }
+        else if(!state.image || state.rows_ready < state.image->meta_data().size.height) {
+            throw std::runtime_error("Stream ended before the image was complete");
+        }
+
+        state.finished = true;
+        state.pending = {};
+    }
+
+    auto StreamDecoder::header_ready() const noexcept -> bool
+    {
+        return _state->image.has_value();
+    }
+
+    auto StreamDecoder::rows_ready() const noexcept -> std::size_t
+    {
+        return _state->rows_ready;
+    }
+
+    auto StreamDecoder::finished() const noexcept -> bool
+    {
+        return _state->finished;
+    }
+
+    auto StreamDecoder::image() noexcept -> ImageCpu*
+    {
+        return _state->image ? &*_state->image : nullptr;
+    }
+
+    auto StreamDecoder::image() const noexcept -> const ImageCpu*
+    {
+        return _state->image ? &*_state->image : nullptr;
+    }
+}
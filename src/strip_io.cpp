@@ -0,0 +1,661 @@
+#include "image/strip_io.hpp"
+#include "image/mapped_buffer.hpp"
+#include "image/utils.hpp"
+#include "codec_internal.hpp"
+#include <gsl/gsl>
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace nitros::utils::image
+{
+    namespace
+    {
+        constexpr auto read_chunk_bytes = std::size_t{65536};
+        constexpr auto pnm_header_bytes = std::size_t{65536};
+
+        using detail::copy_planes;
+
+        auto round_up(std::size_t  value, std::size_t  multiple) noexcept -> std::size_t
+        {
+            return (value + multiple - 1) / multiple * multiple;
+        }
+
+        auto sniff_strip_format(const std::string  &full_source_path) -> FileFormat
+        {
+            auto head = std::array<char, 8>{};
+            auto file = std::ifstream(full_source_path, std::ios::binary);
+            if(!file) {
+                throw std::runtime_error("Cannot open " + full_source_path);
+            }
+            file.read(head.data(), head.size());
+            auto size = gsl::narrow_cast<std::size_t>(file.gcount());
+
+            if(size == 8 && std::memcmp(head.data(), "NIMGRAW\0", 8) == 0) {
+                return FileFormat::raw;
+            }
+            if(size >= 4 && std::memcmp(head.data(), "qoif", 4) == 0) {
+                return FileFormat::qoi;
+            }
+            if(size >= 2 && head[0] == 'P' && (head[1] == '5' || head[1] == '6' || head[1] == '7')) {
+                return FileFormat::pnm;
+            }
+            if(size >= 2 && head[0] == 'B' && head[1] == 'M') {
+                return FileFormat::bmp;
+            }
+            return FileFormat::unknown;
+        }
+
+        //PNG integers are big endian, those of BMP and the deflate block headers little endian
+        void put_u32(std::vector<std::uint8_t>  &out, std::uint32_t  value)
+        {
+            out.insert(out.end(), {static_cast<std::uint8_t>(value >> 24), static_cast<std::uint8_t>(value >> 16),
+                                   static_cast<std::uint8_t>(value >> 8),  static_cast<std::uint8_t>(value)});
+        }
+
+        void put_u16_le(std::vector<std::uint8_t>  &out, std::uint16_t  value)
+        {
+            out.insert(out.end(), {static_cast<std::uint8_t>(value), static_cast<std::uint8_t>(value >> 8)});
+        }
+
+        void put_u32_le(std::vector<std::uint8_t>  &out, std::uint32_t  value)
+        {
+            put_u16_le(out, static_cast<std::uint16_t>(value));
+            put_u16_le(out, static_cast<std::uint16_t>(value >> 16));
+        }
+
+        constexpr auto make_crc_table() noexcept -> std::array<std::uint32_t, 256>
+        {
+            auto table = std::array<std::uint32_t, 256>{};
+            for(auto n = std::uint32_t{0}; n < 256; n++)
+            {
+                auto c = n;
+                for(auto k = 0; k < 8; k++) {
+                    c = c & 1 ? 0xedb88320u ^ (c >> 1) : c >> 1;
+                }
+                table[n] = c;
+            }
+            return table;
+        }
+
+        constexpr auto crc_table = make_crc_table();
+
+        auto crc32(std::uint32_t  crc, const std::uint8_t  *data, std::size_t  size) noexcept -> std::uint32_t
+        {
+            crc = ~crc;
+            for(auto i = std::size_t{0}; i < size; i++) {
+                crc = crc_table[(crc ^ data[i]) & 0xff] ^ (crc >> 8);
+            }
+            return ~crc;
+        }
+
+        auto adler32(std::uint32_t  adler, const std::uint8_t  *data, std::size_t  size) noexcept -> std::uint32_t
+        {
+            //5552 bytes is the longest run before the sums can overflow 32 bits
+            auto a = adler & 0xffff;
+            auto b = adler >> 16;
+            while(size > 0)
+            {
+                auto run = std::min<std::size_t>(size, 5552);
+                for(auto i = std::size_t{0}; i < run; i++) {
+                    a += data[i];
+                    b += a;
+                }
+                a %= 65521;
+                b %= 65521;
+                data += run;
+                size -= run;
+            }
+            return b << 16 | a;
+        }
+
+        auto get_u16_le(const std::uint8_t  *in) noexcept -> std::uint32_t
+        {
+            return std::uint32_t{in[0]} | std::uint32_t{in[1]} << 8;
+        }
+
+        auto get_u32_le(const std::uint8_t  *in) noexcept -> std::uint32_t
+        {
+            return get_u16_le(in) | get_u16_le(in + 2) << 16;
+        }
+
+        //File header, the largest info header (BITMAPV5HEADER) and a full palette
+        constexpr auto bmp_header_bytes = std::size_t{14 + 124 + 256 * 4};
+
+        struct BmpLayout
+        {
+            ImageMetaData  meta_data;
+            std::size_t    data_offset;
+            std::size_t    row_bytes;
+            bool           top_down;
+        };
+
+        /**
+         * Uncompressed BMP as StripWriter writes it: 8 bit with a grey palette, 24 bit BGR or 32 bit BGRA,
+         * rows padded to 4 bytes and stored top down or bottom up
+         * @throws std::invalid_argument for compressed, paletted color and other bit depths
+         * @throws std::runtime_error if the header is truncated or malformed
+         * */
+        auto parse_bmp_header(const std::uint8_t  *in, std::size_t  size) -> BmpLayout
+        {
+            if(size < 14 + 40) {
+                throw std::runtime_error("BMP header is truncated");
+            }
+            auto data_offset = std::size_t{get_u32_le(in + 10)};
+            auto info_bytes = std::size_t{get_u32_le(in + 14)};
+            auto width = static_cast<std::int32_t>(get_u32_le(in + 18));
+            auto height = static_cast<std::int32_t>(get_u32_le(in + 22));
+            auto bits = get_u16_le(in + 28);
+            auto compression = get_u32_le(in + 30);
+            if(info_bytes < 40 || data_offset < 14 + info_bytes || width <= 0 || height == 0 || height == std::numeric_limits<std::int32_t>::min()) {
+                throw std::runtime_error("BMP header is malformed");
+            }
+
+            //32 bit files may spell out the plain BGRA layout as bit fields right after the 40 byte header
+            auto plain_bit_fields = compression == 3 && bits == 32 && size >= 14 + 40 + 12
+                                 && get_u32_le(in + 54) == 0x00ff0000 && get_u32_le(in + 58) == 0x0000ff00 && get_u32_le(in + 62) == 0x000000ff;
+            if(compression != 0 && !plain_bit_fields) {
+                throw std::invalid_argument("Compressed BMP images cannot be read in strips");
+            }
+
+            auto format = [&]() {
+                switch(bits) {
+                    case 8:  return pixel::GREY8::value;
+                    case 24: return pixel::RGB8::value;
+                    case 32: return pixel::RGBA8::value;
+                    default: throw std::invalid_argument("BMP images of " + std::to_string(bits) + " bits cannot be read in strips");
+                }
+            }();
+            if(bits == 8)
+            {
+                auto colors = std::size_t{get_u32_le(in + 46)};
+                colors = colors == 0 ? 256 : colors;
+                auto palette = 14 + info_bytes;
+                if(colors > 256 || palette + colors * 4 > std::min(size, data_offset)) {
+                    throw std::runtime_error("BMP palette is truncated");
+                }
+                for(auto i = std::size_t{0}; i < colors; i++)
+                {
+                    const auto *entry = in + palette + i * 4;
+                    if(entry[0] != i || entry[1] != i || entry[2] != i) {
+                        throw std::invalid_argument("Only BMP images with a grey palette can be read in strips");
+                    }
+                }
+            }
+
+            auto meta_data = ImageMetaData{{gsl::narrow_cast<std::size_t>(width), gsl::narrow_cast<std::size_t>(std::abs(height))}, format};
+            return BmpLayout{meta_data, data_offset, round_up(meta_data.size.width * bits / 8, 4), height < 0};
+        }
+
+        //Formats are checked before the file is created
+        void check_strip_format(FileFormat  file_format, const pixel::Format  &format)
+        {
+            auto channels = format.pixel_layout.channels;
+            if(file_format == FileFormat::png && (format.planar_info.is_planar || format.pixel_layout.bytes != channels || channels > 4)) {
+                throw std::invalid_argument("PNG strips need 1 to 4 interleaved 8 bit channels");
+            }
+            if(file_format == FileFormat::bmp && !(format == pixel::GREY8::value) && !(format == pixel::RGB8::value) && !(format == pixel::RGBA8::value)) {
+                throw std::invalid_argument("BMP strips are GREY8, RGB8 or RGBA8");
+            }
+            if(file_format != FileFormat::png && file_format != FileFormat::bmp && file_format != FileFormat::raw) {
+                throw std::invalid_argument("Strips are written as png, bmp or raw");
+            }
+        }
+
+        constexpr auto png_signature = std::array<std::uint8_t, 8>{0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n'};
+        constexpr auto stored_block_bytes = std::size_t{65535};
+    } // namespace
+
+    struct StripReader::State
+    {
+        void read_pnm(const ImageView  &target, std::size_t  rows)
+        {
+            auto row_bytes = plane_row_bytes(meta_data, 0);
+            buffer.resize(rows * row_bytes);
+            file.read(reinterpret_cast<char*>(buffer.data()), gsl::narrow<std::streamsize>(buffer.size()));
+            if(gsl::narrow_cast<std::size_t>(file.gcount()) != buffer.size()) {
+                throw std::runtime_error("Netpbm image is truncated");
+            }
+            detail::pnm_rows_in(buffer.data(), *pnm, target, 0, rows);
+        }
+
+        //Bottom up files store the rows of a strip as one block in reverse order
+        void read_bmp(const ImageView  &target, std::size_t  rows)
+        {
+            auto first = bmp->top_down ? rows_read : meta_data.size.height - rows_read - rows;
+            buffer.resize(rows * bmp->row_bytes);
+            file.seekg(gsl::narrow<std::streamoff>(bmp->data_offset + first * bmp->row_bytes));
+            file.read(reinterpret_cast<char*>(buffer.data()), gsl::narrow<std::streamsize>(buffer.size()));
+            if(gsl::narrow_cast<std::size_t>(file.gcount()) != buffer.size()) {
+                throw std::runtime_error("BMP image is truncated");
+            }
+
+            auto width = meta_data.size.width;
+            auto channels = meta_data.format.pixel_layout.channels;
+            for(auto y = std::size_t{0}; y < rows; y++)
+            {
+                const auto *in = buffer.data() + (bmp->top_down ? y : rows - 1 - y) * bmp->row_bytes;
+                auto *out = target.row(y);
+                if(channels == 1) {
+                    std::memcpy(out, in, width);
+                    continue;
+                }
+                for(auto x = std::size_t{0}; x < width; x++, in += channels, out += channels)
+                {
+                    out[0] = in[2];
+                    out[1] = in[1];
+                    out[2] = in[0];
+                    if(channels == 4) {
+                        out[3] = in[3];
+                    }
+                }
+            }
+        }
+
+        void read_qoi(const ImageView  &target, std::size_t  rows)
+        {
+            auto width = meta_data.size.width;
+            auto channels = meta_data.format.pixel_layout.channels;
+            for(auto y = std::size_t{0}; y < rows; y++)
+            {
+                for(auto column = std::size_t{0}; column < width; )
+                {
+                    const auto *in = buffer.data() + buffer_pos;
+                    column += qoi->decode(in, buffer.data() + buffer_end, target.row(y) + column * channels, width - column);
+                    buffer_pos = gsl::narrow_cast<std::size_t>(in - buffer.data());
+                    if(column < width) {
+                        refill();
+                    }
+                }
+            }
+        }
+
+        //Keeps the cut op at the front and reads behind it
+        void refill()
+        {
+            std::memmove(buffer.data(), buffer.data() + buffer_pos, buffer_end - buffer_pos);
+            buffer_end -= buffer_pos;
+            buffer_pos = 0;
+            file.read(reinterpret_cast<char*>(buffer.data() + buffer_end), gsl::narrow<std::streamsize>(buffer.size() - buffer_end));
+            auto read = gsl::narrow_cast<std::size_t>(file.gcount());
+            if(read == 0) {
+                throw std::runtime_error("QOI data is truncated");
+            }
+            buffer_end += read;
+        }
+
+        FileFormat     file_format = FileFormat::unknown;
+        ImageMetaData  meta_data{{0, 0}, pixel::GREY8::value};     //Set from the file header
+        std::size_t    strip_rows = 0;
+        std::size_t    rows_read = 0;
+        std::optional<ImageCpu>  strip;
+
+        //Raw containers are mapped
+        std::optional<ImageMapped>  mapped;
+
+        std::ifstream  file;
+        std::vector<std::uint8_t>  buffer;
+        std::size_t    buffer_pos = 0;
+        std::size_t    buffer_end = 0;
+        std::optional<detail::PnmHeader>   pnm;
+        std::optional<detail::QoiDecoder>  qoi;
+        std::optional<BmpLayout>           bmp;
+    };
+
+    StripReader::StripReader(const std::string  &full_source_path, std::size_t  strip_rows)
+        :_state{std::make_unique<State>()}
+    {
+        if(strip_rows == 0) {
+            throw std::invalid_argument("Strips need at least one row");
+        }
+
+        auto &state = *_state;
+        state.file_format = sniff_strip_format(full_source_path);
+        switch(state.file_format)
+        {
+            case FileFormat::raw:
+                state.mapped.emplace(open_image_raw(full_source_path));
+                state.meta_data = state.mapped->meta_data();
+                break;
+            case FileFormat::pnm:
+            {
+                state.file.open(full_source_path, std::ios::binary);
+                state.buffer.resize(pnm_header_bytes);
+                state.file.read(reinterpret_cast<char*>(state.buffer.data()), gsl::narrow<std::streamsize>(state.buffer.size()));
+                state.buffer.resize(gsl::narrow_cast<std::size_t>(state.file.gcount()));
+                state.pnm = detail::parse_pnm_header(state.buffer);
+                if(!state.pnm) {
+                    throw std::runtime_error("Netpbm header is truncated");
+                }
+                state.meta_data = ImageMetaData{state.pnm->size, state.pnm->format};
+                state.file.clear();
+                state.file.seekg(gsl::narrow<std::streamoff>(state.pnm->data_offset));
+                break;
+            }
+            case FileFormat::qoi:
+            {
+                state.file.open(full_source_path, std::ios::binary);
+                state.buffer.resize(read_chunk_bytes);
+                state.file.read(reinterpret_cast<char*>(state.buffer.data()), gsl::narrow<std::streamsize>(detail::qoi_header_bytes));
+                if(gsl::narrow_cast<std::size_t>(state.file.gcount()) != detail::qoi_header_bytes) {
+                    throw std::runtime_error("Not a QOI image");
+                }
+                auto header = detail::parse_qoi_header(state.buffer.data());
+                state.meta_data = ImageMetaData{header.size, header.channels == 4 ? pixel::RGBA8::value : pixel::RGB8::value};
+                state.qoi.emplace(header.channels);
+                break;
+            }
+            case FileFormat::bmp:
+            {
+                state.file.open(full_source_path, std::ios::binary);
+                state.buffer.resize(bmp_header_bytes);
+                state.file.read(reinterpret_cast<char*>(state.buffer.data()), gsl::narrow<std::streamsize>(state.buffer.size()));
+                state.bmp = parse_bmp_header(state.buffer.data(), gsl::narrow_cast<std::size_t>(state.file.gcount()));
+                state.meta_data = state.bmp->meta_data;
+                state.file.clear();
+                break;
+            }
+            default:
+                throw std::invalid_argument("Only raw, binary Netpbm, QOI and uncompressed BMP images can be read in strips, " + full_source_path + " is none of them");
+        }
+
+        auto &size = state.meta_data.size;
+        state.strip_rows = std::min(round_up(strip_rows, roi_alignment(state.meta_data.format).height), size.height);
+        state.strip.emplace(create_cpu({size.width, state.strip_rows}, state.meta_data.format));
+    }
+
+    StripReader::StripReader(StripReader&&) noexcept = default;
+    StripReader::~StripReader() = default;
+    auto StripReader::operator=(StripReader&&) noexcept -> StripReader& = default;
+
+    auto StripReader::meta_data() const noexcept -> const ImageMetaData&
+    {
+        return _state->meta_data;
+    }
+
+    auto StripReader::file_format() const noexcept -> FileFormat
+    {
+        return _state->file_format;
+    }
+
+    auto StripReader::strip_rows() const noexcept -> std::size_t
+    {
+        return _state->strip_rows;
+    }
+
+    auto StripReader::rows_read() const noexcept -> std::size_t
+    {
+        return _state->rows_read;
+    }
+
+    auto StripReader::next() -> std::optional<ImageView>
+    {
+        auto &state = *_state;
+        auto &size = state.meta_data.size;
+        if(state.rows_read == size.height) {
+            return std::nullopt;
+        }
+
+        auto rows = std::min(state.strip_rows, size.height - state.rows_read);
+        auto target = roi(view(*state.strip), 0, 0, {size.width, rows});
+        if(state.mapped) {
+            copy_planes(roi(view(std::as_const(*state.mapped)), 0, state.rows_read, {size.width, rows}), target);
+        }
+        else if(state.pnm) {
+            state.read_pnm(target, rows);
+        }
+        else if(state.bmp) {
+            state.read_bmp(target, rows);
+        }
+        else {
+            state.read_qoi(target, rows);
+        }
+
+        state.rows_read += rows;
+        return target;
+    }
+
+    struct StripWriter::State
+    {
+        State(const std::string  &path_, ImgSize  size, const pixel::Format  &format, FileFormat  file_format_)
+            :path{path_}
+            ,file_format{file_format_}
+            ,meta_data{size, format}
+        {}
+
+        void start_png()
+        {
+            auto channels = meta_data.format.pixel_layout.channels;
+            constexpr auto color_types = std::array<std::uint8_t, 4>{0, 4, 2, 6};
+            auto header = std::vector<std::uint8_t>{};
+            put_u32(header, gsl::narrow<std::uint32_t>(meta_data.size.width));
+            put_u32(header, gsl::narrow<std::uint32_t>(meta_data.size.height));
+            header.insert(header.end(), {8, color_types[channels - 1], 0, 0, 0});
+
+            write(png_signature.data(), png_signature.size());
+            png_chunk("IHDR", header);
+        }
+
+        void png_chunk(const char  *type, const std::vector<std::uint8_t>  &data)
+        {
+            auto prefix = std::vector<std::uint8_t>{};
+            put_u32(prefix, gsl::narrow<std::uint32_t>(data.size()));
+            prefix.insert(prefix.end(), type, type + 4);
+
+            auto crc = crc32(0, prefix.data() + 4, 4);
+            crc = crc32(crc, data.data(), data.size());
+            auto suffix = std::vector<std::uint8_t>{};
+            put_u32(suffix, crc);
+
+            write(prefix.data(), prefix.size());
+            write(data.data(), data.size());
+            write(suffix.data(), suffix.size());
+        }
+
+        //One IDAT per strip, the zlib stream of stored blocks runs across all of them
+        void write_png(const ConstImageView  &strip)
+        {
+            auto row_bytes = plane_row_bytes(meta_data, 0);
+            auto rows = strip.size().height;
+            scanlines.resize(rows * (row_bytes + 1));
+            for(auto y = std::size_t{0}; y < rows; y++)
+            {
+                auto *line = scanlines.data() + y * (row_bytes + 1);
+                line[0] = 0;    //No filter, it would only help a compressor
+                std::memcpy(line + 1, strip.row(y), row_bytes);
+            }
+            adler = adler32(adler, scanlines.data(), scanlines.size());
+
+            auto last = rows_written + rows == meta_data.size.height;
+            chunk.clear();
+            if(rows_written == 0) {
+                chunk.insert(chunk.end(), {0x78, 0x01});
+            }
+            for(auto offset = std::size_t{0}; offset < scanlines.size(); offset += stored_block_bytes)
+            {
+                auto length = std::min(stored_block_bytes, scanlines.size() - offset);
+                chunk.push_back(last && offset + length == scanlines.size() ? 1 : 0);
+                put_u16_le(chunk, static_cast<std::uint16_t>(length));
+                put_u16_le(chunk, static_cast<std::uint16_t>(~length));
+                chunk.insert(chunk.end(), scanlines.data() + offset, scanlines.data() + offset + length);
+            }
+            if(last) {
+                put_u32(chunk, adler);
+            }
+            png_chunk("IDAT", chunk);
+        }
+
+        void start_bmp()
+        {
+            auto channels = meta_data.format.pixel_layout.channels;
+            auto palette_bytes = channels == 1 ? std::size_t{256 * 4} : 0;
+            auto data_offset = 14 + 40 + palette_bytes;
+            bmp_row_bytes = round_up(meta_data.size.width * channels, 4);
+
+            auto header = std::vector<std::uint8_t>{'B', 'M'};
+            put_u32_le(header, gsl::narrow<std::uint32_t>(data_offset + bmp_row_bytes * meta_data.size.height));
+            put_u32_le(header, 0);
+            put_u32_le(header, gsl::narrow<std::uint32_t>(data_offset));
+
+            //Negative height stores the rows top down, in the order strips arrive
+            put_u32_le(header, 40);
+            put_u32_le(header, gsl::narrow<std::uint32_t>(meta_data.size.width));
+            put_u32_le(header, static_cast<std::uint32_t>(-gsl::narrow<std::int32_t>(meta_data.size.height)));
+            put_u16_le(header, 1);
+            put_u16_le(header, static_cast<std::uint16_t>(channels * 8));
+            put_u32_le(header, 0);      //BI_RGB
+            put_u32_le(header, gsl::narrow<std::uint32_t>(bmp_row_bytes * meta_data.size.height));
+            put_u32_le(header, 2835);   //72 dpi
+            put_u32_le(header, 2835);
+            put_u32_le(header, channels == 1 ? 256 : 0);
+            put_u32_le(header, 0);
+            for(auto i = std::size_t{0}; i < palette_bytes / 4; i++) {
+                header.insert(header.end(), {static_cast<std::uint8_t>(i), static_cast<std::uint8_t>(i), static_cast<std::uint8_t>(i), 0});
+            }
+            write(header.data(), header.size());
+        }
+
+        void write_bmp(const ConstImageView  &strip)
+        {
+            auto channels = meta_data.format.pixel_layout.channels;
+            auto width = meta_data.size.width;
+            chunk.assign(bmp_row_bytes, 0);
+            for(auto y = std::size_t{0}; y < strip.size().height; y++)
+            {
+                const auto *in = strip.row(y);
+                if(channels == 1) {
+                    std::memcpy(chunk.data(), in, width);
+                }
+                else {
+                    for(auto x = std::size_t{0}; x < width; x++, in += channels)
+                    {
+                        auto *out = chunk.data() + x * channels;
+                        out[0] = in[2];
+                        out[1] = in[1];
+                        out[2] = in[0];
+                        if(channels == 4) {
+                            out[3] = in[3];
+                        }
+                    }
+                }
+                write(chunk.data(), chunk.size());
+            }
+        }
+
+        void start_raw(const std::string  &full_target_path)
+        {
+            {
+                auto header = MappedBuffer::create(full_target_path, detail::raw_data_offset + buffer_size(meta_data));
+                detail::write_raw_header(header.data(), meta_data);
+            }
+            mapped.emplace(open_mapped(full_target_path, meta_data, MapMode::read_write, detail::raw_data_offset));
+        }
+
+        void write(const std::uint8_t  *data, std::size_t  size)
+        {
+            file.write(reinterpret_cast<const char*>(data), gsl::narrow_cast<std::streamsize>(size));
+            if(!file) {
+                throw std::runtime_error("Cannot write " + path);
+            }
+        }
+
+        std::string    path;
+        FileFormat     file_format;
+        ImageMetaData  meta_data;
+        std::size_t    rows_written = 0;
+        bool           finished = false;
+
+        std::ofstream  file;
+        std::vector<std::uint8_t>  scanlines;
+        std::vector<std::uint8_t>  chunk;
+        std::uint32_t  adler = 1;
+        std::size_t    bmp_row_bytes = 0;
+        std::optional<ImageMapped>  mapped;
+    };
+
+    StripWriter::StripWriter(const std::string  &full_target_path, ImgSize  size, const pixel::Format  &format, FileFormat  file_format)
+        :_state{std::make_unique<State>(full_target_path, size, format, file_format)}
+    {
+        auto &state = *_state;
+        if(size.width == 0 || size.height == 0) {
+            throw std::invalid_argument("Strip written images cannot be empty");
+        }
+        check_strip_format(file_format, format);
+        if(file_format == FileFormat::raw) {
+            state.start_raw(full_target_path);
+            return;
+        }
+
+        state.file.open(full_target_path, std::ios::binary);
+        if(!state.file) {
+            throw std::runtime_error("Cannot open " + full_target_path);
+        }
+        file_format == FileFormat::png ? state.start_png() : state.start_bmp();
+    }
+
+    StripWriter::StripWriter(StripWriter&&) noexcept = default;
+    StripWriter::~StripWriter() = default;
+    auto StripWriter::operator=(StripWriter&&) noexcept -> StripWriter& = default;
+
+    auto StripWriter::rows_written() const noexcept -> std::size_t
+    {
+        return _state->rows_written;
+    }
+
+    void StripWriter::write(const ConstImageView  &strip)
+    {
+        auto &state = *_state;
+        auto &size = state.meta_data.size;
+        if(strip.size().width != size.width || !(strip.meta_data().format == state.meta_data.format)) {
+            throw std::invalid_argument("Strip does not match the width and format of the image");
+        }
+        if(state.finished || strip.size().height > size.height - state.rows_written) {
+            throw std::invalid_argument("Strip runs past the height of the image");
+        }
+        if(strip.size().height == 0) {
+            return;
+        }
+
+        switch(state.file_format) {
+            case FileFormat::png: state.write_png(strip); break;
+            case FileFormat::bmp: state.write_bmp(strip); break;
+            default:
+                copy_planes(strip, roi(view(*state.mapped), 0, state.rows_written, strip.size()));
+                break;
+        }
+        state.rows_written += strip.size().height;
+    }
+
+    void StripWriter::finish()
+    {
+        auto &state = *_state;
+        if(state.finished) {
+            return;
+        }
+        if(state.rows_written != state.meta_data.size.height) {
+            throw std::runtime_error("Strip writer finished before the last row");
+        }
+
+        if(state.mapped) {
+            state.mapped->buffer().flush();
+        }
+        else
+        {
+            if(state.file_format == FileFormat::png) {
+                state.png_chunk("IEND", {});
+            }
+            state.file.flush();
+            if(!state.file) {
+                throw std::runtime_error("Cannot write " + state.path);
+            }
+        }
+        state.finished = true;
+    }
+}
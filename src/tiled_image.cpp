@@ -0,0 +1,400 @@
+#include "image/tiled_image.hpp"
+#include "image/utils.hpp"
+#include "codec_internal.hpp"
+#include <gsl/gsl>
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <list>
+#include <mutex>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace nitros::utils::image
+{
+    namespace
+    {
+        /**
+         * Layout of the tile file, integers little endian:
+         *  magic "NIMGTILE", u32 version, u32 reserved, u64 width, u64 height, u64 tile slot bytes
+         *  at tile_meta_offset the raw container header of one tile (tile size, format and steps)
+         * Tiles follow at tile_data_offset row by row, each in a page aligned slot in the create_cpu buffer layout
+         * */
+        constexpr auto tile_magic       = std::array<char, 8>{'N', 'I', 'M', 'G', 'T', 'I', 'L', 'E'};
+        constexpr auto tile_version     = std::uint32_t{1};
+        constexpr auto tile_meta_offset = std::size_t{512};
+        constexpr auto tile_data_offset = std::size_t{4096};
+        constexpr auto tile_slot_align  = std::size_t{4096};
+
+        void put_u64(std::uint8_t  *out, std::uint64_t  value) noexcept
+        {
+            for(auto i = 0; i < 8; i++) {
+                out[i] = static_cast<std::uint8_t>(value >> (8 * i));
+            }
+        }
+
+        auto get_u64(const std::uint8_t  *in) noexcept -> std::uint64_t
+        {
+            auto value = std::uint64_t{0};
+            for(auto i = 0; i < 8; i++) {
+                value |= std::uint64_t{in[i]} << (8 * i);
+            }
+            return value;
+        }
+
+        auto round_up(std::size_t  value, std::size_t  multiple) noexcept -> std::size_t
+        {
+            return (value + multiple - 1) / multiple * multiple;
+        }
+
+        struct Tile
+        {
+            std::shared_ptr<ImageCpu>  image;
+            std::list<std::size_t>::iterator  lru;
+            bool  dirty;
+        };
+    } // namespace
+
+    struct TiledImage::State
+    {
+        State(const std::string  &path_, ImgSize  size, ImageMetaData  tile_meta_, std::size_t  cache_bytes_)
+            :path{path_}
+            ,meta_data{size, tile_meta_.format}
+            ,tile_meta{std::move(tile_meta_)}
+            ,grid{(size.width + tile_meta.size.width - 1) / tile_meta.size.width, (size.height + tile_meta.size.height - 1) / tile_meta.size.height}
+            ,tile_bytes{buffer_size(tile_meta)}
+            ,slot_bytes{round_up(tile_bytes, tile_slot_align)}
+            ,cache_bytes{cache_bytes_}
+        {}
+
+        auto slot_offset(std::size_t  index) const noexcept -> std::streamoff
+        {
+            return gsl::narrow_cast<std::streamoff>(tile_data_offset + index * slot_bytes);
+        }
+
+        /**
+         * The resident tile at index, loaded unless fill is false (the caller overwrites all of it).
+         * Marks it most recently used and evicts others past the budget
+         * */
+        auto fetch(std::size_t  index, bool  fill) -> Tile&
+        {
+            if(auto it = tiles.find(index); it != tiles.end()) {
+                hits++;
+                lru.splice(lru.begin(), lru, it->second.lru);
+                return it->second;
+            }
+
+            misses++;
+            auto image = std::make_shared<ImageCpu>(tile_meta, ImgBufferCpu(tile_bytes));
+            if(fill)
+            {
+                //A failed operation before must not fail every later one
+                file.clear();
+                file.seekg(slot_offset(index));
+                file.read(reinterpret_cast<char*>(image->buffer().data()), gsl::narrow<std::streamsize>(tile_bytes));
+                if(!file) {
+                    throw std::runtime_error("Cannot read tile from " + path);
+                }
+            }
+
+            lru.push_front(index);
+            auto &tile = tiles.emplace(index, Tile{std::move(image), lru.begin(), false}).first->second;
+            resident_bytes += tile_bytes;
+            evict(cache_bytes);
+            return tile;
+        }
+
+        /**
+         * Gives tile an image no handle from tile() shares before it is modified, so handles stay immutable snapshots.
+         * keep copies the pixels, a tile about to be overwritten completely gets a fresh buffer
+         * */
+        void unshare(Tile  &tile, bool  keep)
+        {
+            if(tile.image.use_count() == 1) {
+                return;
+            }
+            auto image = std::make_shared<ImageCpu>(tile_meta, ImgBufferCpu(tile_bytes));
+            if(keep) {
+                std::memcpy(image->buffer().data(), tile.image->buffer().data(), tile_bytes);
+            }
+            tile.image = std::move(image);
+        }
+
+        void store(std::size_t  index, Tile  &tile)
+        {
+            file.clear();
+            file.seekp(slot_offset(index));
+            file.write(reinterpret_cast<const char*>(tile.image->buffer().data()), gsl::narrow<std::streamsize>(tile_bytes));
+            if(!file) {
+                throw std::runtime_error("Cannot write tile to " + path);
+            }
+            tile.dirty = false;
+            write_backs++;
+        }
+
+        //The most recently used tile always stays, it is the one being worked on
+        void evict(std::size_t  budget)
+        {
+            while(resident_bytes > budget && lru.size() > 1)
+            {
+                auto index = lru.back();
+                auto it = tiles.find(index);
+                if(it->second.dirty) {
+                    store(index, it->second);
+                }
+                tiles.erase(it);
+                lru.pop_back();
+                resident_bytes -= tile_bytes;
+                evictions++;
+            }
+        }
+
+        void flush()
+        {
+            for(auto &[index, tile] : tiles) {
+                if(tile.dirty) {
+                    store(index, tile);
+                }
+            }
+            file.clear();
+            file.flush();
+            if(!file) {
+                throw std::runtime_error("Cannot write tiles to " + path);
+            }
+        }
+
+        void check_rectangle(std::size_t  x, std::size_t  y, const ImageMetaData  &rectangle) const
+        {
+            if(!(rectangle.format == meta_data.format)) {
+                throw std::invalid_argument("Rectangle format differs from the tiled image");
+            }
+            auto &size = meta_data.size;
+            if(x > size.width || y > size.height || rectangle.size.width > size.width - x || rectangle.size.height > size.height - y) {
+                throw std::invalid_argument("Rectangle outside of the tiled image");
+            }
+            auto alignment = roi_alignment(meta_data.format);
+            if(x % alignment.width != 0 || y % alignment.height != 0) {
+                throw std::invalid_argument("Rectangle origin not aligned to the Plane subsampling");
+            }
+        }
+
+        //Calls fn(tile index, x and y in the tile, x and y in the rectangle, size) for every tile the rectangle covers
+        template <typename fn_>
+        void for_each_tile(std::size_t  x, std::size_t  y, ImgSize  size, fn_  &&fn)
+        {
+            auto &tile_size = tile_meta.size;
+            for(auto row = y / tile_size.height; row * tile_size.height < y + size.height; row++)
+            {
+                auto top = std::max(y, row * tile_size.height);
+                auto bottom = std::min(y + size.height, (row + 1) * tile_size.height);
+                for(auto column = x / tile_size.width; column * tile_size.width < x + size.width; column++)
+                {
+                    auto left = std::max(x, column * tile_size.width);
+                    auto right = std::min(x + size.width, (column + 1) * tile_size.width);
+                    fn(row * grid.width + column,
+                       left - column * tile_size.width, top - row * tile_size.height,
+                       left - x, top - y, ImgSize{right - left, bottom - top});
+                }
+            }
+        }
+
+        std::string    path;
+        ImageMetaData  meta_data;
+        ImageMetaData  tile_meta;
+        ImgSize        grid;
+        std::size_t    tile_bytes;
+        std::size_t    slot_bytes;
+        std::size_t    cache_bytes;
+        std::fstream   file;
+
+        mutable std::mutex  mutex;
+        std::list<std::size_t>  lru;    //Tile indices, most recently used first
+        std::unordered_map<std::size_t, Tile>  tiles;
+        std::size_t  resident_bytes = 0;
+        std::size_t  hits = 0;
+        std::size_t  misses = 0;
+        std::size_t  evictions = 0;
+        std::size_t  write_backs = 0;
+    };
+
+    TiledImage::TiledImage(std::unique_ptr<State>  state) noexcept
+        :_state{std::move(state)}
+    {}
+
+    TiledImage::TiledImage(TiledImage&&) noexcept = default;
+
+    auto TiledImage::operator=(TiledImage&&  other) noexcept -> TiledImage&
+    {
+        if(this != &other) {
+            //The image replaced writes its modified tiles back as on destruction
+            auto replaced = TiledImage{std::move(_state)};
+            _state = std::move(other._state);
+        }
+        return *this;
+    }
+
+    TiledImage::~TiledImage()
+    {
+        if(_state) {
+            try {
+                _state->flush();
+            }
+            catch(...) {
+            }
+        }
+    }
+
+    auto TiledImage::create(const std::string  &path, ImgSize  size, const pixel::Format  &format, ImgSize  tile_size, std::size_t  cache_bytes) -> TiledImage
+    {
+        if(size.width == 0 || size.height == 0 || tile_size.width == 0 || tile_size.height == 0) {
+            throw std::invalid_argument("Tiled images and their tiles cannot be empty");
+        }
+        auto alignment = roi_alignment(format);
+        tile_size = {round_up(tile_size.width, alignment.width), round_up(tile_size.height, alignment.height)};
+
+        auto state = std::make_unique<State>(path, size, ImageMetaData{tile_size, format}, cache_bytes);
+        auto header = std::vector<std::uint8_t>(tile_data_offset, 0);
+        std::memcpy(header.data(), tile_magic.data(), tile_magic.size());
+        header[8] = static_cast<std::uint8_t>(tile_version);
+        put_u64(header.data() + 16, size.width);
+        put_u64(header.data() + 24, size.height);
+        put_u64(header.data() + 32, state->slot_bytes);
+        detail::write_raw_header(header.data() + tile_meta_offset, state->tile_meta);
+
+        {
+            auto out = std::ofstream(path, std::ios::binary | std::ios::trunc);
+            out.write(reinterpret_cast<const char*>(header.data()), gsl::narrow<std::streamsize>(header.size()));
+            if(!out) {
+                throw std::runtime_error("Cannot create " + path);
+            }
+        }
+        std::filesystem::resize_file(path, tile_data_offset + state->grid.width * state->grid.height * state->slot_bytes);
+
+        state->file.open(path, std::ios::binary | std::ios::in | std::ios::out);
+        if(!state->file) {
+            throw std::runtime_error("Cannot open " + path);
+        }
+        return TiledImage{std::move(state)};
+    }
+
+    auto TiledImage::open(const std::string  &path, std::size_t  cache_bytes) -> TiledImage
+    {
+        auto file = std::fstream(path, std::ios::binary | std::ios::in | std::ios::out);
+        if(!file) {
+            throw std::runtime_error("Cannot open " + path);
+        }
+        auto header = std::vector<std::uint8_t>(tile_data_offset, 0);
+        file.read(reinterpret_cast<char*>(header.data()), gsl::narrow<std::streamsize>(header.size()));
+        if(!file || std::memcmp(header.data(), tile_magic.data(), tile_magic.size()) != 0) {
+            throw std::runtime_error("Not a tiled image: " + path);
+        }
+        if(header[8] != tile_version) {
+            throw std::runtime_error("Unsupported tiled image version: " + path);
+        }
+
+        auto size = ImgSize{gsl::narrow<std::size_t>(get_u64(header.data() + 16)), gsl::narrow<std::size_t>(get_u64(header.data() + 24))};
+        auto tile_meta = detail::read_raw_header(header.data() + tile_meta_offset).meta_data;
+        if(size.width == 0 || size.height == 0 || tile_meta.size.width == 0 || tile_meta.size.height == 0) {
+            throw std::runtime_error("Damaged tiled image header: " + path);
+        }
+
+        auto state = std::make_unique<State>(path, size, std::move(tile_meta), cache_bytes);
+        auto tiles = state->grid.width * state->grid.height;
+        if(get_u64(header.data() + 32) != state->slot_bytes || std::filesystem::file_size(path) < tile_data_offset + tiles * state->slot_bytes) {
+            throw std::runtime_error("Damaged or truncated tiled image: " + path);
+        }
+        state->file = std::move(file);
+        return TiledImage{std::move(state)};
+    }
+
+    auto TiledImage::meta_data() const noexcept -> const ImageMetaData&
+    {
+        return _state->meta_data;
+    }
+
+    auto TiledImage::tile_size() const noexcept -> ImgSize
+    {
+        return _state->tile_meta.size;
+    }
+
+    auto TiledImage::tile_grid() const noexcept -> ImgSize
+    {
+        return _state->grid;
+    }
+
+    auto TiledImage::tile(std::size_t  column, std::size_t  row) -> std::shared_ptr<const ImageCpu>
+    {
+        auto &state = *_state;
+        if(column >= state.grid.width || row >= state.grid.height) {
+            throw std::invalid_argument("Tile outside of the grid");
+        }
+        auto lock = std::lock_guard{state.mutex};
+        return state.fetch(row * state.grid.width + column, true).image;
+    }
+
+    void TiledImage::read(std::size_t  x, std::size_t  y, const ImageView  &target)
+    {
+        auto &state = *_state;
+        state.check_rectangle(x, y, target.meta_data());
+
+        auto lock = std::lock_guard{state.mutex};
+        state.for_each_tile(x, y, target.size(), [&](std::size_t  index, std::size_t  tile_x, std::size_t  tile_y,
+                                                     std::size_t  target_x, std::size_t  target_y, ImgSize  size) {
+            auto &tile = state.fetch(index, true);
+            detail::copy_planes(roi(view(std::as_const(*tile.image)), tile_x, tile_y, size), roi(target, target_x, target_y, size));
+        });
+    }
+
+    auto TiledImage::region(std::size_t  x, std::size_t  y, ImgSize  size) -> ImageCpu
+    {
+        auto image = create_cpu(size, _state->meta_data.format);
+        read(x, y, view(image));
+        return image;
+    }
+
+    void TiledImage::write(std::size_t  x, std::size_t  y, const ConstImageView  &source)
+    {
+        auto &state = *_state;
+        state.check_rectangle(x, y, source.meta_data());
+
+        auto lock = std::lock_guard{state.mutex};
+        state.for_each_tile(x, y, source.size(), [&](std::size_t  index, std::size_t  tile_x, std::size_t  tile_y,
+                                                     std::size_t  source_x, std::size_t  source_y, ImgSize  size) {
+            auto whole_tile = size == state.tile_meta.size;
+            auto &tile = state.fetch(index, !whole_tile);
+            state.unshare(tile, !whole_tile);
+            detail::copy_planes(roi(source, source_x, source_y, size), roi(view(*tile.image), tile_x, tile_y, size));
+            tile.dirty = true;
+        });
+    }
+
+    void TiledImage::flush()
+    {
+        auto lock = std::lock_guard{_state->mutex};
+        _state->flush();
+    }
+
+    auto TiledImage::stats() const -> TileCacheStats
+    {
+        auto &state = *_state;
+        auto lock = std::lock_guard{state.mutex};
+        return TileCacheStats{state.hits, state.misses, state.evictions, state.write_backs, state.tiles.size(), state.resident_bytes};
+    }
+
+    auto TiledImage::cache_bytes() const -> std::size_t
+    {
+        auto lock = std::lock_guard{_state->mutex};
+        return _state->cache_bytes;
+    }
+
+    void TiledImage::set_cache_bytes(std::size_t  bytes)
+    {
+        auto lock = std::lock_guard{_state->mutex};
+        _state->cache_bytes = bytes;
+        _state->evict(bytes);
+    }
+}